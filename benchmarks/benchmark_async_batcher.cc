@@ -0,0 +1,112 @@
+#include "api_status.h"
+#include "benchmarks_common.h"
+#include "err_constants.h"
+#include "logger/async_batcher.h"
+#include "ranking_event.h"
+#include "ranking_response.h"
+#include "serialization/fb_serializer.h"
+#include "utility/config_helper.h"
+#include "utility/watchdog.h"
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace r = reinforcement_learning;
+namespace l = reinforcement_learning::logger;
+namespace u = reinforcement_learning::utility;
+namespace err = reinforcement_learning::error_code;
+
+namespace
+{
+class null_message_sender : public l::i_message_sender
+{
+public:
+  int send(const uint16_t msg_type, const buffer& db, r::api_status* status) override { return err::success; }
+  int init(r::api_status* status) override { return err::success; }
+};
+
+std::vector<r::ranking_event> make_events(size_t count, const std::string& context, const r::ranking_response& resp)
+{
+  std::vector<r::ranking_event> events;
+  events.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    const auto event_id = std::to_string(i);
+    events.emplace_back(r::ranking_event::choose_rank(event_id.c_str(), context, 0, resp, r::timestamp{}));
+  }
+  return events;
+}
+}  // namespace
+
+// Measures the logging hand-off from the caller thread into the batcher queue.
+// allocs_per_event only counts allocations on the caller thread, the event content itself is built beforehand.
+template <class... ExtraArgs>
+static void bench_batcher_append(benchmark::State& state, ExtraArgs&&... extra_args)
+{
+  int res[sizeof...(extra_args)] = {extra_args...};
+  const auto queue_implementation = static_cast<r::queue_implementation_enum>(res[0]);
+  const bool by_value = res[1] != 0;
+  const size_t count = 1000;
+
+  cb_decision_gen cb_gen(20, 10, 50, 2000, 0, false);
+  const auto context = cb_gen.gen_example();
+  r::ranking_response resp("event_id");
+  for (size_t i = 0; i < 50; ++i) { resp.push_back(i, 1.f / 50); }
+  resp.set_model_id("model_id");
+
+  u::watchdog watchdog(nullptr);
+  u::async_batcher_config config;
+  config.send_batch_interval_ms = 10;
+  config.queue_mode = r::queue_mode_enum::BLOCK;
+  config.queue_implementation = queue_implementation;
+  int shared_state = 0;
+  l::async_batcher<r::ranking_event, l::fb_collection_serializer> batcher(
+      new null_message_sender(), watchdog, shared_state, nullptr, config);
+  batcher.init(nullptr);
+
+  size_t allocations = 0;
+  size_t events_logged = 0;
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+    auto events = make_events(count, context, resp);
+    state.ResumeTiming();
+
+    const auto before = thread_allocation_count();
+    for (auto& evt : events)
+    {
+      if (by_value) { batcher.append(std::move(evt)); }
+      else
+      {
+        // the hand-off used by the loggers before events could be stored by value
+        auto evt_sp = std::make_shared<r::ranking_event>(std::move(evt));
+        auto evt_fn = [evt_sp](r::ranking_event& out_evt, r::api_status*) -> int {
+          out_evt = std::move(*evt_sp);
+          return err::success;
+        };
+        batcher.append(std::move(evt_fn), evt_sp.get());
+      }
+    }
+    allocations += thread_allocation_count() - before;
+    events_logged += count;
+
+    state.PauseTiming();
+    events.clear();
+    state.ResumeTiming();
+  }
+
+  state.counters["allocs_per_event"] = static_cast<double>(allocations) / static_cast<double>(events_logged);
+  state.SetItemsProcessed(static_cast<int64_t>(events_logged));
+}
+
+// queue implementation
+// events stored by value (on/off)
+BENCHMARK_CAPTURE(bench_batcher_append, list_function, static_cast<int>(r::queue_implementation_enum::LIST), 0);
+BENCHMARK_CAPTURE(bench_batcher_append, list_value, static_cast<int>(r::queue_implementation_enum::LIST), 1);
+BENCHMARK_CAPTURE(
+    bench_batcher_append, ring_buffer_function, static_cast<int>(r::queue_implementation_enum::RING_BUFFER), 0);
+BENCHMARK_CAPTURE(
+    bench_batcher_append, ring_buffer_value, static_cast<int>(r::queue_implementation_enum::RING_BUFFER), 1);
@@ -12,6 +12,9 @@
 
 #include <algorithm>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
 
 namespace r = reinforcement_learning;
 namespace u = reinforcement_learning::utility;
@@ -67,8 +70,11 @@ static void bench_cb(benchmark::State& state, ExtraArgs&&... extra_args)
 
   r::ranking_response response;
 
+  size_t allocations = 0;
+  size_t decisions = 0;
   for (auto _ : state)
   {
+    const auto before = thread_allocation_count();
     for (size_t i = 0; i < count; i++)
     {
       if (model.choose_rank(event_id, examples[i].c_str(), response, &status) != err::success)
@@ -78,8 +84,13 @@ static void bench_cb(benchmark::State& state, ExtraArgs&&... extra_args)
                   << status.get_error_msg() << std::endl;
       }
     }
+    allocations += thread_allocation_count() - before;
+    decisions += count;
     benchmark::ClobberMemory();
   }
+
+  // heap allocations made by the calling thread, the batcher thread is not counted
+  state.counters["allocs_per_decision"] = static_cast<double>(allocations) / static_cast<double>(decisions);
 }
 
 // characteristics of the benchmark examples that will be generated are:
@@ -94,4 +105,97 @@ static void bench_cb(benchmark::State& state, ExtraArgs&&... extra_args)
 BENCHMARK_CAPTURE(bench_cb, non_dedupable_payload, 20, 10, 50, 2000, 500, false, false);
 BENCHMARK_CAPTURE(bench_cb, non_dedupable_payload_compression, 20, 10, 50, 2000, 500, true, false);
 BENCHMARK_CAPTURE(bench_cb, non_dedupable_payload_dedup, 20, 10, 50, 2000, 500, false, true);
-BENCHMARK_CAPTURE(bench_cb, non_dedupable_payload_compression_dedup, 20, 10, 50, 2000, 500, true, true);
\ No newline at end of file
+BENCHMARK_CAPTURE(bench_cb, non_dedupable_payload_compression_dedup, 20, 10, 50, 2000, 500, true, true);
+
+namespace
+{
+// one live model per transform mode, shared by all the benchmark threads
+r::live_model& shared_live_model(const char* transform_mode)
+{
+  static std::mutex mutex;
+  static std::map<std::string, std::unique_ptr<r::live_model>> models;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto& model = models[transform_mode];
+  if (model == nullptr)
+  {
+    u::configuration config;
+    cfg::create_from_json(JSON_CFG, config);
+    config.set(r::name::PROTOCOL_VERSION, "2");
+    config.set(r::name::EH_TEST, "true");
+    config.set(r::name::MODEL_SRC, r::value::NO_MODEL_DATA);
+    config.set(r::name::OBSERVATION_SENDER_IMPLEMENTATION, r::value::OBSERVATION_FILE_SENDER);
+    config.set(r::name::INTERACTION_SENDER_IMPLEMENTATION, r::value::INTERACTION_FILE_SENDER);
+    config.set(r::name::INTERACTION_FILE_NAME, "/dev/null");
+    config.set(r::name::OBSERVATION_FILE_NAME, "/dev/null");
+    config.set(r::name::MODEL_BACKGROUND_REFRESH, "false");
+    config.set(r::name::VW_POOL_INIT_SIZE, "1");
+    config.set(r::name::INTERACTION_USE_COMPRESSION, "true");
+    config.set(r::name::INTERACTION_USE_DEDUP, "true");
+    config.set(r::name::INTERACTION_TRANSFORM_MODE, transform_mode);
+    config.set("queue.mode", "BLOCK");
+
+    r::api_status status;
+    model.reset(new r::live_model(config));
+    if (model->init(&status) != err::success) { std::cout << status.get_error_msg() << std::endl; }
+  }
+  return *model;
+}
+}  // namespace
+
+// Measures the events logged per second when all the threads share one model.
+// The transform mode selects the thread that runs the dedup extraction, the serialization and the compression.
+template <class... ExtraArgs>
+static void bench_cb_threads(benchmark::State& state, const char* transform_mode, ExtraArgs&&... extra_args)
+{
+  int res[sizeof...(extra_args)] = {extra_args...};
+  auto shared_features = res[0];
+  auto action_features = res[1];
+  auto actions_per_decision = res[2];
+  auto total_actions = res[3];
+  auto count = res[4];
+
+  cb_decision_gen cb_gen(shared_features, action_features, actions_per_decision, total_actions, 0, false);
+
+  std::vector<std::string> examples;
+  std::generate_n(std::back_inserter(examples), count, [&cb_gen] { return cb_gen.gen_example(); });
+
+  auto& model = shared_live_model(transform_mode);
+  r::api_status status;
+  const auto event_id = "event_id";
+
+  r::ranking_response response;
+
+  for (auto _ : state)
+  {
+    for (size_t i = 0; i < count; i++)
+    {
+      if (model.choose_rank(event_id, examples[i].c_str(), response, &status) != err::success)
+      {
+        std::cout << "there was an error so something went wrong during "
+                     "benchmarking: "
+                  << status.get_error_msg() << std::endl;
+      }
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+
+// transform mode
+// x shared features
+// x features per action (affects dedup-ness)
+// x actions per example
+// x actions in total (affects dedup-ness)
+// x number of total examples so x number of total rank calls to benchmark
+BENCHMARK_CAPTURE(bench_cb_threads, dedup_compression_batcher, r::value::TRANSFORM_MODE_BATCHER, 20, 10, 50, 2000, 500)
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(bench_cb_threads, dedup_compression_caller, r::value::TRANSFORM_MODE_CALLER, 20, 10, 50, 2000, 500)
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(bench_cb_threads, dedup_compression_pool, r::value::TRANSFORM_MODE_POOL, 20, 10, 50, 2000, 500)
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(bench_cb_threads, dedup_compression_direct, r::value::TRANSFORM_MODE_DIRECT, 20, 10, 50, 2000, 500)
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
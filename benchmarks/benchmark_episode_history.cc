@@ -0,0 +1,48 @@
+#include "multistep.h"
+#include "ranking_response.h"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+namespace r = reinforcement_learning;
+
+// Measures a whole episode: every step records its event and builds the context of the next one.
+// The time per iteration is the time of the full episode.
+template <class... ExtraArgs>
+static void bench_episode_history(benchmark::State& state, ExtraArgs&&... extra_args)
+{
+  int res[sizeof...(extra_args)] = {extra_args...};
+  const int steps = res[0];
+  const int history_size = res[1];
+
+  std::vector<std::string> ids;
+  ids.reserve(steps);
+  for (int i = 0; i < steps; ++i) { ids.push_back("event_" + std::to_string(i)); }
+
+  const r::string_view context = R"({"GUser":{"id":"a","major":"eng"},"_multi":[{"TAction":{"a1":"f1"}}]})";
+  r::ranking_response response;
+  std::string context_patched;
+
+  for (auto _ : state)
+  {
+    r::episode_state episode("episode", history_size);
+    for (int i = 0; i < steps; ++i)
+    {
+      const char* previous_id = i == 0 ? nullptr : ids[i - 1].c_str();
+      episode.get_history().get_context(previous_id, context, context_patched);
+      benchmark::DoNotOptimize(context_patched.data());
+      episode.update(ids[i].c_str(), previous_id, context, response);
+    }
+    benchmark::ClobberMemory();
+  }
+
+  state.counters["steps_per_second"] =
+      benchmark::Counter(static_cast<double>(steps) * state.iterations(), benchmark::Counter::kIsRate);
+}
+
+// steps per episode
+// history size (0 is unbounded)
+BENCHMARK_CAPTURE(bench_episode_history, unbounded_10k, 10000, 0)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(bench_episode_history, window_100_10k, 10000, 100)->Unit(benchmark::kMillisecond);
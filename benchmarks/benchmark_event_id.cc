@@ -0,0 +1,40 @@
+#include "utility/event_id_generator.h"
+
+#include <benchmark/benchmark.h>
+#include <boost/uuid/random_generator.hpp>
+#include <boost/uuid/uuid_io.hpp>
+
+#include <string>
+
+namespace u = reinforcement_learning::utility;
+
+// What the auto generated ids used to cost: a freshly seeded boost generator per id.
+static void bench_event_id_boost(benchmark::State& state)
+{
+  for (auto _ : state)
+  {
+    const auto id = boost::uuids::to_string(boost::uuids::random_generator()());
+    benchmark::DoNotOptimize(id.data());
+  }
+}
+
+template <class... ExtraArgs>
+static void bench_event_id(benchmark::State& state, ExtraArgs&&... extra_args)
+{
+  int res[sizeof...(extra_args)] = {extra_args...};
+  const auto kind = res[0] != 0 ? u::event_id_kind::TIME_ORDERED : u::event_id_kind::RANDOM;
+
+  u::event_id_generator generator(kind);
+  char id[u::EVENT_ID_LENGTH + 1];
+  for (auto _ : state)
+  {
+    generator.generate(id);
+    benchmark::DoNotOptimize(id);
+  }
+}
+
+BENCHMARK(bench_event_id_boost)->ThreadRange(1, 8);
+
+// time ordered
+BENCHMARK_CAPTURE(bench_event_id, random, 0)->ThreadRange(1, 8);
+BENCHMARK_CAPTURE(bench_event_id, time_ordered, 1)->ThreadRange(1, 8);
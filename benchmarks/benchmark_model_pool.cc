@@ -0,0 +1,182 @@
+#include "benchmarks_common.h"
+#include "configuration.h"
+#include "constants.h"
+#include "model_mgmt.h"
+#include "vw/core/vw.h"
+#include "vw/io/io_adapter.h"
+#include "vw_model/pdf_model.h"
+#include "vw_model/vw_model.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace r = reinforcement_learning;
+namespace m = reinforcement_learning::model_management;
+
+namespace
+{
+// builds a cb model whose weights are all non-zero, so that every loaded copy is fully resident
+void make_model(int bits, m::model_data& data)
+{
+  auto* vw = VW::initialize("--cb_explore_adf --json --quiet -b " + std::to_string(bits));
+  auto& weights = vw->weights.dense_weights;
+  for (auto it = weights.begin(); it != weights.end(); ++it) { *it = 0.01f; }
+
+  auto backing = std::make_shared<std::vector<char>>();
+  io_buf buf;
+  buf.add_file(VW::io::create_vector_writer(backing));
+  VW::save_predictor(*vw, buf);
+  buf.flush();
+  VW::finish(*vw);
+
+  std::memcpy(data.alloc(backing->size()), backing->data(), backing->size());
+}
+}  // namespace
+
+// Measures the time to swap in a new model and the memory held by the pool afterwards.
+// pool_rss_mb is the growth of the process resident set while the model is loaded.
+template <class... ExtraArgs>
+static void bench_model_pool_update(benchmark::State& state, ExtraArgs&&... extra_args)
+{
+  int res[sizeof...(extra_args)] = {extra_args...};
+  const bool share_weights = res[0] != 0;
+  const int pool_size = res[1];
+  const int bits = res[2];
+
+  m::model_data data;
+  make_model(bits, data);
+
+  r::utility::configuration config;
+  config.set(r::name::VW_POOL_SHARE_WEIGHTS, share_weights ? "true" : "false");
+  config.set(r::name::VW_POOL_INIT_SIZE, std::to_string(pool_size).c_str());
+
+  const auto rss_before = resident_set_bytes();
+  size_t rss_after = rss_before;
+  {
+    m::vw_model model(nullptr, config);
+    for (auto _ : state)
+    {
+      bool model_ready = false;
+      model.update(data, model_ready);
+      benchmark::DoNotOptimize(model_ready);
+    }
+    rss_after = resident_set_bytes();
+  }
+
+  state.counters["pool_rss_mb"] =
+      static_cast<double>(rss_after > rss_before ? rss_after - rss_before : 0) / (1024.0 * 1024.0);
+}
+
+// share weights (on/off)
+// pool size
+// model bits
+BENCHMARK_CAPTURE(bench_model_pool_update, per_instance_weights_16, 0, 16, 20)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(bench_model_pool_update, shared_weights_16, 1, 16, 20)->Unit(benchmark::kMillisecond);
+
+namespace
+{
+// one model per pinning mode, shared by all the benchmark threads
+m::vw_model& shared_model(bool pin_per_thread)
+{
+  auto create = [](bool pin) {
+    r::utility::configuration config;
+    config.set(r::name::VW_POOL_PIN_PER_THREAD, pin ? "true" : "false");
+    config.set(r::name::VW_POOL_SHARE_WEIGHTS, "true");
+    auto* model = new m::vw_model(nullptr, config);
+    m::model_data data;
+    make_model(18, data);
+    bool model_ready = false;
+    model->update(data, model_ready);
+    return model;
+  };
+  static m::vw_model* pinned = create(true);
+  static m::vw_model* pooled = create(false);
+  return pin_per_thread ? *pinned : *pooled;
+}
+}  // namespace
+
+// Measures ranking throughput when all the threads share one model.
+// pool_contended is the number of pool acquisitions that had to wait on the pool mutex.
+template <class... ExtraArgs>
+static void bench_model_pool_rank(benchmark::State& state, ExtraArgs&&... extra_args)
+{
+  int res[sizeof...(extra_args)] = {extra_args...};
+  const bool pin_per_thread = res[0] != 0;
+
+  auto& model = shared_model(pin_per_thread);
+  const std::string context = R"({"GUser":{"id":"a","major":"eng"},"_multi":[{"TAction":{"a1":"f1"}},)"
+                              R"({"TAction":{"a2":"f2"}},{"TAction":{"a3":"f3"}}]})";
+  std::vector<int> action_ids;
+  std::vector<float> action_pdf;
+  std::string model_version;
+  const auto before = model.pool_stats();
+
+  for (auto _ : state)
+  {
+    model.choose_rank("event_id", 0, context, action_ids, action_pdf, model_version);
+    benchmark::ClobberMemory();
+  }
+
+  // the pool counters are global, every thread sees about the same delta
+  const auto after = model.pool_stats();
+  state.counters["pool_contended"] =
+      benchmark::Counter(static_cast<double>(after.contended - before.contended), benchmark::Counter::kAvgThreads);
+  state.counters["pinned_hits"] =
+      benchmark::Counter(static_cast<double>(after.pinned_hits - before.pinned_hits), benchmark::Counter::kAvgThreads);
+}
+
+// pin per thread (on/off)
+BENCHMARK_CAPTURE(bench_model_pool_rank, pooled, 0)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK_CAPTURE(bench_model_pool_rank, pinned, 1)->ThreadRange(1, 64)->UseRealTime();
+
+namespace
+{
+// one passthrough model per parser, shared by all the benchmark threads
+// 0: json extractor, 1: pooled VW parser, 2: VW parser pinned per thread
+m::pdf_model& shared_pdf_model(int parser)
+{
+  auto create = [](int parser) {
+    r::utility::configuration config;
+    config.set(r::name::MODEL_PASSTHROUGH_PDF_VW_PARSER, parser != 0 ? "true" : "false");
+    config.set(r::name::VW_POOL_PIN_PER_THREAD, parser == 2 ? "true" : "false");
+    return new m::pdf_model(nullptr, config);
+  };
+  static m::pdf_model* models[] = {create(0), create(1), create(2)};
+  return *models[parser];
+}
+}  // namespace
+
+// Measures the throughput of the passthrough PDF model when all the threads share one model.
+template <class... ExtraArgs>
+static void bench_pdf_model_rank(benchmark::State& state, ExtraArgs&&... extra_args)
+{
+  int res[sizeof...(extra_args)] = {extra_args...};
+  const int parser = res[0];
+
+  auto& model = shared_pdf_model(parser);
+  const std::string context = R"({"GUser":{"id":"a","major":"eng"},"_multi":[{"TAction":{"a1":"f1"}},)"
+                              R"({"TAction":{"a2":"f2"}},{"TAction":{"a3":"f3"}}],"p":[0.2,0.3,0.5]})";
+  std::vector<int> action_ids;
+  std::vector<float> action_pdf;
+  std::string model_version;
+  const auto before = model.pool_stats();
+
+  for (auto _ : state)
+  {
+    model.choose_rank("event_id", 0, context, action_ids, action_pdf, model_version);
+    benchmark::ClobberMemory();
+  }
+
+  const auto after = model.pool_stats();
+  state.counters["pool_contended"] =
+      benchmark::Counter(static_cast<double>(after.contended - before.contended), benchmark::Counter::kAvgThreads);
+}
+
+// parser (json extractor, pooled VW, pinned VW)
+BENCHMARK_CAPTURE(bench_pdf_model_rank, json, 0)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK_CAPTURE(bench_pdf_model_rank, vw_pooled, 1)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK_CAPTURE(bench_pdf_model_rank, vw_pinned, 2)->ThreadRange(1, 64)->UseRealTime();
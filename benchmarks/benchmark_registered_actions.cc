@@ -0,0 +1,67 @@
+#include "model_mgmt.h"
+#include "vw_model/safe_vw.h"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+namespace r = reinforcement_learning;
+namespace m = reinforcement_learning::model_management;
+
+namespace
+{
+std::string make_action(int action, int features)
+{
+  std::string json = R"({"TAction":{)";
+  for (int i = 0; i < features; ++i)
+  {
+    if (i > 0) { json += ','; }
+    json += "\"f" + std::to_string(i) + "\":" + std::to_string(action * features + i + 1);
+  }
+  return json + "}}";
+}
+}  // namespace
+
+// Ranks the same decision from its full json context and from a shared context with registered actions.
+template <class... ExtraArgs>
+static void bench_rank_registered(benchmark::State& state, ExtraArgs&&... extra_args)
+{
+  int res[sizeof...(extra_args)] = {extra_args...};
+  const bool registered = res[0] != 0;
+  const int action_count = res[1];
+  const int action_features = res[2];
+
+  r::safe_vw vw("--cb_explore_adf --json --quiet");
+  const std::string shared = R"({"GUser":{"id":"a","major":"eng"})";
+
+  std::vector<std::string> actions_json;
+  for (int i = 0; i < action_count; ++i) { actions_json.push_back(make_action(i, action_features)); }
+
+  std::string context = shared.substr(0, shared.size() - 1) + R"(,"_multi":[)";
+  std::vector<m::registered_action> actions;
+  for (size_t i = 0; i < actions_json.size(); ++i)
+  {
+    context += (i > 0 ? "," : "") + actions_json[i];
+    actions.push_back({i, actions_json[i]});
+  }
+  context += "]}";
+  const std::string shared_context = shared.substr(0, shared.size() - 1) + R"(,"_multi":[]})";
+
+  std::vector<int> action_ids;
+  std::vector<float> scores;
+  for (auto _ : state)
+  {
+    if (registered) { vw.rank_registered(shared_context, actions, 0, action_ids, scores); }
+    else { vw.rank_with_context_buffer(context, action_ids, scores); }
+    benchmark::ClobberMemory();
+  }
+}
+
+// registered actions (on/off)
+// actions per decision
+// features per action
+BENCHMARK_CAPTURE(bench_rank_registered, json_10x20, 0, 10, 20);
+BENCHMARK_CAPTURE(bench_rank_registered, registered_10x20, 1, 10, 20);
+BENCHMARK_CAPTURE(bench_rank_registered, json_50x50, 0, 50, 50);
+BENCHMARK_CAPTURE(bench_rank_registered, registered_50x50, 1, 50, 50);
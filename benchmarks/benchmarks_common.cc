@@ -2,8 +2,43 @@
 
 #include "vw/core/rand48.h"
 
+#include <cstdlib>
+#include <fstream>
+#include <new>
 #include <set>
 
+#ifdef __linux__
+#  include <unistd.h>
+#endif
+
+namespace
+{
+thread_local size_t allocation_count = 0;
+}
+
+size_t thread_allocation_count() { return allocation_count; }
+
+size_t resident_set_bytes()
+{
+#ifdef __linux__
+  // statm reports the total program size followed by the resident set size, both in pages
+  std::ifstream statm("/proc/self/statm");
+  size_t total_pages = 0;
+  size_t resident_pages = 0;
+  if (statm >> total_pages >> resident_pages) { return resident_pages * static_cast<size_t>(sysconf(_SC_PAGESIZE)); }
+#endif
+  return 0;
+}
+
+void* operator new(std::size_t size)
+{
+  ++allocation_count;
+  if (void* ptr = std::malloc(size == 0 ? 1 : size)) { return ptr; }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
 prng::prng(uint64_t initial_seed) : val(merand48(initial_seed)) {}
 
 uint64_t prng::next_uint()
@@ -1,3 +1,4 @@
+#include <cstddef>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -27,3 +28,9 @@ public:
 
   std::string gen_example();
 };
+
+// Number of heap allocations made so far by the calling thread, counted by the replaced global operator new
+size_t thread_allocation_count();
+
+// Resident set size of the process in bytes, 0 where it cannot be read
+size_t resident_set_bytes();
@@ -0,0 +1,108 @@
+#include "mmap_log_reader.h"
+#include "parse_example_binary.h"
+#include "parse_example_external.h"
+#include "vw/config/options_cli.h"
+#include "vw/core/parser.h"
+#include "vw/core/vw.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+const std::string BENCHMARK_LOG = "binary_parser_benchmark.fb";
+
+void write_message(std::ofstream& out, unsigned int type, const char* payload, uint32_t size)
+{
+  static const char padding[8] = {};
+  out.write(reinterpret_cast<const char*>(&type), sizeof(type));
+  if (type != MSG_TYPE_FILEMAGIC)
+  {
+    out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    out.write(payload, size);
+    out.write(padding, size % 8);
+  }
+  else { out.write(payload, size); }
+}
+
+// Repeats the regular messages of a test log until the log is about target_size bytes, returns its size.
+size_t generate_log(size_t target_size)
+{
+  const std::string source_log = "valid_joined_logs/average_reward_100_interactions.fb";
+  mmap_log_reader source(std::string(BINARY_PARSER_TEST_FILES) + source_log);
+  std::ofstream out(BENCHMARK_LOG, std::ios::binary | std::ios::trunc);
+
+  std::vector<std::vector<char>> regular_messages;
+  mmap_log_reader::message msg;
+  while (source.next(msg))
+  {
+    if (msg.type == MSG_TYPE_REGULAR) { regular_messages.emplace_back(msg.payload, msg.payload + msg.size); }
+    else { write_message(out, msg.type, msg.payload, msg.size); }
+  }
+
+  while (static_cast<size_t>(out.tellp()) < target_size)
+  {
+    for (const auto& payload : regular_messages)
+    { write_message(out, MSG_TYPE_REGULAR, payload.data(), static_cast<uint32_t>(payload.size())); }
+  }
+  return static_cast<size_t>(out.tellp());
+}
+
+size_t benchmark_log_size()
+{
+  static const size_t size = generate_log(64 * 1024 * 1024);
+  return size;
+}
+}  // namespace
+
+// Measures reading, verifying and joining the whole log into examples, nothing is learnt.
+// The time per iteration is the time to parse the full log.
+template <class... ExtraArgs>
+static void bench_parse_log(benchmark::State& state, ExtraArgs&&... extra_args)
+{
+  int res[sizeof...(extra_args)] = {extra_args...};
+  const bool mmap_input = res[0] != 0;
+  const int parser_threads = res[1];
+
+  const size_t log_size = benchmark_log_size();
+  std::vector<std::string> args = {"--quiet", "--binary_parser", "--cb_explore_adf", "-d", BENCHMARK_LOG,
+      "--parser_threads", std::to_string(parser_threads)};
+  if (mmap_input) { args.push_back("--mmap_input"); }
+
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+    auto vw = VW::external::initialize_with_binary_parser(VW::make_unique<VW::config::options_cli>(args));
+    VW::multi_ex examples;
+    examples.push_back(VW::new_unused_example(*vw));
+    state.ResumeTiming();
+
+    while (vw->example_parser->reader(vw.get(), vw->example_parser->input, examples) > 0)
+    {
+      vw->finish_example(examples);
+      examples.clear();
+      examples.push_back(VW::new_unused_example(*vw));
+    }
+
+    state.PauseTiming();
+    vw->finish_example(examples);
+    VW::finish(*vw, false);
+    state.ResumeTiming();
+  }
+
+  state.counters["MB/s"] = benchmark::Counter(
+      static_cast<double>(log_size) / (1000 * 1000) * state.iterations(), benchmark::Counter::kIsRate);
+}
+
+// memory mapped input
+// parser threads
+BENCHMARK_CAPTURE(bench_parse_log, io_buf, 0, 0)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(bench_parse_log, mmap, 1, 0)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(bench_parse_log, io_buf_4_threads, 0, 4)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(bench_parse_log, mmap_4_threads, 1, 4)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
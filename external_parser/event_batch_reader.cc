@@ -0,0 +1,49 @@
+#include "event_batch_reader.h"
+
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+uint32_t read_network_uint32(const char* data)
+{
+  const auto* bytes = reinterpret_cast<const unsigned char*>(data);
+  return (static_cast<uint32_t>(bytes[0]) << 24) | (static_cast<uint32_t>(bytes[1]) << 16) |
+      (static_cast<uint32_t>(bytes[2]) << 8) | static_cast<uint32_t>(bytes[3]);
+}
+}  // namespace
+
+event_batch_reader::event_batch_reader(const char* data, size_t size)
+    : _next(data), _end(data + size), _dctx(ZSTD_createDCtx())
+{
+}
+
+const v2::EventBatch* event_batch_reader::next()
+{
+  if (_next == _end) { return nullptr; }
+  if (static_cast<size_t>(_end - _next) < PREAMBLE_SIZE) { throw std::runtime_error("Truncated batch preamble"); }
+
+  const auto encoding = static_cast<uint8_t>(_next[0]);
+  const auto body_size = read_network_uint32(_next + 4);
+  const char* body = _next + PREAMBLE_SIZE;
+  if (static_cast<size_t>(_end - body) < body_size) { throw std::runtime_error("Truncated batch body"); }
+  _next = body + body_size;
+
+  if (encoding == CONTENT_ENCODING_ZSTD)
+  {
+    const auto content_size = ZSTD_getFrameContentSize(body, body_size);
+    if (content_size == ZSTD_CONTENTSIZE_ERROR || content_size == ZSTD_CONTENTSIZE_UNKNOWN)
+    { throw std::runtime_error("Invalid compressed batch"); }
+    _decompressed.resize(content_size);
+    const auto res = ZSTD_decompressDCtx(_dctx.get(), _decompressed.data(), _decompressed.size(), body, body_size);
+    if (ZSTD_isError(res) != 0u)
+    { throw std::runtime_error(std::string("Can not decompress batch: ") + ZSTD_getErrorName(res)); }
+    body = _decompressed.data();
+  }
+  else if (encoding != CONTENT_ENCODING_IDENTITY)
+  {
+    throw std::runtime_error("Unknown batch content encoding " + std::to_string(encoding));
+  }
+
+  return v2::GetEventBatch(body);
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "generated/v2/Event_generated.h"
+#include "zstd.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace v2 = reinforcement_learning::messages::flatbuff::v2;
+
+/*
+event batch reader
+Reads the messages written by the client senders, each one is an 8 byte
+preamble followed by a v2 EventBatch. When the client compresses the whole
+batch (send.batch_compression) the first preamble byte says so and the batch
+is decompressed before being handed out.
+
+Preamble layout, see rlclientlib/logger/preamble.h:
+  [0] content encoding, [1] version, [2-3] message type, [4-7] body size
+  (both in network order)
+*/
+class event_batch_reader
+{
+public:
+  static constexpr size_t PREAMBLE_SIZE = 8;
+  static constexpr uint8_t CONTENT_ENCODING_IDENTITY = 0;
+  static constexpr uint8_t CONTENT_ENCODING_ZSTD = 1;
+
+  // the data has to outlive the reader, identity batches point into it
+  event_batch_reader(const char* data, size_t size);
+
+  // returns nullptr once every message was read, throws on truncated or corrupted messages
+  // the batch stays valid until the next call
+  const v2::EventBatch* next();
+
+  event_batch_reader(const event_batch_reader&) = delete;
+  event_batch_reader(event_batch_reader&&) = delete;
+  event_batch_reader& operator=(const event_batch_reader&) = delete;
+  event_batch_reader& operator=(event_batch_reader&&) = delete;
+
+private:
+  struct dctx_deleter
+  {
+    void operator()(ZSTD_DCtx* ctx) const { ZSTD_freeDCtx(ctx); }
+  };
+
+  const char* _next;
+  const char* _end;
+  std::unique_ptr<ZSTD_DCtx, dctx_deleter> _dctx;
+  std::vector<char> _decompressed;
+};
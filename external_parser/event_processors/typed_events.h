@@ -8,6 +8,7 @@
 #include "loop.h"
 #include "vw/core/json_utils.h"
 #include "zstd.h"
+#include "zstd_dictionaries.h"
 
 namespace v2 = reinforcement_learning::messages::flatbuff::v2;
 
@@ -186,7 +187,7 @@ struct event_processor<v2::CaEvent>
 
 template <typename T>
 bool process_compression(const uint8_t* data, size_t size, const v2::Metadata& metadata, const T*& payload,
-    flatbuffers::DetachedBuffer& detached_buffer, VW::io::logger& logger)
+    flatbuffers::DetachedBuffer& detached_buffer, zstd_dictionaries& dictionaries, VW::io::logger& logger)
 {
   if (metadata.encoding() == v2::EventEncoding_Zstd)
   {
@@ -211,7 +212,7 @@ bool process_compression(const uint8_t* data, size_t size, const v2::Metadata& m
     }
 
     std::unique_ptr<uint8_t[]> buff_data(flatbuffers::DefaultAllocator().allocate(buff_size));
-    size_t res = ZSTD_decompress(buff_data.get(), buff_size, data, size);
+    size_t res = dictionaries.decompress(buff_data.get(), buff_size, data, size);
 
     if (ZSTD_isError(res))
     {
@@ -44,7 +44,7 @@ example_joiner::example_joiner(VW::workspace* vw, bool binary_to_json, const std
 example_joiner::~example_joiner()
 {
   // cleanup examples
-  _dedup_cache.clear(return_example_f, this);
+  for (auto& reader : _dedup_readers) { reader.second->cache.clear(return_example_f, this); }
   for (auto* ex : _example_pool) { VW::dealloc_examples(ex, 1); }
   if (_binary_to_json) { _outfile.close(); }
 }
@@ -103,7 +103,9 @@ bool example_joiner::process_event(const v2::JoinedEvent& joined_event)
     {
       // clean everything this batch is ruined without the dedup info
       // dedup cache will clear itself up when next dedup payload arrives
+      // (or the next snapshot when the client only sends the dictionary updates)
       clear_batch_info();
+      if (_dedup_reader != nullptr) { _dedup_reader->in_sync = false; }
       return false;
     }
     return true;
@@ -217,6 +219,22 @@ bool iequals(const std::string& a, const std::string& b)
   return std::equal(a.begin(), a.end(), b.begin(), [](char a, char b) { return std::tolower(a) == std::tolower(b); });
 }
 
+template <typename T>
+bool example_joiner::get_payload(const v2::Event& event, const v2::Metadata& metadata, const T*& payload)
+{
+  if (_decompressed_payloads != nullptr && metadata.encoding() == v2::EventEncoding_Zstd)
+  {
+    const auto it = _decompressed_payloads->find(event.payload()->data());
+    if (it != _decompressed_payloads->end())
+    {
+      payload = flatbuffers::GetRoot<T>(it->second.data());
+      return true;
+    }
+  }
+  return typed_event::process_compression<T>(event.payload()->data(), event.payload()->size(), metadata, payload,
+      _detached_buffer, _zstd_dictionaries, logger);
+}
+
 bool example_joiner::process_interaction(
     const v2::Event& event, const v2::Metadata& metadata, const TimePoint& enqueued_time_utc, VW::multi_ex& examples)
 {
@@ -240,10 +258,7 @@ bool example_joiner::process_interaction(
   if (metadata.payload_type() == v2::PayloadType_CB)
   {
     const v2::CbEvent* cb = nullptr;
-    if (!typed_event::process_compression<v2::CbEvent>(
-            event.payload()->data(), event.payload()->size(), metadata, cb, _detached_buffer, logger) ||
-        cb == nullptr)
-    { return false; }
+    if (!get_payload<v2::CbEvent>(event, metadata, cb) || cb == nullptr) { return false; }
 
     if (!typed_event::event_processor<v2::CbEvent>::is_valid(*cb, _loop_info, logger))
     {
@@ -260,10 +275,7 @@ bool example_joiner::process_interaction(
   else if (metadata.payload_type() == v2::PayloadType_CCB || metadata.payload_type() == v2::PayloadType_Slates)
   {
     const v2::MultiSlotEvent* multislot = nullptr;
-    if (!typed_event::process_compression<v2::MultiSlotEvent>(
-            event.payload()->data(), event.payload()->size(), metadata, multislot, _detached_buffer, logger) ||
-        multislot == nullptr)
-    { return false; }
+    if (!get_payload<v2::MultiSlotEvent>(event, metadata, multislot) || multislot == nullptr) { return false; }
 
     if (!typed_event::event_processor<v2::MultiSlotEvent>::is_valid(*multislot, _loop_info, logger))
     {
@@ -280,10 +292,7 @@ bool example_joiner::process_interaction(
   else if (metadata.payload_type() == v2::PayloadType_CA)
   {
     const v2::CaEvent* ca = nullptr;
-    if (!typed_event::process_compression<v2::CaEvent>(
-            event.payload()->data(), event.payload()->size(), metadata, ca, _detached_buffer, logger) ||
-        ca == nullptr)
-    { return false; }
+    if (!get_payload<v2::CaEvent>(event, metadata, ca) || ca == nullptr) { return false; }
 
     if (!typed_event::event_processor<v2::CaEvent>::is_valid(*ca, _loop_info, logger))
     {
@@ -310,18 +319,22 @@ bool example_joiner::process_interaction(
 
   if (!_binary_to_json)
   {
+    // objects are only looked up in the dictionary of the client that sent
+    // the last dedup payload
+    auto& reader = _dedup_reader != nullptr ? *_dedup_reader : get_dedup_reader(0);
+    auto* dedup_examples = &reader.cache.dedup_examples;
     std::string context(je.context);
     try
     {
       if (_vw->audit || _vw->hash_inv)
       {
         VW::read_line_json_s<true>(*_vw, examples, const_cast<char*>(context.c_str()), context.size(),
-            reinterpret_cast<VW::example_factory_t>(VW::new_unused_example), _vw, &_dedup_cache.dedup_examples);
+            reinterpret_cast<VW::example_factory_t>(VW::new_unused_example), _vw, dedup_examples);
       }
       else
       {
         VW::read_line_json_s<false>(*_vw, examples, const_cast<char*>(context.c_str()), context.size(),
-            reinterpret_cast<VW::example_factory_t>(VW::new_unused_example), _vw, &_dedup_cache.dedup_examples);
+            reinterpret_cast<VW::example_factory_t>(VW::new_unused_example), _vw, dedup_examples);
       }
     }
     catch (VW::vw_exception& e)
@@ -349,9 +362,7 @@ bool example_joiner::process_outcome(
   o_event.enqueued_time_utc = enqueued_time_utc;
 
   const v2::OutcomeEvent* outcome = nullptr;
-  if (!typed_event::process_compression<v2::OutcomeEvent>(
-          event.payload()->data(), event.payload()->size(), metadata, outcome, _detached_buffer, logger) ||
-      outcome == nullptr)
+  if (!get_payload<v2::OutcomeEvent>(event, metadata, outcome) || outcome == nullptr)
   {
     // invalidate joined_event so that we don't learn from it
     invalidate_joined_event(metadata.id()->str());
@@ -385,11 +396,15 @@ bool example_joiner::process_outcome(
 
 bool example_joiner::process_dedup(const v2::Event& event, const v2::Metadata& metadata)
 {
+  _dedup_reader = nullptr;
   const v2::DedupInfo* dedup = nullptr;
-  if (!typed_event::process_compression<v2::DedupInfo>(
-          event.payload()->data(), event.payload()->size(), metadata, dedup, _detached_buffer, logger) ||
-      dedup == nullptr)
-  { return false; }
+  if (!get_payload<v2::DedupInfo>(event, metadata, dedup) || dedup == nullptr) { return false; }
+
+  // a Snapshot or an eviction of one client must not drop the objects of
+  // another one
+  _dedup_reader = &get_dedup_reader(dedup->client_id());
+  auto& reader = *_dedup_reader;
+  auto& cache = reader.cache;
 
   if (dedup->ids()->size() != dedup->values()->size())
   {
@@ -397,12 +412,24 @@ bool example_joiner::process_dedup(const v2::Event& event, const v2::Metadata& m
     return false;
   }
 
+  const auto mode = dedup->mode();
+  if (mode == v2::DedupMode_Snapshot) { reader.in_sync = true; }
+  else if (mode == v2::DedupMode_Delta && reader.in_sync && dedup->sequence() != reader.sequence + 1)
+  {
+    logger.out_warn(
+        "Dedup update {} follows update {} of client {}, events using the missed objects will fail until the next "
+        "snapshot",
+        dedup->sequence(), reader.sequence, dedup->client_id());
+    reader.in_sync = false;
+  }
+  reader.sequence = dedup->sequence();
+
   VW::multi_ex examples;
 
   for (flatbuffers::uoffset_t i = 0; i < dedup->ids()->size(); i++)
   {
     auto dedup_id = dedup->ids()->Get(i);
-    if (!_dedup_cache.exists(dedup_id))
+    if (!cache.exists(dedup_id))
     {
       examples.push_back(get_or_create_example());
 
@@ -428,25 +455,44 @@ bool example_joiner::process_dedup(const v2::Event& event, const v2::Metadata& m
         return false;
       }
 
-      _dedup_cache.add(dedup_id, examples[0]);
+      cache.add(dedup_id, examples[0]);
       examples.clear();
     }
     else
     {
-      _dedup_cache.update(dedup_id);
+      cache.update(dedup_id);
     }
   }
 
-  if (dedup->ids()->size() > 0)
+  if (mode == v2::DedupMode_Delta)
+  {
+    // the previous items are kept, only the ones the client dropped are removed
+    if (dedup->evicted_ids() != nullptr)
+    {
+      for (auto dedup_id : *dedup->evicted_ids()) { cache.remove(dedup_id, return_example_f, this); }
+    }
+  }
+  else if (dedup->ids()->size() > 0)
   {
     // location of first item in dedup payload will be the "last" item in the
     // cache that we care about keeping
-    _dedup_cache.clear_after(dedup->ids()->Get(0), return_example_f, this);
+    cache.clear_after(dedup->ids()->Get(0), return_example_f, this);
+  }
+  else if (mode == v2::DedupMode_Snapshot)
+  {
+    cache.clear(return_example_f, this);
   }
 
   return true;
 }
 
+example_joiner::dedup_reader& example_joiner::get_dedup_reader(uint64_t client_id)
+{
+  auto& reader = _dedup_readers[client_id];
+  if (reader == nullptr) { reader.reset(new dedup_reader()); }
+  return *reader;
+}
+
 bool example_joiner::process_joined(VW::multi_ex& examples)
 {
   _current_je_is_skip_learn = false;
@@ -593,9 +639,17 @@ bool example_joiner::current_event_is_skip_learn() { return _current_je_is_skip_
 void example_joiner::on_new_batch() {}
 void example_joiner::on_batch_read() {}
 
+void example_joiner::set_decompressed_payloads(const decompressed_payloads* payloads)
+{
+  _decompressed_payloads = payloads;
+}
+
 metrics::joiner_metrics example_joiner::get_metrics() { return _joiner_metrics; }
 
-void example_joiner::apply_cli_overrides(VW::workspace*, const VW::external::parser_options&) {}
+void example_joiner::apply_cli_overrides(VW::workspace*, const VW::external::parser_options& parsed_options)
+{
+  for (const auto& path : parsed_options.zstd_dictionaries) { _zstd_dictionaries.load(path); }
+}
 
 #ifdef RL_WINDOWS_GETOBJECT_MACRO_UNDEF
 #  undef RL_WINDOWS_GETOBJECT_MACRO_UNDEF
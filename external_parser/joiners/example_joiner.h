@@ -6,12 +6,14 @@
 #include "lru_dedup_cache.h"
 #include "metrics/metrics.h"
 #include "parse_example_external.h"
+#include "zstd_dictionaries.h"
 #include "vw/core/error_constants.h"
 #include "vw/core/example.h"
 #include "vw/core/v_array.h"
 
 #include <fstream>
 #include <list>
+#include <memory>
 #include <queue>
 #include <unordered_map>
 
@@ -85,11 +87,17 @@ public:
 
   void on_batch_read() override;
 
+  void set_decompressed_payloads(const decompressed_payloads* payloads) override;
+
   metrics::joiner_metrics get_metrics() override;
 
   void persist_metrics() override;
 
 private:
+  // the payload of the event, decompressed if needed
+  template <typename T>
+  bool get_payload(const v2::Event& event, const v2::Metadata& metadata, const T*& payload);
+
   bool process_dedup(const v2::Event& event, const v2::Metadata& metadata);
 
   bool process_interaction(
@@ -110,7 +118,23 @@ private:
 
   static void return_example_f(void* vw, VW::example* ex);
 
-  lru_dedup_cache _dedup_cache;
+  // dictionary of one client, clients that keep their dictionary across
+  // batches only send updates to it
+  struct dedup_reader
+  {
+    lru_dedup_cache cache;
+    // sequence of the last dedup update, and whether none was missed since
+    // the last snapshot
+    uint64_t sequence = 0;
+    bool in_sync = true;
+  };
+  dedup_reader& get_dedup_reader(uint64_t client_id);
+
+  // by DedupInfo client id, 0 for the clients that send every object used by
+  // a batch
+  std::unordered_map<uint64_t, std::unique_ptr<dedup_reader>> _dedup_readers;
+  // reader of the last dedup payload, used by the interactions that follow it
+  dedup_reader* _dedup_reader = nullptr;
   // from event id to all the information required to create a complete
   // (multi)example
   std::unordered_map<std::string, joined_event::joined_event> _batch_grouped_examples;
@@ -122,6 +146,8 @@ private:
 
   VW::workspace* _vw;
   flatbuffers::DetachedBuffer _detached_buffer;
+  zstd_dictionaries _zstd_dictionaries;
+  const decompressed_payloads* _decompressed_payloads = nullptr;
 
   loop::sticky_value<reward::RewardFunctionType> _reward_calculation;
   loop::loop_info _loop_info;
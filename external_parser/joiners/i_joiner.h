@@ -15,6 +15,7 @@
 #include <list>
 #include <queue>
 #include <unordered_map>
+#include <vector>
 // VW headers
 // vw.h has to come before json_utils.h
 // clang-format off
@@ -24,6 +25,9 @@
 
 namespace v2 = reinforcement_learning::messages::flatbuff::v2;
 
+// Event payloads decompressed ahead of the joiner, keyed by the address of their compressed data
+using decompressed_payloads = std::unordered_map<const uint8_t*, std::vector<uint8_t>>;
+
 class i_joiner
 {
 public:
@@ -66,6 +70,10 @@ public:
 
   virtual void on_batch_read() = 0;
 
+  // Payloads of the next batches that were already decompressed, they must outlive the batches.
+  // Joiners that do not use them decompress every payload themselves, nullptr clears them.
+  virtual void set_decompressed_payloads(const decompressed_payloads* payloads) {}
+
   virtual void persist_metrics() {}
 
   virtual metrics::joiner_metrics get_metrics() = 0;
@@ -34,6 +34,17 @@ void lru_dedup_cache::clear_after(uint64_t first_id, release_example_f release_e
   lru.erase(first_pos, lru.end());
 }
 
+bool lru_dedup_cache::remove(uint64_t dedup_id, release_example_f release_example, void* context)
+{
+  auto position = lru_pos.find(dedup_id);
+  if (position == lru_pos.end()) { return false; }
+  lru.erase(position->second);
+  lru_pos.erase(position);
+  release_example(context, dedup_examples[dedup_id]);
+  dedup_examples.erase(dedup_id);
+  return true;
+}
+
 void lru_dedup_cache::clear(release_example_f release_example, void* context)
 {
   for (auto& dedup_item : dedup_examples) { release_example(context, dedup_item.second); }
@@ -14,6 +14,9 @@ assume that anything after that can be evicted as it was not in the new dedup
 payload. If two dedup payloads are identical then nothing will be evicted.
 
 Assumption: dedup payloads are dictionaries and so they have unique items
+
+When the client keeps its dictionary across batches the payloads only carry
+the new items, and the items the client dropped are removed one by one.
 */
 struct lru_dedup_cache
 {
@@ -33,6 +36,9 @@ public:
   void update(uint64_t dedup_id);
   void clear_after(uint64_t dedup_id, release_example_f release_example = lru_dedup_cache::noop_release_example_f,
       void* context = nullptr);
+  //! Returns false if the item was not cached
+  bool remove(uint64_t dedup_id, release_example_f release_example = lru_dedup_cache::noop_release_example_f,
+      void* context = nullptr);
   bool exists(uint64_t dedup_id);
   void clear(release_example_f release_example = lru_dedup_cache::noop_release_example_f, void* context = nullptr);
 
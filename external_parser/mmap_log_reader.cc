@@ -0,0 +1,132 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "mmap_log_reader.h"
+
+#include "parse_example_binary.h"
+
+#include <cstring>
+#include <stdexcept>
+#ifndef _WIN32
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+mmap_log_reader::mmap_log_reader(const std::string& path)
+{
+#ifndef _WIN32
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) { throw std::runtime_error("Can not open joined log " + path); }
+
+  struct stat result;
+  if (fstat(fd, &result) != 0)
+  {
+    close(fd);
+    throw std::runtime_error("Can not read the size of joined log " + path);
+  }
+
+  _size = static_cast<size_t>(result.st_size);
+  if (_size > 0)
+  {
+    void* addr = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr == MAP_FAILED)
+    {
+      close(fd);
+      throw std::runtime_error("Can not memory map joined log " + path);
+    }
+    // only a hint, the log is read correctly without it
+    madvise(addr, _size, MADV_SEQUENTIAL);
+    _data = static_cast<const char*>(addr);
+  }
+  // the mapping keeps the file alive
+  close(fd);
+#else
+  throw std::runtime_error("Memory mapped joined logs are not supported on this platform");
+#endif
+}
+
+mmap_log_reader::~mmap_log_reader()
+{
+#ifndef _WIN32
+  if (_data != nullptr) { munmap(const_cast<char*>(_data), _size); }
+#endif
+}
+
+bool mmap_log_reader::supported()
+{
+#ifndef _WIN32
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool mmap_log_reader::read_uint32(uint32_t& value)
+{
+  if (_size - _offset < sizeof(value))
+  {
+    _truncated = true;
+    return false;
+  }
+  std::memcpy(&value, _data + _offset, sizeof(value));
+  _offset += sizeof(value);
+  return true;
+}
+
+bool mmap_log_reader::next(message& msg)
+{
+  // same padding rule as binary_parser
+  if (_padding > 0)
+  {
+    if (_size - _offset < _padding)
+    {
+      _truncated = true;
+      return false;
+    }
+    _offset += _padding;
+    _padding = 0;
+  }
+
+  // a log does not have to end with an EOF message
+  if (_offset == _size) { return false; }
+
+  uint32_t type = 0;
+  if (!read_uint32(type)) { return false; }
+  if (type == MSG_TYPE_EOF) { return false; }
+
+  msg.type = type;
+  if (type == MSG_TYPE_FILEMAGIC)
+  {
+    // the version is the only message without a size
+    msg.size = 4;
+  }
+  else if (!read_uint32(msg.size))
+  {
+    return false;
+  }
+  else
+  {
+    _padding = msg.size % 8;
+  }
+
+  if (_size - _offset < msg.size)
+  {
+    _truncated = true;
+    return false;
+  }
+
+  msg.payload = _data + _offset;
+  msg.in_place = reinterpret_cast<uintptr_t>(msg.payload) % sizeof(uint64_t) == 0;
+  if (!msg.in_place)
+  {
+    // flatbuffers need aligned payloads
+    _scratch.resize((msg.size + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+    std::memcpy(_scratch.data(), msg.payload, msg.size);
+    msg.payload = reinterpret_cast<const char*>(_scratch.data());
+  }
+  _offset += msg.size;
+  return true;
+}
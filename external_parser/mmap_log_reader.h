@@ -0,0 +1,60 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+memory mapped joined log
+The whole file is mapped read-only and its messages are read in place, so the
+payloads handed out stay valid for the lifetime of the reader and are never
+copied. The kernel is told that the file is read sequentially so it reads
+ahead aggressively. A payload that is not 8 byte aligned in the file is copied
+into a scratch buffer instead, which is only valid until the next message.
+*/
+class mmap_log_reader
+{
+public:
+  struct message
+  {
+    unsigned int type = 0;
+    const char* payload = nullptr;
+    uint32_t size = 0;
+    // false when the payload is in the scratch buffer
+    bool in_place = true;
+  };
+
+  // throws std::runtime_error if the file can not be mapped
+  explicit mmap_log_reader(const std::string& path);
+  ~mmap_log_reader();
+
+  mmap_log_reader(const mmap_log_reader&) = delete;
+  mmap_log_reader(mmap_log_reader&&) = delete;
+  mmap_log_reader& operator=(const mmap_log_reader&) = delete;
+  mmap_log_reader& operator=(mmap_log_reader&&) = delete;
+
+  // false at the end of the log, truncated() tells whether the framing ended early
+  bool next(message& msg);
+  bool truncated() const { return _truncated; }
+  // bytes of the file consumed so far
+  uint64_t bytes_read() const { return _offset; }
+  size_t size() const { return _size; }
+
+  static bool supported();
+
+private:
+  bool read_uint32(uint32_t& value);
+
+  const char* _data = nullptr;
+  size_t _size = 0;
+  size_t _offset = 0;
+  // padding left after the previous payload
+  uint32_t _padding = 0;
+  bool _truncated = false;
+  std::vector<uint64_t> _scratch;
+};
@@ -6,6 +6,7 @@
 
 #include "flatbuffers/flatbuffers.h"
 #include "joiners/example_joiner.h"
+#include "mmap_log_reader.h"
 #include "vw/core/action_score.h"
 #include "vw/core/best_constant.h"
 #include "vw/core/cb.h"
@@ -83,8 +84,14 @@ namespace VW
 {
 namespace external
 {
-binary_parser::binary_parser(std::unique_ptr<i_joiner>&& joiner, VW::io::logger logger)
-    : parser(logger), _example_joiner(std::move(joiner)), _payload(nullptr), _payload_size(0), _total_size_read(0)
+binary_parser::binary_parser(
+    std::unique_ptr<i_joiner>&& joiner, VW::io::logger logger, std::unique_ptr<mmap_log_reader> mapped_log)
+    : parser(logger)
+    , _example_joiner(std::move(joiner))
+    , _mapped_log(std::move(mapped_log))
+    , _payload(nullptr)
+    , _payload_size(0)
+    , _total_size_read(0)
 {
 }
 
@@ -107,9 +114,14 @@ bool binary_parser::read_version(io_buf& input)
   _total_size_read += buffer_length;
   _payload_size = 0;  // this is used but the padding code, make it do the right thing.
 
-  if (*_payload != BINARY_PARSER_VERSION)
+  return check_version(_payload);
+}
+
+bool binary_parser::check_version(const char* payload)
+{
+  if (*payload != BINARY_PARSER_VERSION)
   {
-    logger.out_critical("File version [{}] does not match the parser version [{}]", static_cast<size_t>(*_payload),
+    logger.out_critical("File version [{}] does not match the parser version [{}]", static_cast<size_t>(*payload),
         BINARY_PARSER_VERSION);
     return false;
   }
@@ -179,6 +191,14 @@ bool binary_parser::skip_over_unknown_payload(io_buf& input)
 }
 
 bool binary_parser::read_checkpoint_msg(io_buf& input)
+{
+  if (!read_checkpoint_payload(input)) { return false; }
+
+  apply_checkpoint(_payload);
+  return true;
+}
+
+bool binary_parser::read_checkpoint_payload(io_buf& input)
 {
   _payload = nullptr;
   if (!read_payload_size(input, _payload_size))
@@ -202,24 +222,63 @@ bool binary_parser::read_checkpoint_msg(io_buf& input)
   }
 
   _total_size_read += _payload_size;
+  return true;
+}
 
+void binary_parser::apply_checkpoint(const char* payload)
+{
   // TODO: fb verification: what if verification fails, crash or default to
   // something sensible?
-  auto checkpoint_info = flatbuffers::GetRoot<v2::CheckpointInfo>(_payload);
+  auto checkpoint_info = flatbuffers::GetRoot<v2::CheckpointInfo>(payload);
   _example_joiner->set_reward_function(checkpoint_info->reward_function_type());
   _example_joiner->set_default_reward(checkpoint_info->default_reward());
   _example_joiner->set_learning_mode_config(checkpoint_info->learning_mode_config());
   _example_joiner->set_problem_type_config(checkpoint_info->problem_type_config());
   _example_joiner->set_use_client_time(checkpoint_info->use_client_time());
-
-  return true;
 }
 
 bool binary_parser::read_regular_msg(io_buf& input, VW::multi_ex& examples, bool& ignore_msg)
 {
-  _payload = nullptr;
   ignore_msg = false;
 
+  if (!read_regular_payload(input)) { return false; }
+
+  return process_regular_payload(_payload, _payload_size, examples, ignore_msg);
+}
+
+bool binary_parser::process_regular_payload(
+    const char* payload, uint32_t payload_size, VW::multi_ex& examples, bool& ignore_msg)
+{
+  ignore_msg = false;
+
+  if (!_example_joiner->joiner_ready())
+  {
+    logger.out_warn(
+        "Read regular message before any checkpoint data "
+        "after having read [{}] bytes from the file. Events will be ignored.",
+        _total_size_read);
+    ignore_msg = true;
+    return true;
+  }
+
+  auto joined_payload = flatbuffers::GetRoot<v2::JoinedPayload>(payload);
+  auto verifier = flatbuffers::Verifier(reinterpret_cast<const uint8_t*>(payload), static_cast<size_t>(payload_size));
+  if (!joined_payload->Verify(verifier))
+  {
+    logger.out_warn(
+        "JoinedPayload of size [{}] verification failed after having read [{}] "
+        "bytes from the file, skipping JoinedPayload",
+        payload_size, _total_size_read);
+    return false;
+  }
+
+  return join_payload(*joined_payload, examples, _total_size_read);
+}
+
+bool binary_parser::read_regular_payload(io_buf& input)
+{
+  _payload = nullptr;
+
   if (!read_payload_size(input, _payload_size))
   {
     logger.out_warn(
@@ -242,30 +301,14 @@ bool binary_parser::read_regular_msg(io_buf& input, VW::multi_ex& examples, bool
   }
 
   _total_size_read += _payload_size;
+  return true;
+}
 
-  if (!_example_joiner->joiner_ready())
-  {
-    logger.out_warn(
-        "Read regular message before any checkpoint data "
-        "after having read [{}] bytes from the file. Events will be ignored.",
-        _total_size_read);
-    ignore_msg = true;
-    return true;
-  }
-
-  auto joined_payload = flatbuffers::GetRoot<v2::JoinedPayload>(_payload);
-  auto verifier = flatbuffers::Verifier(reinterpret_cast<const uint8_t*>(_payload), static_cast<size_t>(_payload_size));
-  if (!joined_payload->Verify(verifier))
-  {
-    logger.out_warn(
-        "JoinedPayload of size [{}] verification failed after having read [{}] "
-        "bytes from the file, skipping JoinedPayload",
-        _payload_size, _total_size_read);
-    return false;
-  }
+bool binary_parser::join_payload(const v2::JoinedPayload& joined_payload, VW::multi_ex& examples, uint64_t bytes_read)
+{
   _example_joiner->on_new_batch();
 
-  for (const auto* event : *joined_payload->events())
+  for (const auto* event : *joined_payload.events())
   {
     // process and group events in batch
     if (!_example_joiner->process_event(*event))
@@ -274,7 +317,7 @@ bool binary_parser::read_regular_msg(io_buf& input, VW::multi_ex& examples, bool
           "Processing of an event from JoinedPayload "
           "failed after having read [{}] "
           "bytes from the file, skipping JoinedPayload",
-          _total_size_read);
+          bytes_read);
       return false;
     }
   }
@@ -333,9 +376,74 @@ bool binary_parser::advance_to_next_payload_type(io_buf& input, unsigned int& pa
 
 void binary_parser::persist_metrics(metric_sink&) { _example_joiner->persist_metrics(); }
 
+void binary_parser::warn_unknown_payload(unsigned int payload_type)
+{
+  logger.out_warn(
+      "Payload type not recognized [0x{:x}], after having read [{}] "
+      "bytes from the file, attempting to skip payload",
+      payload_type, _total_size_read);
+}
+
+void binary_parser::report_truncated_mapped_log()
+{
+  if (!_mapped_log->truncated()) { return; }
+
+  logger.out_critical(
+      "Failed to read the next message of the mapped log, after having read "
+      "[{}] bytes from the file",
+      _mapped_log->bytes_read());
+}
+
+bool binary_parser::parse_mapped_examples(VW::multi_ex& examples)
+{
+  // the messages are read in place, there is no payload type to advance to or padding to skip
+  mmap_log_reader::message msg;
+  while (_mapped_log->next(msg))
+  {
+    _total_size_read = _mapped_log->bytes_read();
+    switch (msg.type)
+    {
+      case MSG_TYPE_FILEMAGIC:
+      {
+        if (!check_version(msg.payload)) { return false; }
+        break;
+      }
+      case MSG_TYPE_HEADER:
+      {
+        // TODO:: consume header
+        break;
+      }
+      case MSG_TYPE_CHECKPOINT:
+      {
+        apply_checkpoint(msg.payload);
+        break;
+      }
+      case MSG_TYPE_REGULAR:
+      {
+        bool ignore_msg = false;
+        if (process_regular_payload(msg.payload, msg.size, examples, ignore_msg))
+        {
+          if (!ignore_msg) { return true; }
+        }
+        break;
+      }
+
+      default:
+      {
+        warn_unknown_payload(msg.type);
+        break;
+      }
+    }
+  }
+
+  report_truncated_mapped_log();
+  return false;
+}
+
 bool binary_parser::parse_examples(VW::workspace*, io_buf& io_buf, VW::multi_ex& examples)
 {
   if (process_next_in_batch(examples)) { return true; }
+  if (_mapped_log) { return parse_mapped_examples(examples); }
 
   unsigned int payload_type;
   while (advance_to_next_payload_type(io_buf, payload_type))
@@ -373,10 +481,7 @@ bool binary_parser::parse_examples(VW::workspace*, io_buf& io_buf, VW::multi_ex&
 
       default:
       {
-        logger.out_warn(
-            "Payload type not recognized [0x{:x}], after having read [{}] "
-            "bytes from the file, attempting to skip payload",
-            payload_type, _total_size_read);
+        warn_unknown_payload(payload_type);
         if (!skip_over_unknown_payload(io_buf)) { return false; }
         continue;
       }
@@ -15,6 +15,8 @@ constexpr unsigned int MSG_TYPE_REGULAR = 0xFFFFFFFF;
 constexpr unsigned int MSG_TYPE_CHECKPOINT = 0x11111111;
 constexpr unsigned int MSG_TYPE_EOF = 0xAAAAAAAA;
 
+class mmap_log_reader;
+
 namespace VW
 {
 namespace external
@@ -22,7 +24,9 @@ namespace external
 class binary_parser : public parser
 {
 public:
-  binary_parser(std::unique_ptr<i_joiner>&& joiner, VW::io::logger logger);  // taking ownership of joiner
+  // taking ownership of joiner, the log is read from mapped_log instead of the io_buf when there is one
+  binary_parser(std::unique_ptr<i_joiner>&& joiner, VW::io::logger logger,
+      std::unique_ptr<mmap_log_reader> mapped_log = nullptr);
   ~binary_parser();
   bool parse_examples(VW::workspace* all, io_buf& io_buf, VW::multi_ex& examples) override;
   bool read_version(io_buf& input);
@@ -33,9 +37,24 @@ public:
   bool advance_to_next_payload_type(io_buf& input, unsigned int& payload_type);
   void persist_metrics(metric_sink& metrics) override;
 
-private:
+protected:
+  // read the size and the payload of a message, _payload points into the io_buf until the next read
+  bool read_checkpoint_payload(io_buf& input);
+  bool read_regular_payload(io_buf& input);
+  bool check_version(const char* payload);
+  void apply_checkpoint(const char* payload);
+  // verifies and joins a regular message, ignore_msg is set when no checkpoint was read yet
+  bool process_regular_payload(const char* payload, uint32_t payload_size, VW::multi_ex& examples, bool& ignore_msg);
+  // groups the events of a verified JoinedPayload and returns the first examples of the batch, if any
+  bool join_payload(const v2::JoinedPayload& joined_payload, VW::multi_ex& examples, uint64_t bytes_read);
   bool process_next_in_batch(VW::multi_ex& examples);
+  bool parse_mapped_examples(VW::multi_ex& examples);
+  void warn_unknown_payload(unsigned int payload_type);
+  // logs it if the mapped log ended in the middle of a message
+  void report_truncated_mapped_log();
+
   std::unique_ptr<i_joiner> _example_joiner;
+  std::unique_ptr<mmap_log_reader> _mapped_log;
   char* _payload;
   uint32_t _payload_size;
   uint64_t _total_size_read;
@@ -4,8 +4,10 @@
 
 #include "joiners/example_joiner.h"
 #include "joiners/multistep_example_joiner.h"
+#include "mmap_log_reader.h"
 #include "parse_example_binary.h"
 #include "parse_example_converter.h"
+#include "parse_example_parallel.h"
 #include "utils.h"
 #include "vw/core/metric_sink.h"
 #include "vw/core/parse_args.h"
@@ -109,7 +111,23 @@ std::unique_ptr<parser> parser::get_external_parser(VW::workspace* all, const pa
     if (all->options->was_supplied("extra_metrics"))
     { all->example_parser->metrics = VW::make_unique<dsjson_metrics>(); }
 
-    return VW::make_unique<binary_parser>(std::move(joiner), all->logger);
+    std::unique_ptr<mmap_log_reader> mapped_log;
+    if (parsed_options.mmap_input)
+    {
+      if (all->data_filename.empty()) { throw std::runtime_error("--mmap_input needs the log to be passed with -d"); }
+      if (mmap_log_reader::supported()) { mapped_log = VW::make_unique<mmap_log_reader>(all->data_filename); }
+      else
+      {
+        all->logger.out_warn("Memory mapped input is not supported on this platform, reading the log from the input");
+      }
+    }
+
+    if (parsed_options.parser_threads > 0)
+    {
+      return VW::make_unique<parallel_binary_parser>(std::move(joiner), all->logger, parsed_options.parser_threads,
+          parsed_options.zstd_dictionaries, std::move(mapped_log));
+    }
+    return VW::make_unique<binary_parser>(std::move(joiner), all->logger, std::move(mapped_log));
   }
   throw std::runtime_error("external parser type not recognised");
 }
@@ -137,7 +155,17 @@ void parser::set_parse_args(VW::config::option_group_definition& in_options, par
       .add(VW::config::make_option("reward_function", parsed_options.reward_function)
                .help("Override the reward function to be used, valid values: earliest, average, median, sum, min, max"))
       .add(VW::config::make_option("learning_mode", parsed_options.learning_mode)
-               .help("Override the learning mode from the file, valid values: Online, Apprentice, LoggingOnly"));
+               .help("Override the learning mode from the file, valid values: Online, Apprentice, LoggingOnly"))
+      .add(VW::config::make_option("zstd_dictionary", parsed_options.zstd_dictionaries)
+               .help("zstd dictionary the events were compressed with, repeat it to load the dictionaries of all the "
+                     "client versions in the log"))
+      .add(VW::config::make_option("parser_threads", parsed_options.parser_threads)
+               .default_value(0)
+               .help("Verify and decompress the checkpoint delimited segments of the log on this many threads, "
+                     "examples are still joined in file order. 0 reads the log on the parse thread only"))
+      .add(VW::config::make_option("mmap_input", parsed_options.mmap_input)
+               .help("Memory map the data file and read its messages in place instead of copying them through the "
+                     "input buffer"));
 }
 
 void parser::persist_metrics(metric_sink& metric_sink) { metric_sink.set_uint("external_parser", 1); }
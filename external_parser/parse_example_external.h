@@ -25,6 +25,9 @@ struct parser_options
   std::string reward_function;
   std::string learning_mode;
   bool use_client_time;
+  std::vector<std::string> zstd_dictionaries;
+  int parser_threads;
+  bool mmap_input;
 };
 
 int parse_examples(VW::workspace* all, io_buf& io_buf, VW::multi_ex& examples);
@@ -0,0 +1,261 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "parse_example_parallel.h"
+
+#include "flatbuffers/flatbuffers.h"
+#include "generated/v2/Event_generated.h"
+#include "mmap_log_reader.h"
+#include "vw/core/memory.h"
+#include "vw/io/logger.h"
+
+namespace VW
+{
+namespace external
+{
+parallel_binary_parser::parallel_binary_parser(std::unique_ptr<i_joiner>&& joiner, VW::io::logger logger,
+    int threads, const std::vector<std::string>& zstd_dictionary_paths, std::unique_ptr<mmap_log_reader> mapped_log)
+    : binary_parser(std::move(joiner), std::move(logger), std::move(mapped_log))
+    , _max_segments(2 * static_cast<size_t>(threads))
+{
+  for (int i = 0; i < threads; ++i)
+  {
+    auto dictionaries = VW::make_unique<zstd_dictionaries>();
+    for (const auto& path : zstd_dictionary_paths) { dictionaries->load(path); }
+    _dictionaries.push_back(std::move(dictionaries));
+  }
+  for (auto& dictionaries : _dictionaries)
+  {
+    auto* worker_dictionaries = dictionaries.get();
+    _workers.emplace_back([this, worker_dictionaries]() { worker(*worker_dictionaries); });
+  }
+}
+
+parallel_binary_parser::~parallel_binary_parser()
+{
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _stop = true;
+    _pending.clear();
+  }
+  _cv.notify_all();
+  for (auto& worker : _workers) { worker.join(); }
+}
+
+void parallel_binary_parser::worker(zstd_dictionaries& dictionaries)
+{
+  while (true)
+  {
+    std::shared_ptr<segment> seg;
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _cv.wait(lock, [this]() { return _stop || !_pending.empty(); });
+      if (_stop) { return; }
+      seg = std::move(_pending.front());
+      _pending.pop_front();
+    }
+
+    try
+    {
+      decode_segment(*seg, dictionaries);
+      seg->decoded.set_value();
+    }
+    catch (...)
+    {
+      seg->decoded.set_exception(std::current_exception());
+    }
+  }
+}
+
+void parallel_binary_parser::decode_segment(segment& seg, zstd_dictionaries& dictionaries)
+{
+  for (auto& msg : seg.messages)
+  {
+    if (msg.type != MSG_TYPE_REGULAR) { continue; }
+
+    const auto* data = reinterpret_cast<const uint8_t*>(msg.payload);
+    auto verifier = flatbuffers::Verifier(data, msg.size);
+    const auto* joined_payload = flatbuffers::GetRoot<v2::JoinedPayload>(data);
+    msg.verified = joined_payload->Verify(verifier);
+    if (!msg.verified) { continue; }
+
+    for (const auto* joined_event : *joined_payload->events())
+    {
+      if (joined_event->event() == nullptr) { continue; }
+      const auto* event = flatbuffers::GetRoot<v2::Event>(joined_event->event()->data());
+      if (event->meta() == nullptr || event->payload() == nullptr ||
+          event->meta()->encoding() != v2::EventEncoding_Zstd)
+      { continue; }
+
+      // the events that fail here are decompressed again by the joiner, which reports the error
+      std::vector<uint8_t> buffer;
+      if (dictionaries.decompress_frame(event->payload()->data(), event->payload()->size(), buffer))
+      { seg.payloads.emplace(event->payload()->data(), std::move(buffer)); }
+    }
+  }
+}
+
+bool parallel_binary_parser::read_segment(io_buf& input, segment& seg)
+{
+  if (_mapped_log) { return read_mapped_segment(seg); }
+
+  size_t regular_messages = 0;
+  unsigned int payload_type;
+  while (advance_to_next_payload_type(input, payload_type))
+  {
+    switch (payload_type)
+    {
+      case MSG_TYPE_FILEMAGIC:
+      {
+        if (!read_version(input)) { return false; }
+        break;
+      }
+      case MSG_TYPE_HEADER:
+      {
+        if (!read_header(input)) { return false; }
+        break;
+      }
+      case MSG_TYPE_CHECKPOINT:
+      {
+        if (!read_checkpoint_payload(input)) { return false; }
+        seg.messages.emplace_back(payload_type, _payload, _payload_size, _total_size_read, true);
+        // checkpoints are the recommended split points of a log
+        return true;
+      }
+      case MSG_TYPE_REGULAR:
+      {
+        if (!read_regular_payload(input)) { break; }
+        seg.messages.emplace_back(payload_type, _payload, _payload_size, _total_size_read, true);
+        if (++regular_messages == MAX_SEGMENT_MESSAGES) { return true; }
+        break;
+      }
+      case MSG_TYPE_EOF:
+      {
+        return false;
+      }
+
+      default:
+      {
+        warn_unknown_payload(payload_type);
+        if (!skip_over_unknown_payload(input)) { return false; }
+        continue;
+      }
+    }
+  }
+
+  return false;
+}
+
+bool parallel_binary_parser::read_mapped_segment(segment& seg)
+{
+  size_t regular_messages = 0;
+  mmap_log_reader::message msg;
+  while (_mapped_log->next(msg))
+  {
+    _total_size_read = _mapped_log->bytes_read();
+    switch (msg.type)
+    {
+      case MSG_TYPE_FILEMAGIC:
+      {
+        if (!check_version(msg.payload)) { return false; }
+        break;
+      }
+      case MSG_TYPE_HEADER:
+      {
+        break;
+      }
+      case MSG_TYPE_CHECKPOINT:
+      {
+        seg.messages.emplace_back(msg.type, msg.payload, msg.size, _total_size_read, !msg.in_place);
+        return true;
+      }
+      case MSG_TYPE_REGULAR:
+      {
+        seg.messages.emplace_back(msg.type, msg.payload, msg.size, _total_size_read, !msg.in_place);
+        if (++regular_messages == MAX_SEGMENT_MESSAGES) { return true; }
+        break;
+      }
+
+      default:
+      {
+        warn_unknown_payload(msg.type);
+        break;
+      }
+    }
+  }
+
+  report_truncated_mapped_log();
+  return false;
+}
+
+void parallel_binary_parser::read_ahead(io_buf& input)
+{
+  while (!_end_of_input && _segments.size() < _max_segments)
+  {
+    auto seg = std::make_shared<segment>();
+    _end_of_input = !read_segment(input, *seg);
+    if (seg->messages.empty()) { continue; }
+
+    _segments.push_back(seg);
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _pending.push_back(std::move(seg));
+    }
+    _cv.notify_one();
+  }
+}
+
+bool parallel_binary_parser::parse_examples(VW::workspace*, io_buf& io_buf, VW::multi_ex& examples)
+{
+  if (process_next_in_batch(examples)) { return true; }
+
+  while (true)
+  {
+    read_ahead(io_buf);
+    if (_segments.empty()) { return false; }
+
+    auto& seg = *_segments.front();
+    // rethrows what the worker failed with
+    seg.ready.get();
+
+    while (_next_message < seg.messages.size())
+    {
+      const auto& msg = seg.messages[_next_message++];
+      if (msg.type == MSG_TYPE_CHECKPOINT)
+      {
+        apply_checkpoint(msg.payload);
+        continue;
+      }
+
+      if (!_example_joiner->joiner_ready())
+      {
+        logger.out_warn(
+            "Read regular message before any checkpoint data "
+            "after having read [{}] bytes from the file. Events will be ignored.",
+            msg.bytes_read);
+        continue;
+      }
+
+      if (!msg.verified)
+      {
+        logger.out_warn(
+            "JoinedPayload of size [{}] verification failed after having read [{}] "
+            "bytes from the file, skipping JoinedPayload",
+            msg.size, msg.bytes_read);
+        continue;
+      }
+
+      _example_joiner->set_decompressed_payloads(&seg.payloads);
+      if (join_payload(*flatbuffers::GetRoot<v2::JoinedPayload>(msg.payload), examples, msg.bytes_read))
+      { return true; }
+    }
+
+    // every batch of the segment has been processed
+    _example_joiner->set_decompressed_payloads(nullptr);
+    _segments.pop_front();
+    _next_message = 0;
+  }
+}
+}  // namespace external
+}  // namespace VW
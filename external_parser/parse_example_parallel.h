@@ -0,0 +1,103 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#pragma once
+
+#include "parse_example_binary.h"
+#include "zstd_dictionaries.h"
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// regular messages after which a segment is cut when no checkpoint came first
+constexpr size_t MAX_SEGMENT_MESSAGES = 16;
+
+namespace VW
+{
+namespace external
+{
+/*
+Parallel binary parser
+The log is cut into segments that end at each checkpoint message, or after
+MAX_SEGMENT_MESSAGES regular messages. The parse thread only copies the
+segments out of the input, or points into the mapped log, a pool of workers verifies their JoinedPayloads and
+decompresses their events a few segments ahead of the joiner. The segments are
+then joined and turned into examples on the parse thread in file order, since
+building examples needs the workspace, so the examples are the same as the
+ones of binary_parser.
+*/
+class parallel_binary_parser : public binary_parser
+{
+public:
+  // taking ownership of joiner, every worker loads its own copy of the zstd dictionaries
+  parallel_binary_parser(std::unique_ptr<i_joiner>&& joiner, VW::io::logger logger, int threads,
+      const std::vector<std::string>& zstd_dictionary_paths, std::unique_ptr<mmap_log_reader> mapped_log = nullptr);
+  ~parallel_binary_parser();
+  bool parse_examples(VW::workspace* all, io_buf& io_buf, VW::multi_ex& examples) override;
+
+private:
+  struct message
+  {
+    // the payload is copied unless it stays valid for the lifetime of the parser
+    message(unsigned int type, const char* data, uint32_t size, uint64_t bytes_read, bool copy)
+        : type(type), payload(data), size(size), bytes_read(bytes_read)
+    {
+      if (copy)
+      {
+        storage.assign(data, data + size);
+        payload = storage.data();
+      }
+    }
+    message(const message&) = delete;
+    message(message&&) = default;
+
+    unsigned int type;
+    const char* payload;
+    uint32_t size;
+    std::vector<char> storage;
+    // bytes read from the file at the end of the message, for the logs
+    uint64_t bytes_read;
+    bool verified = false;
+  };
+
+  struct segment
+  {
+    segment() : ready(decoded.get_future().share()) {}
+
+    std::vector<message> messages;
+    // zstd payloads of the events of all the messages, decompressed by the worker
+    decompressed_payloads payloads;
+    std::promise<void> decoded;
+    std::shared_future<void> ready;
+  };
+
+  // returns false once there is nothing left to read
+  bool read_segment(io_buf& input, segment& seg);
+  bool read_mapped_segment(segment& seg);
+  void read_ahead(io_buf& input);
+  void decode_segment(segment& seg, zstd_dictionaries& dictionaries);
+  void worker(zstd_dictionaries& dictionaries);
+
+  std::vector<std::unique_ptr<zstd_dictionaries>> _dictionaries;
+  std::vector<std::thread> _workers;
+  std::mutex _mutex;
+  std::condition_variable _cv;
+  // segments waiting for a worker
+  std::deque<std::shared_ptr<segment>> _pending;
+  bool _stop = false;
+
+  // segments read ahead in file order, only touched by the parse thread
+  std::deque<std::shared_ptr<segment>> _segments;
+  size_t _next_message = 0;
+  const size_t _max_segments;
+  bool _end_of_input = false;
+};
+}  // namespace external
+}  // namespace VW
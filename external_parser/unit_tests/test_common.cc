@@ -1,38 +1,12 @@
 #include "test_common.h"
 
+#include "event_batch_reader.h"
 #include "vw/core/learner.h"
 #include "vw/core/parser.h"
 #include "vw/io/io_adapter.h"
 
 namespace v2 = reinforcement_learning::messages::flatbuff::v2;
 
-namespace endian
-{
-bool is_big_endian(void)
-{
-  const union
-  {
-    std::uint32_t i;
-    char c[4];
-  } b_int{0x01000000};
-  return b_int.c[0] == 1;
-}
-
-uint32_t from_network_order(std::uint32_t net_l)
-{
-  if (is_big_endian()) { return net_l; }
-
-  uint32_t ret_val;
-  uint8_t* p_ret_raw = (uint8_t*)&ret_val;
-  uint8_t* p_raw = (uint8_t*)&net_l;
-  p_ret_raw[0] = p_raw[3];
-  p_ret_raw[1] = p_raw[2];
-  p_ret_raw[2] = p_raw[1];
-  p_ret_raw[3] = p_raw[0];
-  return ret_val;
-}
-}  // end of namespace endian
-
 void set_slates_label(VW::multi_ex& examples)
 {
   examples[0]->pred.decision_scores.resize(2);
@@ -95,31 +69,20 @@ std::string get_test_files_location()
   }
 }
 
-uint32_t get_payload_size(std::vector<char>& buffer)
-{
-  std::vector<char> size_buffer = {buffer.begin() + 4, buffer.begin() + 8};
-  return endian::from_network_order(*reinterpret_cast<const uint32_t*>(size_buffer.data()));
-}
-
 std::vector<const v2::JoinedEvent*> wrap_into_joined_events(
     std::vector<char>& buffer, std::vector<flatbuffers::DetachedBuffer>& detached_buffers)
 {
-  const int PREAMBLE_LENGTH = 8;
   // if file is smaller than preamble size then fail
-  BOOST_REQUIRE_GT(buffer.size(), PREAMBLE_LENGTH);
+  const size_t preamble_size = event_batch_reader::PREAMBLE_SIZE;
+  BOOST_REQUIRE_GT(buffer.size(), preamble_size);
 
   flatbuffers::FlatBufferBuilder fbb;
   std::vector<const v2::JoinedEvent*> event_list{};
   size_t event_index = 0;
 
-  while (buffer.size() > PREAMBLE_LENGTH)
+  event_batch_reader reader(buffer.data(), buffer.size());
+  while (const auto* event_batch = reader.next())
   {
-    uint32_t payload_size = get_payload_size(buffer);
-    // throw away first 8 bytes as they contain preamble (todo maybe verify
-    // preamble)
-    std::vector<char> event_batch_buffer = {
-        buffer.begin() + PREAMBLE_LENGTH, buffer.begin() + PREAMBLE_LENGTH + payload_size};
-    auto event_batch = v2::GetEventBatch(event_batch_buffer.data());
     BOOST_REQUIRE_GE(event_batch->events()->size(), 1);
 
     int day = 30;
@@ -141,8 +104,6 @@ std::vector<const v2::JoinedEvent*> wrap_into_joined_events(
       event_list.push_back(je);
       event_index++;
     }
-
-    buffer = {buffer.begin() + PREAMBLE_LENGTH + payload_size, buffer.end()};
   }
 
   return event_list;
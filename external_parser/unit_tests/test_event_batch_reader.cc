@@ -0,0 +1,90 @@
+#include <boost/test/unit_test.hpp>
+
+#include "event_batch_reader.h"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+flatbuffers::DetachedBuffer make_batch(const std::vector<std::string>& payloads)
+{
+  flatbuffers::FlatBufferBuilder fbb;
+  std::vector<flatbuffers::Offset<v2::SerializedEvent>> events;
+  for (const auto& payload : payloads)
+  {
+    const auto data = fbb.CreateVector(reinterpret_cast<const uint8_t*>(payload.data()), payload.size());
+    events.push_back(v2::CreateSerializedEvent(fbb, data));
+  }
+  fbb.Finish(v2::CreateEventBatchDirect(fbb, &events));
+  return fbb.Release();
+}
+
+// appends a message the way the client senders write it
+void append_message(std::vector<char>& out, uint8_t encoding, const char* body, size_t size)
+{
+  const auto body_size = static_cast<uint32_t>(size);
+  const char preamble[] = {static_cast<char>(encoding), 0, 0, 13, static_cast<char>(body_size >> 24),
+      static_cast<char>(body_size >> 16), static_cast<char>(body_size >> 8), static_cast<char>(body_size)};
+  out.insert(out.end(), preamble, preamble + sizeof(preamble));
+  out.insert(out.end(), body, body + size);
+}
+
+std::string payload_of(const v2::EventBatch* batch, flatbuffers::uoffset_t i)
+{
+  const auto* payload = batch->events()->Get(i)->payload();
+  return std::string(reinterpret_cast<const char*>(payload->data()), payload->size());
+}
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(test_read_identity_and_compressed_batches)
+{
+  const auto identity = make_batch({"first", "second"});
+  const auto batch = make_batch({"third", "third", "third", "third"});
+  std::vector<char> compressed(ZSTD_compressBound(batch.size()));
+  const auto compressed_size = ZSTD_compress(compressed.data(), compressed.size(), batch.data(), batch.size(), 1);
+  BOOST_REQUIRE(!ZSTD_isError(compressed_size));
+
+  std::vector<char> file;
+  append_message(file, event_batch_reader::CONTENT_ENCODING_IDENTITY, reinterpret_cast<const char*>(identity.data()),
+      identity.size());
+  append_message(file, event_batch_reader::CONTENT_ENCODING_ZSTD, compressed.data(), compressed_size);
+
+  event_batch_reader reader(file.data(), file.size());
+  const auto* first = reader.next();
+  BOOST_REQUIRE(first != nullptr);
+  BOOST_CHECK_EQUAL(first->events()->size(), 2);
+  BOOST_CHECK_EQUAL(payload_of(first, 1), "second");
+
+  const auto* second = reader.next();
+  BOOST_REQUIRE(second != nullptr);
+  BOOST_CHECK_EQUAL(second->events()->size(), 4);
+  BOOST_CHECK_EQUAL(payload_of(second, 3), "third");
+
+  BOOST_CHECK(reader.next() == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(test_read_malformed_batches)
+{
+  const auto batch = make_batch({"first"});
+
+  std::vector<char> truncated;
+  append_message(truncated, event_batch_reader::CONTENT_ENCODING_IDENTITY, reinterpret_cast<const char*>(batch.data()),
+      batch.size());
+  truncated.pop_back();
+  event_batch_reader truncated_reader(truncated.data(), truncated.size());
+  BOOST_CHECK_THROW(truncated_reader.next(), std::runtime_error);
+
+  // claims to be compressed but is not a zstd frame
+  std::vector<char> not_compressed;
+  append_message(not_compressed, event_batch_reader::CONTENT_ENCODING_ZSTD,
+      reinterpret_cast<const char*>(batch.data()), batch.size());
+  event_batch_reader not_compressed_reader(not_compressed.data(), not_compressed.size());
+  BOOST_CHECK_THROW(not_compressed_reader.next(), std::runtime_error);
+
+  std::vector<char> unknown;
+  append_message(unknown, 42, reinterpret_cast<const char*>(batch.data()), batch.size());
+  event_batch_reader unknown_reader(unknown.data(), unknown.size());
+  BOOST_CHECK_THROW(unknown_reader.next(), std::runtime_error);
+}
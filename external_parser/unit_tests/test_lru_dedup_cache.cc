@@ -132,4 +132,39 @@ BOOST_AUTO_TEST_CASE(test_lru_update)
 
   clear_examples(examples, vw.get());
   VW::finish(*vw, false);
-}
\ No newline at end of file
+}
+
+BOOST_AUTO_TEST_CASE(test_lru_remove)
+{
+  auto options = VW::make_unique<VW::config::options_cli>(
+      std::vector<std::string>{"--quiet", "--binary_parser", "--cb_explore_adf"});
+  auto vw = VW::external::initialize_with_binary_parser(std::move(options));
+
+  VW::multi_ex examples;
+  examples.push_back(VW::new_unused_example(*vw));
+  examples.push_back(VW::new_unused_example(*vw));
+  uint64_t dedup_id_0 = 0;
+  uint64_t dedup_id_1 = 1;
+
+  lru_dedup_cache dedup_cache;
+
+  dedup_cache.add(dedup_id_0, examples[0]);
+  dedup_cache.add(dedup_id_1, examples[1]);
+
+  // removing an item leaves the others in place
+  BOOST_CHECK_EQUAL(dedup_cache.remove(dedup_id_0), true);
+  BOOST_CHECK_EQUAL(dedup_cache.exists(dedup_id_0), false);
+  BOOST_CHECK_EQUAL(dedup_cache.exists(dedup_id_1), true);
+  BOOST_CHECK_EQUAL(dedup_cache.dedup_examples.size(), 1);
+  BOOST_CHECK_EQUAL(dedup_cache.lru.size(), 1);
+
+  // unknown items are ignored
+  BOOST_CHECK_EQUAL(dedup_cache.remove(dedup_id_0), false);
+
+  // the lru order is still consistent
+  dedup_cache.clear_after(dedup_id_1);
+  BOOST_CHECK_EQUAL(dedup_cache.exists(dedup_id_1), true);
+
+  clear_examples(examples, vw.get());
+  VW::finish(*vw, false);
+}
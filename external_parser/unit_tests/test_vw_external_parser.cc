@@ -1,5 +1,6 @@
 #include <boost/test/unit_test.hpp>
 
+#include "mmap_log_reader.h"
 #include "parse_example_external.h"
 #include "test_common.h"
 #include "vw/config/options_cli.h"
@@ -1140,3 +1141,136 @@ BOOST_AUTO_TEST_CASE(multistep_2_episodes_suffix_sum)
   clear_examples(examples, vw.get());
   VW::finish(*vw, false);
 }
+
+void generate_fb_model(const std::string& model_file, const std::string& vw_args, const std::string& log_file)
+{
+  std::remove(model_file.c_str());
+
+  auto options = VW::make_unique<VW::config::options_cli>(
+      VW::split_command_line(vw_args + " --binary_parser --quiet -f " + model_file + " -d " + log_file));
+  auto vw = VW::external::initialize_with_binary_parser(std::move(options));
+
+  VW::start_parser(*vw);
+  VW::LEARNER::generic_driver(*vw);
+  VW::end_parser(*vw);
+
+  VW::finish(*vw, false);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_parser_models_match_single_threaded)
+{
+  std::string input_files = get_test_files_location();
+
+  std::string model_name = input_files + "/test_outputs/m_parallel";
+
+  const std::vector<std::pair<std::string, std::string>> logs = {
+      {"--cb_explore_adf", "/valid_joined_logs/average_reward_100_interactions.fb"},
+      {"--ccb_explore_adf", "/valid_joined_logs/ccb_sum_reward_100_interactions.fb"},
+      {"--ccb_explore_adf --slates", "/valid_joined_logs/slates_average_reward_100_interactions.fb"},
+      {"--cb_explore_adf --multistep", "/valid_joined_logs/multistep_2_episodes.fb"}};
+
+  for (const auto& log : logs)
+  {
+    generate_fb_model(model_name + ".single", log.first, input_files + log.second);
+    generate_fb_model(model_name + ".parallel", log.first + " --parser_threads 3", input_files + log.second);
+
+    auto single_threaded_model = read_file(model_name + ".single");
+    auto parallel_model = read_file(model_name + ".parallel");
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+        single_threaded_model.begin(), single_threaded_model.end(), parallel_model.begin(), parallel_model.end());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(parallel_parser_dedup_compressed)
+{
+  std::string input_files = get_test_files_location();
+
+  auto buffer = read_file(input_files + "/valid_joined_logs/cb_dedup_compressed.log");
+
+  // the events are zstd compressed and deduplicated, so the joiner uses the payloads decompressed by the workers
+  std::vector<size_t> example_sizes[2];
+  for (int parallel = 0; parallel < 2; ++parallel)
+  {
+    auto options = VW::make_unique<VW::config::options_cli>(std::vector<std::string>{
+        "--quiet", "--binary_parser", "--cb_explore_adf", "--parser_threads", parallel != 0 ? "2" : "0"});
+    auto vw = VW::external::initialize_with_binary_parser(std::move(options));
+
+    VW::multi_ex examples;
+    examples.push_back(VW::new_unused_example(*vw));
+    set_buffer_as_vw_input(buffer, vw.get());
+
+    while (vw->example_parser->reader(vw.get(), vw->example_parser->input, examples) > 0)
+    {
+      size_t features = 0;
+      for (const auto* ex : examples) { features += ex->num_features; }
+      example_sizes[parallel].push_back(examples.size());
+      example_sizes[parallel].push_back(features);
+
+      clear_examples(examples, vw.get());
+      examples.push_back(VW::new_unused_example(*vw));
+    }
+
+    clear_examples(examples, vw.get());
+    VW::finish(*vw, false);
+  }
+
+  BOOST_CHECK(!example_sizes[0].empty());
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+      example_sizes[0].begin(), example_sizes[0].end(), example_sizes[1].begin(), example_sizes[1].end());
+}
+
+BOOST_AUTO_TEST_CASE(mmap_input_models_match_io_buf)
+{
+  std::string input_files = get_test_files_location();
+
+  std::string model_name = input_files + "/test_outputs/m_mmap";
+
+  const std::vector<std::pair<std::string, std::string>> logs = {
+      {"--cb_explore_adf", "/valid_joined_logs/average_reward_100_interactions.fb"},
+      {"--ccb_explore_adf", "/valid_joined_logs/ccb_sum_reward_100_interactions.fb"},
+      {"--cb_explore_adf --multistep", "/valid_joined_logs/multistep_2_episodes.fb"},
+      {"--cb_explore_adf", "/valid_joined_logs/cb_dedup_compressed.log"}};
+
+  for (const auto& log : logs)
+  {
+    generate_fb_model(model_name + ".io_buf", log.first, input_files + log.second);
+    generate_fb_model(model_name + ".mmap", log.first + " --mmap_input", input_files + log.second);
+    generate_fb_model(
+        model_name + ".mmap_parallel", log.first + " --mmap_input --parser_threads 2", input_files + log.second);
+
+    auto io_buf_model = read_file(model_name + ".io_buf");
+    auto mmap_model = read_file(model_name + ".mmap");
+    auto mmap_parallel_model = read_file(model_name + ".mmap_parallel");
+    BOOST_CHECK_EQUAL_COLLECTIONS(io_buf_model.begin(), io_buf_model.end(), mmap_model.begin(), mmap_model.end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+        io_buf_model.begin(), io_buf_model.end(), mmap_parallel_model.begin(), mmap_parallel_model.end());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(mmap_log_reader_truncated_log)
+{
+  std::string input_files = get_test_files_location();
+
+  auto buffer = read_file(input_files + "/valid_joined_logs/average_reward_100_interactions.fb");
+  const std::string truncated_log = input_files + "/test_outputs/truncated_log.fb";
+  {
+    std::ofstream out(truncated_log, std::ios::binary);
+    out.write(buffer.data(), buffer.size() - 3);
+  }
+
+  size_t messages = 0;
+  {
+    mmap_log_reader reader(input_files + "/valid_joined_logs/average_reward_100_interactions.fb");
+    mmap_log_reader::message msg;
+    while (reader.next(msg)) { ++messages; }
+    BOOST_CHECK(!reader.truncated());
+    BOOST_CHECK_EQUAL(reader.bytes_read(), buffer.size());
+  }
+
+  mmap_log_reader reader(truncated_log);
+  mmap_log_reader::message msg;
+  size_t truncated_messages = 0;
+  while (reader.next(msg)) { ++truncated_messages; }
+  BOOST_CHECK(reader.truncated());
+  BOOST_CHECK_EQUAL(truncated_messages, messages - 1);
+}
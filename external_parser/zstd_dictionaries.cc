@@ -0,0 +1,48 @@
+#include "zstd_dictionaries.h"
+
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+zstd_dictionaries::zstd_dictionaries() : _dctx(ZSTD_createDCtx()) {}
+
+void zstd_dictionaries::load(const std::string& path)
+{
+  std::ifstream file(path, std::ios::in | std::ios::binary);
+  if (!file.good()) { throw std::runtime_error("Can not open zstd dictionary " + path); }
+  const std::vector<char> dictionary((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+  const auto dictionary_id = ZSTD_getDictID_fromDict(dictionary.data(), dictionary.size());
+  if (dictionary_id == 0)
+  { throw std::runtime_error("zstd dictionary " + path + " has no id, it must be created with zstd --train"); }
+
+  std::unique_ptr<ZSTD_DDict, ddict_deleter> ddict(ZSTD_createDDict(dictionary.data(), dictionary.size()));
+  if (ddict == nullptr) { throw std::runtime_error("Invalid zstd dictionary " + path); }
+  _dictionaries[dictionary_id] = std::move(ddict);
+}
+
+bool zstd_dictionaries::exists(uint32_t dictionary_id) const
+{
+  return _dictionaries.find(dictionary_id) != _dictionaries.end();
+}
+
+size_t zstd_dictionaries::decompress(void* dst, size_t dst_capacity, const void* src, size_t src_size)
+{
+  const auto it = _dictionaries.find(ZSTD_getDictID_fromFrame(src, src_size));
+  if (it != _dictionaries.end())
+  { return ZSTD_decompress_usingDDict(_dctx.get(), dst, dst_capacity, src, src_size, it->second.get()); }
+  return ZSTD_decompressDCtx(_dctx.get(), dst, dst_capacity, src, src_size);
+}
+
+bool zstd_dictionaries::decompress_frame(const void* src, size_t src_size, std::vector<uint8_t>& out)
+{
+  const auto content_size = ZSTD_getFrameContentSize(src, src_size);
+  if (content_size == ZSTD_CONTENTSIZE_ERROR || content_size == ZSTD_CONTENTSIZE_UNKNOWN) { return false; }
+
+  out.resize(static_cast<size_t>(content_size));
+  const auto res = decompress(out.data(), out.size(), src, src_size);
+  if (ZSTD_isError(res)) { return false; }
+  out.resize(res);
+  return true;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "zstd.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+zstd dictionaries
+Events compressed against a pre-trained dictionary carry the dictionary id in
+their zstd frame header. The dictionaries passed on the command line are
+digested once and picked by that id, and one decompression context is reused
+for every event instead of being created per event.
+*/
+class zstd_dictionaries
+{
+public:
+  zstd_dictionaries();
+
+  // throws if the file can't be read or was not created with zstd --train
+  void load(const std::string& path);
+  bool exists(uint32_t dictionary_id) const;
+
+  // same contract as ZSTD_decompress, frames that need a dictionary that was not loaded fail with a zstd error
+  size_t decompress(void* dst, size_t dst_capacity, const void* src, size_t src_size);
+  // decompresses a frame that carries its content size, false if the frame can not be decompressed
+  bool decompress_frame(const void* src, size_t src_size, std::vector<uint8_t>& out);
+
+  zstd_dictionaries(const zstd_dictionaries&) = delete;
+  zstd_dictionaries(zstd_dictionaries&&) = delete;
+  zstd_dictionaries& operator=(const zstd_dictionaries&) = delete;
+  zstd_dictionaries& operator=(zstd_dictionaries&&) = delete;
+
+private:
+  struct dctx_deleter
+  {
+    void operator()(ZSTD_DCtx* ctx) const { ZSTD_freeDCtx(ctx); }
+  };
+  struct ddict_deleter
+  {
+    void operator()(ZSTD_DDict* dict) const { ZSTD_freeDDict(dict); }
+  };
+
+  std::unique_ptr<ZSTD_DCtx, dctx_deleter> _dctx;
+  std::unordered_map<uint32_t, std::unique_ptr<ZSTD_DDict, ddict_deleter>> _dictionaries;
+};
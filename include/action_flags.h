@@ -12,6 +12,8 @@ namespace reinforcement_learning
 enum action_flags
 {
   DEFAULT = 0,
-  DEFERRED = 1
+  DEFERRED = 1,
+  // parse the context in a scratch buffer kept by the model between calls instead of a per-call copy
+  REUSE_CONTEXT_BUFFER = 2
 };
 }
@@ -17,8 +17,13 @@ const char* const MODEL_REFRESH_INTERVAL_MS = "model.refreshintervalms";
 const char* const MODEL_IMPLEMENTATION = "model.implementation";  // VW vs other ML
 const char* const MODEL_BACKGROUND_REFRESH = "model.backgroundrefresh";
 const char* const MODEL_VW_INITIAL_COMMAND_LINE = "model.vw.initial_command_line";
+const char* const MODEL_PASSTHROUGH_PDF_VW_PARSER = "model.passthrough_pdf.vw_parser";
 const char* const VW_CMDLINE = "vw.commandline";
 const char* const VW_POOL_INIT_SIZE = "vw.pool.init.size";
+const char* const VW_POOL_BUILD_THREADS = "vw.pool.build.threads";
+const char* const VW_POOL_SHARE_WEIGHTS = "vw.pool.share_weights";
+const char* const VW_POOL_PIN_PER_THREAD = "vw.pool.pin_per_thread";
+const char* const VW_BATCH_THREADS = "vw.batch.threads";
 const char* const INITIAL_EPSILON = "initial_exploration.epsilon";
 const char* const LEARNING_MODE = "rank.learning.mode";
 const char* const PROTOCOL_VERSION = "protocol.version";
@@ -51,7 +56,12 @@ const char* const INTERACTION_SEND_BATCH_INTERVAL_MS = "interaction.send.batchin
 const char* const INTERACTION_SENDER_IMPLEMENTATION = "interaction.sender.implementation";
 const char* const INTERACTION_USE_COMPRESSION = "interaction.send.use_compression";
 const char* const INTERACTION_USE_DEDUP = "interaction.send.use_dedup";
+const char* const INTERACTION_BATCH_COMPRESSION = "interaction.send.batch_compression";
 const char* const INTERACTION_QUEUE_MODE = "interaction.queue.mode";
+const char* const INTERACTION_QUEUE_IMPLEMENTATION = "interaction.queue.implementation";
+const char* const INTERACTION_QUEUE_RING_BUFFER_SLOTS = "interaction.queue.ring_buffer.slots";
+const char* const INTERACTION_TRANSFORM_MODE = "interaction.transform.mode";
+const char* const INTERACTION_TRANSFORM_THREADS = "interaction.transform.threads";
 const char* const INTERACTION_HTTP_API_HOST = "interaction.http.api.host";
 const char* const INTERACTION_APIM_TASKS_LIMIT = "interaction.apim.tasks_limit";
 const char* const INTERACTION_APIM_MAX_HTTP_RETRIES = "interaction.apim.max_http_retries";
@@ -71,7 +81,10 @@ const char* const OBSERVATION_SEND_QUEUE_MAX_CAPACITY_KB = "observation.send.que
 const char* const OBSERVATION_SEND_BATCH_INTERVAL_MS = "observation.send.batchintervalms";
 const char* const OBSERVATION_SENDER_IMPLEMENTATION = "observation.sender.implementation";
 const char* const OBSERVATION_USE_COMPRESSION = "observation.send.use_compression";
+const char* const OBSERVATION_BATCH_COMPRESSION = "observation.send.batch_compression";
 const char* const OBSERVATION_QUEUE_MODE = "observation.queue.mode";
+const char* const OBSERVATION_QUEUE_IMPLEMENTATION = "observation.queue.implementation";
+const char* const OBSERVATION_QUEUE_RING_BUFFER_SLOTS = "observation.queue.ring_buffer.slots";
 const char* const OBSERVATION_HTTP_API_HOST = "observation.http.api.host";
 const char* const OBSERVATION_APIM_TASKS_LIMIT = "observation.apim.tasks_limit";
 const char* const OBSERVATION_APIM_MAX_HTTP_RETRIES = "observation.apim.max_http_retries";
@@ -84,7 +97,12 @@ const char* const SEND_QUEUE_MAX_CAPACITY_KB = "send.queue.maxcapacity.kb";
 const char* const SEND_BATCH_INTERVAL_MS = "send.batchintervalms";
 const char* const USE_COMPRESSION = "send.use_compression";
 const char* const USE_DEDUP = "send.use_dedup";
+const char* const BATCH_COMPRESSION = "send.batch_compression";  // zstd compress the whole batch body
 const char* const QUEUE_MODE = "queue.mode";
+const char* const QUEUE_IMPLEMENTATION = "queue.implementation";
+const char* const QUEUE_RING_BUFFER_SLOTS = "queue.ring_buffer.slots";
+const char* const TRANSFORM_MODE = "transform.mode";
+const char* const TRANSFORM_THREADS = "transform.threads";
 const char* const SUBSAMPLE_RATE = "subsample.rate";
 const char* const SENDER_IMPLEMENTATION = "sender.implementation";
 
@@ -94,12 +112,19 @@ const char* const EPISODE_FILE_NAME = "episode.file.name";
 const char* const INTERACTION_FILE_NAME = "interaction.file.name";
 const char* const OBSERVATION_FILE_NAME = "observation.file.name";
 const char* const TIME_PROVIDER_IMPLEMENTATION = "time_provider.implementation";
+const char* const EVENT_ID_GENERATOR = "event_id.generator";  // ids of the decisions not given one
 const char* const HTTP_CLIENT_DISABLE_CERT_VALIDATION = "http.certvalidation.disable";
 const char* const HTTP_CLIENT_TIMEOUT = "http.timeout";  // Timeout is in seconds, default is 30.
 const char* const MODEL_FILE_NAME = "model_file_loader.file_name";
 const char* const MODEL_FILE_MUST_EXIST = "model_file_loader.file_must_exist";
+const char* const MODEL_FILE_MMAP = "model_file_loader.mmap";
+const char* const MODEL_FILE_WATCH = "model_file_loader.watch";
 
 const char* const ZSTD_COMPRESSION_LEVEL = "zstd.compression_level";
+const char* const ZSTD_DICTIONARY_FILE = "zstd.dictionary_file";  // trained with zstd --train
+const char* const DEDUP_PERSISTENT = "dedup.persistent";  // keep the dictionary across batches, send only deltas
+const char* const DEDUP_SNAPSHOT_INTERVAL = "dedup.snapshot_interval";  // in batches, 0 disables snapshots
+const char* const DEDUP_EVICTION_BATCHES = "dedup.eviction_batches";    // unused batches before an object is dropped
 }  // namespace name
 }  // namespace reinforcement_learning
 
@@ -125,6 +150,8 @@ const char* const NULL_TRACE_LOGGER = "NULL_TRACE_LOGGER";
 const char* const CONSOLE_TRACE_LOGGER = "CONSOLE_TRACE_LOGGER";
 const char* const NULL_TIME_PROVIDER = "NULL_TIME_PROVIDER";
 const char* const CLOCK_TIME_PROVIDER = "CLOCK_TIME_PROVIDER";
+const char* const EVENT_ID_RANDOM = "RANDOM";
+const char* const EVENT_ID_TIME_ORDERED = "TIME_ORDERED";
 const char* const LEARNING_MODE_ONLINE = "ONLINE";
 const char* const LEARNING_MODE_APPRENTICE = "APPRENTICE";
 const char* const LEARNING_MODE_LOGGINGONLY = "LOGGINGONLY";
@@ -134,9 +161,22 @@ const char* const HTTP_API_DEFAULT_HEADER_KEY_NAME = "Ocp-Apim-Subscription-Key"
 
 const char* const QUEUE_MODE_DROP = "DROP";
 const char* const QUEUE_MODE_BLOCK = "BLOCK";
+const char* const QUEUE_IMPLEMENTATION_LIST = "LIST";
+const char* const QUEUE_IMPLEMENTATION_RING_BUFFER = "RING_BUFFER";
+const char* const TRANSFORM_MODE_BATCHER = "BATCHER";
+const char* const TRANSFORM_MODE_CALLER = "CALLER";
+const char* const TRANSFORM_MODE_POOL = "POOL";
+const char* const TRANSFORM_MODE_DIRECT = "DIRECT";
 
 const bool DEFAULT_MODEL_BACKGROUND_REFRESH = true;
 const int DEFAULT_VW_POOL_INIT_SIZE = 4;
+const int DEFAULT_VW_POOL_BUILD_THREADS = 1;
+const int DEFAULT_VW_BATCH_THREADS = 1;
+const int DEFAULT_QUEUE_RING_BUFFER_SLOTS = 64 * 1024;
+const int DEFAULT_TRANSFORM_THREADS = 0;  // one per hardware thread
+const int DEFAULT_DEDUP_SNAPSHOT_INTERVAL = 100;
+const int DEFAULT_ZSTD_COMPRESSION_LEVEL = 1;
+const int DEFAULT_DEDUP_EVICTION_BATCHES = 1000;
 const int DEFAULT_PROTOCOL_VERSION = 1;
 const char* const DEFAULT_AUDIT_OUTPUT_PATH = "audit";
 
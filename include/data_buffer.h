@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -60,6 +61,10 @@ public:
   // Get the beginning of the raw buffer
   value_type* raw_begin();
 
+  // Encoding of the body, written in the preamble. See logger::preamble_content_encoding
+  uint8_t content_encoding() const;
+  void set_content_encoding(uint8_t encoding);
+
 private:
   std::vector<value_type> _buffer;
   // Offset for beginning of the body data from the beginning of the buffer
@@ -68,6 +73,7 @@ private:
   size_t _body_endoffset;
   // Size in bytes of the preamble region
   const size_t _preamble_size;
+  uint8_t _content_encoding = 0;
 };
 }  // namespace utility
 }  // namespace reinforcement_learning
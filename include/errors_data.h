@@ -54,4 +54,6 @@ ERROR_CODE_DEFINITION(48, extension_error, "Error from extension: ")
 ERROR_CODE_DEFINITION(49, baseline_actions_not_defined, "Baseline Actions must be defined in apprentice mode")
 ERROR_CODE_DEFINITION(50, http_api_key_not_provided, "Http api key must be provided")
 ERROR_CODE_DEFINITION(51, http_model_uri_not_provided, "Model Blob URI parameter was not passed in via configuration")
+ERROR_CODE_DEFINITION(52, action_not_registered, "Action was not registered: ")
+ERROR_CODE_DEFINITION(53, action_id_collision, "A different action is already registered with id: ")
 //! [Error Definitions]
@@ -18,8 +18,10 @@
 #include "ranking_response.h"
 #include "sender.h"
 
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <vector>
 
 namespace reinforcement_learning
 {
@@ -167,6 +169,58 @@ public:
   int choose_rank(string_view context_json, unsigned int flags, ranking_response& resp,
       api_status* status = nullptr);  // event_id is auto-generated
 
+  /**
+   * @brief Register an action so that choose_rank() requests can reference it by id instead of sending its
+   * features.  Each model instance parses and hashes a registered action once, then reuses it.
+   * Registering the same json again returns the same id.  If a different action already has the id the call fails
+   * with action_id_collision.
+   * @param action_json The action as it would appear in the _multi array of a context, a json object
+   * @param action_id The id of the action, the same content hash used to deduplicate actions in the logs
+   * @param status  Optional field with detailed string description if there is an error
+   * @return int Return error code.  This will also be returned in the api_status object
+   */
+  int register_action(string_view action_json, uint64_t& action_id, api_status* status = nullptr);
+
+  /**
+   * @brief Remove an action added with register_action().  Requests already using it are not affected.
+   * @param action_id The id returned by register_action()
+   * @param status  Optional field with detailed string description if there is an error
+   * @return int Return error code.  This will also be returned in the api_status object
+   */
+  int unregister_action(uint64_t action_id, api_status* status = nullptr);
+
+  /**
+   * @brief Choose an action among registered actions.  The result and the logged interaction are the same as
+   * choose_rank() with a context made of shared_context_json and a _multi array of the registered actions, but
+   * only the shared features are parsed for the request.
+   * @param event_id  The unique identifier for this interaction.  The same event_id should be used when
+   *                  reporting the outcome for this action.
+   * @param shared_context_json Shared features of the request in json format, without a _multi array
+   * @param action_ids Ids returned by register_action(), in the order of the actions of the request
+   * @param flags Action flags (see action_flags.h)
+   * @param resp Ranking response contains the chosen action, probability distribution used for sampling actions and
+   * ranked actions
+   * @param status  Optional field with detailed string description if there is an error
+   * @return int Return error code.  This will also be returned in the api_status object
+   */
+  int choose_rank(const char* event_id, string_view shared_context_json, const std::vector<uint64_t>& action_ids,
+      unsigned int flags, ranking_response& resp, api_status* status = nullptr);
+
+  /**
+   * @brief Choose an action for each context of a batch.  The result is the same as calling choose_rank() for each
+   * (event_id, context) pair, but the model instance and the logger are acquired once per batch and the events are
+   * added to the logger queue under a single lock (the RING_BUFFER queue, which has no lock, takes a slot per event).
+   * Set vw.batch.threads to rank the batch on several threads.
+   * @param event_ids  The unique identifier of each interaction.
+   * @param contexts_json The context of each interaction, in the same order as event_ids
+   * @param flags Action flags (see action_flags.h), applied to every interaction
+   * @param resps One ranking response per context, in the same order as contexts_json
+   * @param status  Optional field with detailed string description if there is an error
+   * @return int Return error code.  This will also be returned in the api_status object
+   */
+  int choose_rank_batch(const std::vector<const char*>& event_ids, const std::vector<string_view>& contexts_json,
+      unsigned int flags, std::vector<ranking_response>& resps, api_status* status = nullptr);
+
   /**
    * @brief (DEPRECATED) Choose an action from a continuous range, given a list of context features
    * The inference library chooses an action by sampling the probability density function produced per continuous action
@@ -315,6 +369,22 @@ public:
       multi_slot_response_detailed& resp, const int* baseline_actions, size_t baseline_actions_size,
       api_status* status = nullptr);
 
+  /**
+   * @brief Multi slot decisions for each context of a batch.  The result is the same as calling
+   * request_multi_slot_decision() for each (event_id, context) pair, but the model instance and the logger are
+   * acquired once per batch and the events are added to the logger queue under a single lock (the RING_BUFFER queue,
+   * which has no lock, takes a slot per event).  Set vw.batch.threads to process the batch on several threads.
+   * @param event_ids  The unique identifier of each interaction.
+   * @param contexts_json The context of each interaction, in the same order as event_ids
+   * @param flags Action flags (see action_flags.h), applied to every interaction
+   * @param resps One decision response per context, in the same order as contexts_json
+   * @param status  Optional field with detailed string description if there is an error
+   * @return int Return error code.  This will also be returned in the api_status object
+   */
+  int request_multi_slot_decision_batch(const std::vector<const char*>& event_ids,
+      const std::vector<string_view>& contexts_json, unsigned int flags,
+      std::vector<multi_slot_response_detailed>& resps, api_status* status = nullptr);
+
   // multistep
   int request_episodic_decision(const char* event_id, const char* previous_id, string_view context_json,
       ranking_response& resp, episode_state& episode, api_status* status = nullptr);
@@ -4,6 +4,8 @@
 #include <stdint.h>
 
 #include <cstddef>
+#include <functional>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -30,9 +32,13 @@ public:
   void data_sz(size_t fillsz);
   void increment_refresh_count();
 
-  // Allocate
+  // Allocate, the current buffer is reused when it is large enough
   char* alloc(size_t desired);
   void free();
+  size_t capacity() const;
+  // Use memory kept alive by owner, such as a memory mapped file, instead of an allocated buffer.
+  // The memory must not be modified, copies of this object share it rather than copying it.
+  void assign_external(char* data, size_t sz, std::shared_ptr<void> owner);
 
   model_data();
   ~model_data();
@@ -44,7 +50,9 @@ public:
 private:
   char* _data = nullptr;
   size_t _data_sz = 0;
+  size_t _capacity = 0;
   uint32_t _refresh_count = 0;
+  std::shared_ptr<void> _external_owner;
 };
 
 //! The i_data_transport interface provides the way to retrieve the data for a model from some source.
@@ -52,6 +60,9 @@ class i_data_transport
 {
 public:
   virtual int get_data(model_data& data, api_status* status = nullptr) = 0;
+  //! Transports that are notified of model changes call fn when a new model can be fetched, so that it does not
+  //! wait for the next refresh interval. An empty fn removes the callback. Returns false when not supported.
+  virtual bool set_model_changed_callback(std::function<void()> fn) { return false; }
   virtual ~i_data_transport() = default;
 };
 
@@ -69,6 +80,13 @@ enum class model_source
   AZURE,
   HTTP_API
 };
+
+//! An action registered with live_model::register_action(), id is the content hash of json.
+struct registered_action
+{
+  uint64_t id;
+  string_view json;
+};
 //! The i_model interfaces provides the resolution from the raw model_data to a consumable object.
 class i_model
 {
@@ -76,6 +94,30 @@ public:
   virtual int update(const model_data& data, bool& model_ready, api_status* status = nullptr) = 0;
   virtual int choose_rank(const char* event_id, uint64_t rnd_seed, string_view features, std::vector<int>& action_ids,
       std::vector<float>& action_pdf, std::string& model_version, api_status* status = nullptr) = 0;
+  //! Same as choose_rank(), models that copy the features before parsing may reuse a scratch buffer for the copy.
+  virtual int choose_rank_with_context_buffer(const char* event_id, uint64_t rnd_seed, string_view features,
+      std::vector<int>& action_ids, std::vector<float>& action_pdf, std::string& model_version,
+      api_status* status = nullptr)
+  {
+    return choose_rank(event_id, rnd_seed, features, action_ids, action_pdf, model_version, status);
+  }
+  //! Same as choose_rank() for a context made of shared_features and the registered actions. shared_features has an
+  //! empty _multi array and features is the full context. Models that keep the registered actions parsed by id only
+  //! parse shared_features, the default implementation ranks features.
+  //! registry_generation changes whenever an action is unregistered, actions parsed under another generation are stale.
+  virtual int choose_rank_registered(const char* event_id, uint64_t rnd_seed, string_view shared_features,
+      const std::vector<registered_action>& actions, uint64_t registry_generation, string_view features,
+      std::vector<int>& action_ids, std::vector<float>& action_pdf, std::string& model_version,
+      api_status* status = nullptr)
+  {
+    return choose_rank(event_id, rnd_seed, features, action_ids, action_pdf, model_version, status);
+  }
+  //! Ranks a batch of contexts, entry i of every output belongs to features[i].
+  //! The default implementation calls choose_rank() for each context.
+  virtual int choose_rank_batch(const std::vector<const char*>& event_ids, const std::vector<uint64_t>& rnd_seeds,
+      const std::vector<string_view>& features, std::vector<std::vector<int>>& action_ids,
+      std::vector<std::vector<float>>& action_pdfs, std::vector<std::string>& model_versions,
+      api_status* status = nullptr);
   virtual int choose_continuous_action(string_view features, float& action, float& pdf_value,
       std::string& model_version, api_status* status = nullptr) = 0;
   virtual int request_decision(const std::vector<const char*>& event_ids, string_view features,
@@ -84,6 +126,13 @@ public:
   virtual int request_multi_slot_decision(const char* event_id, const std::vector<std::string>& slot_ids,
       string_view features, std::vector<std::vector<uint32_t>>& actions_ids,
       std::vector<std::vector<float>>& action_pdfs, std::string& model_version, api_status* status = nullptr) = 0;
+  //! Multi slot decisions for a batch of contexts, entry i of every output belongs to features[i].
+  //! The default implementation calls request_multi_slot_decision() for each context.
+  virtual int request_multi_slot_decision_batch(const std::vector<const char*>& event_ids,
+      const std::vector<std::vector<std::string>>& slot_ids, const std::vector<string_view>& features,
+      std::vector<std::vector<std::vector<uint32_t>>>& actions_ids,
+      std::vector<std::vector<std::vector<float>>>& action_pdfs, std::vector<std::string>& model_versions,
+      api_status* status = nullptr);
   virtual int choose_rank_multistep(const char* event_id, uint64_t rnd_seed, string_view features,
       const episode_history& history, std::vector<int>& action_ids, std::vector<float>& action_pdf,
       std::string& model_version, api_status* status = nullptr) = 0;
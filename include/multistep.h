@@ -6,7 +6,6 @@
 #include <stdint.h>
 
 #include <cstddef>
-#include <map>
 #include <memory>
 #include <string>
 #include <utility>
@@ -14,10 +13,14 @@
 
 namespace reinforcement_learning
 {
+// Depth of the events of an episode. The event ids are hashed into a flat table instead of being stored,
+// and a long episode can be bounded to its last max_size events.
 class episode_history
 {
 public:
   episode_history() = default;
+  //! Only the last max_size events are kept, 0 keeps every event of the episode
+  explicit episode_history(size_t max_size);
   episode_history(const episode_history* previous);
 
   episode_history(const episode_history& other) = default;
@@ -28,20 +31,44 @@ public:
 
   void update(const char* event_id, const char* previous_event_id, string_view context, const ranking_response& resp);
   std::string get_context(const char* previous_event_id, string_view context) const;
+  //! Same as above, but writes into a buffer that can be reused across the steps of an episode
+  void get_context(const char* previous_event_id, string_view context, std::string& out) const;
 
+  //! Number of events held
   size_t size() const;
+  //! Number of updates, including the events a bounded history dropped since
+  uint64_t update_count() const;
 
 private:
+  struct entry
+  {
+    uint64_t key = 0;  // 0 marks an empty slot
+    uint64_t sequence = 0;
+    int depth = 0;
+  };
+
   int get_depth(const char* id) const;
+  const entry* find(uint64_t key) const;
+  void insert(uint64_t key, uint64_t sequence, int depth);
+  void erase(uint64_t key, uint64_t sequence);
+  void grow();
 
 private:
-  std::map<std::string, int> _depths;
+  // open addressing with linear probing, the size is a power of 2
+  std::vector<entry> _slots;
+  size_t _size = 0;
+  size_t _max_size = 0;
+  uint64_t _sequence = 0;
+  // ring of the last max_size updates, to drop the oldest event once the history is full
+  std::vector<std::pair<uint64_t, uint64_t>> _window;
+  size_t _window_next = 0;
 };
 
 class episode_state
 {
 public:
-  explicit episode_state(const char* episode_id);
+  //! history_size bounds the history to the last events of the episode, 0 keeps all of them
+  explicit episode_state(const char* episode_id, size_t history_size = 0);
 
   episode_state(const episode_state& other) = default;
   episode_state& operator=(const episode_state& other) = default;
@@ -51,6 +78,7 @@ public:
 
   const char* get_episode_id() const;
   const episode_history& get_history() const;
+  //! Number of events held in the history of the episode
   size_t size() const;
 
   int update(const char* event_id, const char* previous_event_id, string_view context, const ranking_response& response,
@@ -93,6 +93,13 @@ public:
    */
   void push_back(const size_t action_id, const float prob);
 
+  /**
+   * @brief Reserve room for action_count (action id, probability) pairs (This is set internally by the API)
+   * The storage is kept by clear(), so a reused response does not allocate for rankings of the same size.
+   * @param action_count
+   */
+  void reserve(size_t action_count);
+
   /**
    * @brief Size of the action collection.
    *
@@ -105,6 +105,13 @@ public:
    */
   void push_back(const size_t action_id, const float prob);
 
+  /**
+   * @brief Reserve room for action_count (action id, probability) pairs (This is set internally by the API)
+   *
+   * @param action_count
+   */
+  void reserve(size_t action_count);
+
   /**
    * @brief Size of the action collection.
    *
@@ -7,13 +7,17 @@
 #include "vw/common/hash.h"
 #include "zstd.h"
 
-#include <sstream>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <random>
 
 namespace reinforcement_learning
 {
 namespace u = utility;
 namespace fb = flatbuffers;
 namespace l = reinforcement_learning::logger;
+namespace v2 = reinforcement_learning::messages::flatbuff::v2;
 
 dedup_dict::dict_entry::dict_entry(const char* data, size_t length)
     : _count(1), _length(length), _content(data, data + length)
@@ -28,8 +32,10 @@ static generic_event::object_id_t hash_content(const char* start, size_t size)
 generic_event::object_id_t dedup_dict::add_object(const char* start, size_t length)
 {
   auto hash = hash_content(start, length);
-  auto it = _entries.find(hash);
-  if (it == _entries.end()) { _entries.insert({hash, dict_entry(start, length)}); }
+  auto& s = get_shard(hash);
+  std::unique_lock<std::mutex> mlock(s._mutex);
+  auto it = s._entries.find(hash);
+  if (it == s._entries.end()) { s._entries.insert({hash, dict_entry(start, length)}); }
   else
   {
     ++it->second._count;
@@ -41,60 +47,146 @@ bool dedup_dict::remove_object(generic_event::object_id_t aid, size_t count)
 {
   if (count < 1) { return true; }
 
-  auto it = _entries.find(aid);
-  if (it == _entries.end()) { return false; }
+  auto& s = get_shard(aid);
+  std::unique_lock<std::mutex> mlock(s._mutex);
+  auto it = s._entries.find(aid);
+  if (it == s._entries.end()) { return false; }
 
   count = std::min(count, it->second._count);
   it->second._count -= count;
-  if (it->second._count == 0u) { _entries.erase(it); }
+  if (it->second._count == 0u) { s._entries.erase(it); }
 
   return true;
 }
 
 string_view dedup_dict::get_object(generic_event::object_id_t aid) const
 {
-  auto it = _entries.find(aid);
-  if (it == _entries.end()) { return {}; }
+  const auto& s = get_shard(aid);
+  std::unique_lock<std::mutex> mlock(s._mutex);
+  auto it = s._entries.find(aid);
+  if (it == s._entries.end()) { return {}; }
+  // entries are never moved by a rehash, the content outlives the lock while it is referenced
   return {it->second._content.data(), it->second._length};
 }
 
+// writes the decimal digits of value at the end of out
+static void append_id(std::string& out, generic_event::object_id_t value)
+{
+  char digits[20];
+  size_t count = 0;
+  do
+  {
+    digits[count++] = static_cast<char>('0' + value % 10);
+    value /= 10;
+  } while (value != 0);
+  while (count > 0) { out.push_back(digits[--count]); }
+}
+
 int dedup_dict::transform_payload_and_add_objects(
     string_view payload, std::string& edited_payload, generic_event::object_list_t& object_ids, api_status* status)
 {
-  u::ContextInfo context_info;
-  RETURN_IF_FAIL(u::get_context_info(payload, context_info, nullptr, status));
+  static const char aid_prefix[] = "{\"__aid\":";
 
-  edited_payload = std::string(payload);
+  // the actions are replaced as the parser reaches them, the payload is copied once between them
+  edited_payload.clear();
+  edited_payload.reserve(payload.size());
   object_ids.clear();
-  object_ids.reserve(context_info.actions.size());
-
-  size_t edit_offset = 0;
-  for (auto& p : context_info.actions)
-  {
-    auto hash = add_object(&payload[p.first], p.second);
+  size_t copied = 0;
+  auto on_action = [&](size_t start, size_t length) {
+    auto hash = add_object(&payload[start], length);
     object_ids.push_back(hash);
-    std::stringstream replacement;
-    replacement << "{\"__aid\":";
-    replacement << hash << "}";
-    edited_payload.replace(p.first - edit_offset, p.second, replacement.str());
-
-    // adjust the edit position based on how many bytes were deleted.
-    edit_offset += p.second - replacement.tellp();
+    edited_payload.append(payload.data() + copied, start - copied);
+    edited_payload.append(aid_prefix, sizeof(aid_prefix) - 1);
+    append_id(edited_payload, hash);
+    edited_payload.push_back('}');
+    copied = start + length;
+  };
+
+  const int res = u::for_each_action(payload, on_action, nullptr, status);
+  if (res != error_code::success)
+  {
+    // the objects added before the parse error are not referenced by any event
+    for (auto aid : object_ids) { remove_object(aid); }
+    object_ids.clear();
+    return res;
   }
 
+  edited_payload.append(payload.data() + copied, payload.size() - copied);
   return error_code::success;
 }
 
-size_t dedup_dict::size() const { return _entries.size(); }
+size_t dedup_dict::size() const
+{
+  size_t count = 0;
+  for (const auto& s : _shards)
+  {
+    std::unique_lock<std::mutex> mlock(s._mutex);
+    count += s._entries.size();
+  }
+  return count;
+}
+
+namespace
+{
+struct cctx_deleter
+{
+  void operator()(ZSTD_CCtx* ctx) const { ZSTD_freeCCtx(ctx); }
+};
+struct dctx_deleter
+{
+  void operator()(ZSTD_DCtx* ctx) const { ZSTD_freeDCtx(ctx); }
+};
+
+// a zstd context holds several hundred KB of tables, each thread keeps one instead of creating one per event
+ZSTD_CCtx* thread_cctx()
+{
+  static thread_local std::unique_ptr<ZSTD_CCtx, cctx_deleter> ctx(ZSTD_createCCtx());
+  return ctx.get();
+}
+
+ZSTD_DCtx* thread_dctx()
+{
+  static thread_local std::unique_ptr<ZSTD_DCtx, dctx_deleter> ctx(ZSTD_createDCtx());
+  return ctx.get();
+}
+}  // namespace
 
 zstd_compressor::zstd_compressor(int level) : _level(level) {}
 
+int zstd_compressor::set_dictionary(const char* data, size_t size, api_status* status)
+{
+  const auto dictionary_id = ZSTD_getDictID_fromDict(data, size);
+  if (dictionary_id == 0)
+  {
+    RETURN_ERROR_LS(nullptr, status, compression_error)
+        << "The zstd dictionary has no id, it must be created with zstd --train";
+  }
+
+  _cdict.reset(ZSTD_createCDict(data, size, _level));
+  _ddict.reset(ZSTD_createDDict(data, size));
+  if (_cdict == nullptr || _ddict == nullptr)
+  { RETURN_ERROR_LS(nullptr, status, compression_error) << "Invalid zstd dictionary"; }
+  _dictionary_id = dictionary_id;
+  return error_code::success;
+}
+
+int zstd_compressor::load_dictionary(const char* path, api_status* status)
+{
+  std::ifstream file(path, std::ios::in | std::ios::binary);
+  if (!file.good()) { RETURN_ERROR_LS(nullptr, status, file_open_error) << path; }
+  const std::vector<char> dictionary((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  if (file.bad()) { RETURN_ERROR_LS(nullptr, status, file_read_error) << path; }
+  return set_dictionary(dictionary.data(), dictionary.size(), status);
+}
+
 int zstd_compressor::compress(generic_event::payload_buffer_t& input, api_status* status) const
 {
   size_t buff_size = ZSTD_compressBound(input.size());
 
   std::unique_ptr<uint8_t[]> data(fb::DefaultAllocator().allocate(buff_size));
-  size_t res = ZSTD_compress(data.get(), buff_size, input.data(), input.size(), _level);
+  size_t res = _cdict != nullptr
+      ? ZSTD_compress_usingCDict(thread_cctx(), data.get(), buff_size, input.data(), input.size(), _cdict.get())
+      : ZSTD_compressCCtx(thread_cctx(), data.get(), buff_size, input.data(), input.size(), _level);
 
   if (ZSTD_isError(res) != 0u) { RETURN_ERROR_ARG(nullptr, status, compression_error, ZSTD_getErrorName(res)); }
 
@@ -103,7 +195,7 @@ int zstd_compressor::compress(generic_event::payload_buffer_t& input, api_status
   return error_code::success;
 }
 
-int zstd_compressor::decompress(generic_event::payload_buffer_t& buf, api_status* status)
+int zstd_compressor::decompress(generic_event::payload_buffer_t& buf, api_status* status) const
 {
   size_t buff_size = ZSTD_getFrameContentSize(buf.data(), buf.size());
   if (buff_size == ZSTD_CONTENTSIZE_ERROR)
@@ -112,7 +204,9 @@ int zstd_compressor::decompress(generic_event::payload_buffer_t& buf, api_status
   { RETURN_ERROR_ARG(nullptr, status, compression_error, "Unknown compressed size."); }
 
   std::unique_ptr<uint8_t[]> data(fb::DefaultAllocator().allocate(buff_size));
-  size_t res = ZSTD_decompress(data.get(), buff_size, buf.data(), buf.size());
+  size_t res = _ddict != nullptr
+      ? ZSTD_decompress_usingDDict(thread_dctx(), data.get(), buff_size, buf.data(), buf.size(), _ddict.get())
+      : ZSTD_decompressDCtx(thread_dctx(), data.get(), buff_size, buf.data(), buf.size());
 
   if (ZSTD_isError(res) != 0u) { RETURN_ERROR_ARG(nullptr, status, compression_error, ZSTD_getErrorName(res)); }
 
@@ -123,19 +217,31 @@ int zstd_compressor::decompress(generic_event::payload_buffer_t& buf, api_status
 
 dedup_state::dedup_state(
     const utility::configuration& c, bool use_compression, bool use_dedup, i_time_provider* time_provider)
-    : _compressor(c.get_int(name::ZSTD_COMPRESSION_LEVEL, zstd_compressor::ZSTD_DEFAULT_COMPRESSION_LEVEL))
+    : _compressor(c.get_int(name::ZSTD_COMPRESSION_LEVEL, value::DEFAULT_ZSTD_COMPRESSION_LEVEL))
     , _time_provider(time_provider)
     , _use_compression(use_compression)
     , _use_dedup(use_dedup)
+    , _dictionary_file(c.get(name::ZSTD_DICTIONARY_FILE, ""))
+    , _persistent(c.get_bool(name::DEDUP_PERSISTENT, false))
+    , _snapshot_interval(std::max(0, c.get_int(name::DEDUP_SNAPSHOT_INTERVAL, value::DEFAULT_DEDUP_SNAPSHOT_INTERVAL)))
+    , _eviction_batches(std::max(1, c.get_int(name::DEDUP_EVICTION_BATCHES, value::DEFAULT_DEDUP_EVICTION_BATCHES)))
 {
+  std::random_device rd;
+  do
+  {
+    _client_id = (static_cast<uint64_t>(rd()) << 32) | rd();
+  } while (_client_id == 0);
 }
 
-string_view dedup_state::get_object(generic_event::object_id_t aid)
+int dedup_state::init(api_status* status)
 {
-  std::unique_lock<std::mutex> mlock(_mutex);
-  return _dict.get_object(aid);
+  if (_use_compression && !_dictionary_file.empty())
+  { RETURN_IF_FAIL(_compressor.load_dictionary(_dictionary_file.c_str(), status)); }
+  return error_code::success;
 }
 
+string_view dedup_state::get_object(generic_event::object_id_t aid) { return _dict.get_object(aid); }
+
 float dedup_state::get_ewma_value() const { return _ewma.value(); }
 
 void dedup_state::update_ewma(float value)
@@ -161,14 +267,91 @@ int dedup_state::transform_payload_and_add_objects(
 {
   if (!_use_dedup)
   {
-    edited_payload = std::string(payload);
+    edited_payload.assign(payload.data(), payload.size());
     return error_code::success;
   }
 
-  std::unique_lock<std::mutex> mlock(_mutex);
   return _dict.transform_payload_and_add_objects(payload, edited_payload, object_ids, status);
 }
 
+void dedup_state::remove_objects(const generic_event::object_list_t& object_ids)
+{
+  for (auto aid : object_ids) { _dict.remove_object(aid); }
+}
+
+int dedup_state::build_persistent_payload(const std::unordered_map<generic_event::object_id_t, size_t>& used_objects,
+    generic_event::payload_buffer_t& payload, api_status* status)
+{
+  // nothing is committed to _sequence, _sent_objects or the dictionary until the payload is built
+  const auto sequence = _sequence + 1;
+  // objects used by this batch are never evicted, there is at least one eviction batch
+  const auto is_evicted = [this, sequence, &used_objects](
+                              const std::pair<const generic_event::object_id_t, uint64_t>& sent) {
+    return sequence - sent.second >= _eviction_batches && used_objects.find(sent.first) == used_objects.end();
+  };
+
+  generic_event::object_list_t new_ids;
+  for (const auto& used : used_objects)
+  {
+    if (_dict.get_object(used.first).empty())
+    { RETURN_ERROR_LS(nullptr, status, compression_error) << "Key not found while pruning dedup_dict"; }
+    if (_sent_objects.find(used.first) == _sent_objects.end()) { new_ids.push_back(used.first); }
+  }
+
+  generic_event::object_list_t evicted_ids;
+  for (const auto& sent : _sent_objects)
+  {
+    if (is_evicted(sent)) { evicted_ids.push_back(sent.first); }
+  }
+
+  // the first batch is always a snapshot, so that a reader that starts with this client is in sync
+  const bool snapshot = sequence == 1 || (_snapshot_interval > 0 && (sequence - 1) % _snapshot_interval == 0);
+  generic_event::object_list_t ids;
+  if (snapshot)
+  {
+    ids.reserve(_sent_objects.size() + new_ids.size());
+    for (const auto& sent : _sent_objects)
+    {
+      if (!is_evicted(sent)) { ids.push_back(sent.first); }
+    }
+    ids.insert(ids.end(), new_ids.begin(), new_ids.end());
+  }
+  else
+  {
+    ids = new_ids;
+  }
+
+  std::vector<string_view> values;
+  values.reserve(ids.size());
+  for (auto aid : ids)
+  {
+    auto content = _dict.get_object(aid);
+    if (content.empty())
+    { RETURN_ERROR_LS(nullptr, status, compression_error) << "Key not found while building batch dictionary"; }
+    values.push_back(content);
+  }
+
+  payload = l::dedup_info_serializer::event(ids, values, snapshot ? v2::DedupMode_Snapshot : v2::DedupMode_Delta,
+      snapshot ? generic_event::object_list_t() : evicted_ids, sequence, _client_id);
+
+  _sequence = sequence;
+  for (const auto& used : used_objects)
+  {
+    // a new object keeps one of the batch references for as long as the reader holds it
+    auto released = used.second;
+    auto inserted = _sent_objects.emplace(used.first, sequence);
+    if (inserted.second) { --released; }
+    else { inserted.first->second = sequence; }
+    _dict.remove_object(used.first, released);
+  }
+  for (auto aid : evicted_ids)
+  {
+    _dict.remove_object(aid);
+    _sent_objects.erase(aid);
+  }
+  return error_code::success;
+}
+
 action_dict_builder::action_dict_builder(dedup_state& state) : _size_estimate(0), _state(state) {}
 
 int action_dict_builder::add(const generic_event::object_list_t& object_ids, api_status* status)
@@ -185,7 +368,9 @@ int action_dict_builder::add(const generic_event::object_list_t& object_ids, api
             << "Key not found while processing event into batch dictionary";
       }
       _used_objects.insert({aid, 1});
-      _size_estimate += sizeof(size_t) + content.size();
+      // objects sent by a previous batch only cost their id when the dictionary is persistent
+      _size_estimate += sizeof(size_t);
+      if (!_state.is_persistent() || !_state.is_sent(aid)) { _size_estimate += content.size(); }
     }
     else
     {
@@ -200,15 +385,21 @@ size_t action_dict_builder::size() const { return (size_t)(_size_estimate * _sta
 int action_dict_builder::finalize(generic_event& evt, api_status* status)
 {
   l::dedup_info_serializer ser;
-  generic_event::object_list_t action_ids;
   const auto now = _state.get_time_provider() != nullptr ? _state.get_time_provider()->gmt_now() : timestamp();
-  std::vector<string_view> action_values;
+  generic_event::payload_buffer_t payload;
 
-  RETURN_IF_FAIL(_state.get_all_values(_used_objects.begin(), _used_objects.end(), action_ids, action_values, status));
-  auto payload = l::dedup_info_serializer::event(action_ids, action_values);
-
-  // remove used actions from the dictionary
-  RETURN_IF_FAIL(_state.remove_all_values(_used_objects.begin(), _used_objects.end(), status));
+  if (_state.is_persistent()) { RETURN_IF_FAIL(_state.build_persistent_payload(_used_objects, payload, status)); }
+  else
+  {
+    generic_event::object_list_t action_ids;
+    std::vector<string_view> action_values;
+    RETURN_IF_FAIL(
+        _state.get_all_values(_used_objects.begin(), _used_objects.end(), action_ids, action_values, status));
+    payload = l::dedup_info_serializer::event(action_ids, action_values);
+
+    // remove used actions from the dictionary
+    RETURN_IF_FAIL(_state.remove_all_values(_used_objects.begin(), _used_objects.end(), status));
+  }
 
   // compress the payload
   event_content_type content_type;
@@ -291,6 +482,8 @@ public:
         sender, watchdog, _dummy_state, perror_cb, config);
   }
 
+  int init(api_status* status) override { return _dedup_state.init(status); }
+
   bool is_object_extraction_enabled() const override { return _use_dedup; }
   bool is_serialization_transform_enabled() const override { return _use_compression; }
 
@@ -300,6 +493,8 @@ public:
     return _dedup_state.transform_payload_and_add_objects(context, edited_payload, objects, status);
   }
 
+  void release_objects(const generic_event::object_list_t& objects) override { _dedup_state.remove_objects(objects); }
+
   int transform_serialized_payload(
       generic_event::payload_buffer_t& input, event_content_type& content_type, api_status* status) const override
   {
@@ -4,12 +4,16 @@
 #include "rl_string_view.h"
 #include "zstd.h"
 
+#include <array>
+#include <memory>
 #include <mutex>
 #include <unordered_map>
 #include <vector>
 
 namespace reinforcement_learning
 {
+// The dictionary is split in shards that each have their own lock, so that events can be transformed
+// concurrently by several threads while the batcher builds the batch dictionaries.
 class dedup_dict
 {
 public:
@@ -18,8 +22,8 @@ public:
   dedup_dict(const dedup_dict&) = delete;
   dedup_dict& operator=(const dedup_dict&) = delete;
 
-  dedup_dict(dedup_dict&&) = default;
-  dedup_dict& operator=(dedup_dict&&) = default;
+  dedup_dict(dedup_dict&&) = delete;
+  dedup_dict& operator=(dedup_dict&&) = delete;
   ~dedup_dict() = default;
 
   //! Returns true if the object was found. This doesn't tell the ref count status of that object
@@ -27,12 +31,15 @@ public:
   //! Returns the object id of the object described by [start, start+length[
   generic_event::object_id_t add_object(const char* start, size_t length);
   //! Return a string_view of the object content, or an empty view if not found
+  //! The view stays valid as long as the caller holds a reference to the object
   string_view get_object(generic_event::object_id_t aid) const;
 
   size_t size() const;
   int transform_payload_and_add_objects(
       string_view payload, std::string& edited_payload, generic_event::object_list_t& object_ids, api_status* status);
 
+  static constexpr size_t SHARD_COUNT = 64;
+
 private:
   struct dict_entry
   {
@@ -42,7 +49,17 @@ private:
 
     dict_entry(const char* data, size_t length);
   };
-  std::unordered_map<generic_event::object_id_t, dict_entry> _entries;
+
+  struct shard
+  {
+    mutable std::mutex _mutex;
+    std::unordered_map<generic_event::object_id_t, dict_entry> _entries;
+  };
+
+  shard& get_shard(generic_event::object_id_t aid) { return _shards[aid & (SHARD_COUNT - 1)]; }
+  const shard& get_shard(generic_event::object_id_t aid) const { return _shards[aid & (SHARD_COUNT - 1)]; }
+
+  std::array<shard, SHARD_COUNT> _shards;
 };
 
 class ewma
@@ -59,17 +76,37 @@ private:
   const float _weight;
 };
 
+// Compresses with a zstd context reused by each thread, optionally against a pre-trained dictionary.
+// The frames carry the dictionary id so that readers can pick the same dictionary to decompress them.
 class zstd_compressor
 {
 public:
-  const static int ZSTD_DEFAULT_COMPRESSION_LEVEL = 1;
-
   explicit zstd_compressor(int level);
+
+  //! Uses a dictionary trained with `zstd --train`, raw content dictionaries are rejected since they have no id
+  int set_dictionary(const char* data, size_t size, api_status* status);
+  int load_dictionary(const char* path, api_status* status);
+  //! 0 when no dictionary is used
+  uint32_t dictionary_id() const { return _dictionary_id; }
+
   int compress(generic_event::payload_buffer_t& input, api_status* status) const;
-  static int decompress(generic_event::payload_buffer_t& buf, api_status* status);
+  int decompress(generic_event::payload_buffer_t& buf, api_status* status) const;
 
 private:
+  struct cdict_deleter
+  {
+    void operator()(ZSTD_CDict* dict) const { ZSTD_freeCDict(dict); }
+  };
+  struct ddict_deleter
+  {
+    void operator()(ZSTD_DDict* dict) const { ZSTD_freeDDict(dict); }
+  };
+
   const int _level;
+  // the digested dictionaries are read only and shared by all the threads
+  std::unique_ptr<ZSTD_CDict, cdict_deleter> _cdict;
+  std::unique_ptr<ZSTD_DDict, ddict_deleter> _ddict;
+  uint32_t _dictionary_id = 0;
 };
 
 class dedup_state
@@ -77,6 +114,9 @@ class dedup_state
 public:
   dedup_state(const utility::configuration& c, bool use_compression, bool use_dedup, i_time_provider* time_provider);
 
+  //! Loads the compression dictionary named in the configuration, if any
+  int init(api_status* status);
+
   string_view get_object(generic_event::object_id_t aid);
   float get_ewma_value() const;
 
@@ -91,6 +131,16 @@ public:
   int compress(generic_event::payload_buffer_t& input, event_content_type& content_type, api_status* status) const;
   int transform_payload_and_add_objects(
       string_view payload, std::string& edited_payload, generic_event::object_list_t& object_ids, api_status* status);
+  //! Gives back the references held by an event that is dropped before being batched
+  void remove_objects(const generic_event::object_list_t& object_ids);
+
+  //! True when the dictionary is kept across batches and the batches only carry what changed
+  bool is_persistent() const { return _persistent; }
+  //! True when a previous batch already sent the object to the reader
+  bool is_sent(generic_event::object_id_t aid) const { return _sent_objects.find(aid) != _sent_objects.end(); }
+  //! Builds the Delta or Snapshot dictionary of a batch and releases the batch references
+  int build_persistent_payload(const std::unordered_map<generic_event::object_id_t, size_t>& used_objects,
+      generic_event::payload_buffer_t& payload, api_status* status);
 
   i_time_provider* get_time_provider() { return _time_provider.get(); }
 
@@ -102,10 +152,20 @@ private:
   ewma _ewma;
   dedup_dict _dict;
   zstd_compressor _compressor;
-  std::mutex _mutex;
   std::unique_ptr<i_time_provider> _time_provider;
   bool _use_compression;
   bool _use_dedup;
+  std::string _dictionary_file;
+
+  bool _persistent;
+  uint64_t _snapshot_interval;
+  uint64_t _eviction_batches;
+  // only used by the batcher thread, from the objects the reader holds to the sequence of the last batch using them
+  // each of them keeps one reference in the dictionary until it is evicted
+  std::unordered_map<generic_event::object_id_t, uint64_t> _sent_objects;
+  uint64_t _sequence = 0;
+  // tells the readers which dictionary the updates apply to, never 0
+  uint64_t _client_id = 0;
 };
 
 static const char* DEDUP_DICT_EVENT_ID = "3defd95a-0122-4aac-9068-0b9ac30b66d8";
@@ -128,8 +188,6 @@ template <typename I>
 int dedup_state::get_all_values(I start, I end, generic_event::object_list_t& action_ids,
     std::vector<string_view>& action_values, api_status* status)
 {
-  std::unique_lock<std::mutex> mlock(_mutex);
-
   for (; start != end; ++start)
   {
     auto content = _dict.get_object(start->first);
@@ -145,7 +203,6 @@ int dedup_state::get_all_values(I start, I end, generic_event::object_list_t& ac
 template <typename I>
 int dedup_state::remove_all_values(I start, I end, api_status* status)
 {
-  std::unique_lock<std::mutex> mlock(_mutex);
   for (; start != end; ++start)
   {
     if (!_dict.remove_object(start->first, start->second))
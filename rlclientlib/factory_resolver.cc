@@ -103,7 +103,10 @@ int file_model_loader_create(
   TRACE_INFO(trace_logger, "File model loader created.");
   const char* file_name = config.get(name::MODEL_FILE_NAME, "current");
   const bool file_must_exist = config.get_bool(name::MODEL_FILE_MUST_EXIST, false);
-  auto* file_loader = new model_management::file_model_loader(file_name, file_must_exist, trace_logger);
+  const bool use_mmap = config.get_bool(name::MODEL_FILE_MMAP, false);
+  const bool watch = config.get_bool(name::MODEL_FILE_WATCH, false);
+  auto* file_loader =
+      new model_management::file_model_loader(file_name, file_must_exist, trace_logger, use_mmap, watch);
 
   const auto success = file_loader->init(status);
 
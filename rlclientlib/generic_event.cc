@@ -42,7 +42,14 @@ generic_event::generic_event(const char* id, const timestamp& ts, payload_type_t
 bool generic_event::try_drop(float pass_prob, int drop_pass)
 {
   _pass_prob *= pass_prob;
-  return prg(drop_pass) > pass_prob;
+  const bool drop = prg(drop_pass) > pass_prob;
+  if (drop && _objects_owner != nullptr)
+  {
+    _objects_owner->release_objects(_objects);
+    _objects.clear();
+    _objects_owner = nullptr;
+  }
+  return drop;
 }
 
 const char* generic_event::get_id() const { return _id.c_str(); }
@@ -69,6 +76,12 @@ generic_event::payload_type_t generic_event::get_payload_type() const { return _
 
 const generic_event::payload_buffer_t& generic_event::get_payload() const { return _payload; }
 
+void generic_event::set_serialized_event(payload_buffer_t&& serialized_event)
+{
+  _serialized_event = std::move(serialized_event);
+  _payload = payload_buffer_t();
+}
+
 generic_event::encoding_type_t generic_event::get_encoding() const
 {
   switch (_content_type)
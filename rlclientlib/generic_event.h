@@ -47,6 +47,7 @@ public:
 
   float get_pass_prob() const;
   timestamp get_client_time_gmt() const;
+  // a dropped event that was already transformed releases its objects
   bool try_drop(float pass_prob, int drop_pass);
 
   const object_list_t& get_object_list() const;
@@ -65,21 +66,40 @@ public:
 
   encoding_type_t get_encoding() const;
 
+  // the v2::Event of an event serialized by the thread that logged it, empty otherwise
+  bool is_serialized() const { return _serialized_event.size() > 0; }
+  payload_buffer_t& get_serialized_event() { return _serialized_event; }
+  const payload_buffer_t& get_serialized_event() const { return _serialized_event; }
+  // the payload is part of the serialized event, so it is released
+  void set_serialized_event(payload_buffer_t&& serialized_event);
+
   // context_string is only valid before the event is transformed
   const std::string& get_context_string() const { return _context_string; }
 
   // generate a serializable event
   // This only works with a context string, other event types cannot be transformed
   template <typename TSerializer, typename... Args>
-  int transform(logger::i_logger_extensions* ext, TSerializer& serializer, api_status* status, Args... args)
+  int transform(logger::i_logger_extensions* ext, TSerializer& serializer, api_status* status, const Args&... args)
   {
     assert(_context_string.size() > 0);
-    if (!ext->is_object_extraction_enabled()) { _payload = serializer.event(_context_string, args...); }
+    RETURN_IF_FAIL(transform_context(_context_string, ext, serializer, status, args...));
+    _context_string.clear();
+    return 0;
+  }
+
+  // same as transform() for a context that is not stored in the event, it is only read during the call
+  template <typename TSerializer, typename... Args>
+  int transform_context(string_view context, logger::i_logger_extensions* ext, TSerializer& serializer,
+      api_status* status, const Args&... args)
+  {
+    if (!ext->is_object_extraction_enabled()) { _payload = serializer.event(context, args...); }
     else
     {
-      std::string tmp;
-      RETURN_IF_FAIL(ext->transform_payload_and_extract_objects(_context_string.c_str(), tmp, _objects, status));
-      _payload = serializer.event(tmp.c_str(), args...);
+      // the edited payload is copied by the serializer, its buffer is reused by the next event of this thread
+      static thread_local std::string edited_payload;
+      RETURN_IF_FAIL(ext->transform_payload_and_extract_objects(context, edited_payload, _objects, status));
+      _objects_owner = ext;
+      _payload = serializer.event(edited_payload, args...);
     }
     if (ext->is_serialization_transform_enabled())
     { RETURN_IF_FAIL(ext->transform_serialized_payload(_payload, _content_type, status)); }
@@ -87,7 +107,6 @@ public:
     {
       _content_type = event_content_type::IDENTITY;
     }
-    _context_string.clear();
     return 0;
   }
 
@@ -99,11 +118,14 @@ protected:
   timestamp _client_time_gmt;
   payload_type_t _payload_type;
   payload_buffer_t _payload;
+  payload_buffer_t _serialized_event;
   object_list_t _objects;
   float _pass_prob = 1.0;
   event_content_type _content_type;
   std::string _app_id;
   uint64_t _event_index;
   std::string _context_string;
+  // extensions holding the references on _objects, set once the objects are extracted by transform
+  logger::i_logger_extensions* _objects_owner = nullptr;
 };
 }  // namespace reinforcement_learning
@@ -89,6 +89,33 @@ int live_model::choose_rank(
   return _pimpl->choose_rank(context_json, flags, response, status);
 }
 
+int live_model::register_action(string_view action_json, uint64_t& action_id, api_status* status)
+{
+  INIT_CHECK();
+  return _pimpl->register_action(action_json, action_id, status);
+}
+
+int live_model::unregister_action(uint64_t action_id, api_status* status)
+{
+  INIT_CHECK();
+  return _pimpl->unregister_action(action_id, status);
+}
+
+int live_model::choose_rank(const char* event_id, string_view shared_context_json,
+    const std::vector<uint64_t>& action_ids, unsigned int flags, ranking_response& resp, api_status* status)
+{
+  INIT_CHECK();
+  return _pimpl->choose_rank(event_id, shared_context_json, action_ids, flags, resp, status);
+}
+
+int live_model::choose_rank_batch(const std::vector<const char*>& event_ids,
+    const std::vector<string_view>& contexts_json, unsigned int flags, std::vector<ranking_response>& resps,
+    api_status* status)
+{
+  INIT_CHECK();
+  return _pimpl->choose_rank_batch(event_ids, contexts_json, flags, resps, status);
+}
+
 int live_model::request_continuous_action(const char* event_id, string_view context_json, unsigned int flags,
     continuous_action_response& response, api_status* status)
 {
@@ -203,6 +230,14 @@ int live_model::request_multi_slot_decision(const char* event_id, string_view co
   return _pimpl->request_multi_slot_decision(event_id, context_json, flags, resp, baseline_vector, status);
 }
 
+int live_model::request_multi_slot_decision_batch(const std::vector<const char*>& event_ids,
+    const std::vector<string_view>& contexts_json, unsigned int flags,
+    std::vector<multi_slot_response_detailed>& resps, api_status* status)
+{
+  INIT_CHECK();
+  return _pimpl->request_multi_slot_decision_batch(event_ids, contexts_json, flags, resps, status);
+}
+
 // not implemented yet
 int live_model::report_action_taken(const char* event_id, api_status* status)
 {
@@ -13,12 +13,11 @@
 #include "sender.h"
 #include "trace_logger.h"
 #include "utility/context_helper.h"
+#include "utility/event_id_generator.h"
 #include "vw/common/hash.h"
 #include "vw/explore/explore.h"
 #include "vw_model/safe_vw.h"
 
-#include <boost/uuid/random_generator.hpp>
-#include <boost/uuid/uuid_io.hpp>
 #include <cmath>
 #include <cstring>
 
@@ -37,8 +36,8 @@ int check_null_or_empty(const char* arg1, string_view arg2, i_trace* trace, api_
 int check_null_or_empty(const char* arg1, i_trace* trace, api_status* status);
 int check_null_or_empty(string_view arg1, i_trace* trace, api_status* status);
 int reset_action_order(ranking_response& response);
-void autogenerate_missing_uuids(
-    const std::map<size_t, std::string>& found_ids, std::vector<std::string>& complete_ids, uint64_t seed_shift);
+void autogenerate_missing_uuids(const std::map<size_t, std::string>& found_ids, std::vector<std::string>& complete_ids,
+    uint64_t seed_shift, const utility::event_id_generator& generator);
 int reset_chosen_action_multi_slot(
     multi_slot_response& response, const std::vector<int>& baseline_actions = std::vector<int>());
 int reset_chosen_action_multi_slot(
@@ -68,6 +67,8 @@ int live_model_impl::init(api_status* status)
   _initial_epsilon = _configuration.get_float(name::INITIAL_EPSILON, 0.2f);
   const char* app_id = _configuration.get(name::APP_ID, "");
   _seed_shift = VW::uniform_hash(app_id, strlen(app_id), 0);
+  _event_id_generator = utility::event_id_generator(
+      utility::to_event_id_kind(_configuration.get(name::EVENT_ID_GENERATOR, value::EVENT_ID_RANDOM)));
 
   return error_code::success;
 }
@@ -88,8 +89,14 @@ int live_model_impl::choose_rank(
   }
   else
   {
-    RETURN_IF_FAIL(explore_exploit(event_id, context, response, status));
+    RETURN_IF_FAIL(explore_exploit(event_id, context, flags, response, status));
   }
+  return log_ranking(event_id, context, flags, response, status);
+}
+
+int live_model_impl::log_ranking(
+    const char* event_id, string_view context, unsigned int flags, ranking_response& response, api_status* status)
+{
   response.set_event_id(event_id);
 
   if (_learning_mode == LOGGINGONLY)
@@ -117,8 +124,172 @@ int live_model_impl::choose_rank(
 int live_model_impl::choose_rank(
     string_view context, unsigned int flags, ranking_response& response, api_status* status)
 {
-  const auto uuid = boost::uuids::to_string(boost::uuids::random_generator()());
-  return choose_rank(uuid.c_str(), context, flags, response, status);
+  char event_id[utility::EVENT_ID_LENGTH + 1];
+  _event_id_generator.generate(event_id);
+  return choose_rank(event_id, context, flags, response, status);
+}
+
+int live_model_impl::register_action(string_view action_json, uint64_t& action_id, api_status* status)
+{
+  // clear previous errors if any
+  api_status::try_clear(status);
+  RETURN_IF_FAIL(check_null_or_empty(action_json, _trace_logger.get(), status));
+
+  // same hash as the deduplication of actions in the logs
+  action_id = VW::uniform_hash(action_json.data(), action_json.size(), 0);
+
+  std::lock_guard<std::mutex> lock(_registered_actions_mutex);
+  auto& action = _registered_actions[action_id];
+  if (!action) { action = std::make_shared<const std::string>(action_json.data(), action_json.size()); }
+  else if (string_view(*action) != action_json)
+  { RETURN_ERROR_LS(_trace_logger.get(), status, action_id_collision) << action_id; }
+  return error_code::success;
+}
+
+int live_model_impl::unregister_action(uint64_t action_id, api_status* status)
+{
+  // clear previous errors if any
+  api_status::try_clear(status);
+
+  std::lock_guard<std::mutex> lock(_registered_actions_mutex);
+  if (_registered_actions.erase(action_id) == 0)
+  { RETURN_ERROR_LS(_trace_logger.get(), status, action_not_registered) << action_id; }
+  ++_registry_generation;
+  return error_code::success;
+}
+
+int live_model_impl::choose_rank(const char* event_id, string_view shared_context,
+    const std::vector<uint64_t>& action_ids, unsigned int flags, ranking_response& response, api_status* status)
+{
+  response.clear();
+  // clear previous errors if any
+  api_status::try_clear(status);
+
+  // check arguments
+  RETURN_IF_FAIL(check_null_or_empty(event_id, shared_context, _trace_logger.get(), status));
+  if (action_ids.empty())
+  { RETURN_ERROR_LS(_trace_logger.get(), status, json_no_actions_found) << "Context must have at least one action"; }
+
+  std::vector<std::shared_ptr<const std::string>> actions_json;
+  actions_json.reserve(action_ids.size());
+  uint64_t registry_generation;
+  {
+    std::lock_guard<std::mutex> lock(_registered_actions_mutex);
+    registry_generation = _registry_generation;
+    for (const auto action_id : action_ids)
+    {
+      const auto it = _registered_actions.find(action_id);
+      if (it == _registered_actions.end())
+      { RETURN_ERROR_LS(_trace_logger.get(), status, action_not_registered) << action_id; }
+      actions_json.push_back(it->second);
+    }
+  }
+
+  std::vector<string_view> actions;
+  std::vector<m::registered_action> registered_actions;
+  actions.reserve(actions_json.size());
+  registered_actions.reserve(actions_json.size());
+  for (size_t i = 0; i < actions_json.size(); ++i)
+  {
+    actions.emplace_back(*actions_json[i]);
+    registered_actions.push_back({action_ids[i], actions.back()});
+  }
+
+  // the full context is what gets logged, so the interactions are the same as choose_rank() with it
+  std::string context;
+  RETURN_IF_FAIL(u::add_actions(shared_context, actions, context, _trace_logger.get(), status));
+
+  if (!_model_ready)
+  {
+    RETURN_IF_FAIL(explore_only(event_id, context, response, status));
+    response.set_model_id("N/A");
+  }
+  else
+  {
+    std::string shared_features;
+    RETURN_IF_FAIL(u::add_actions(shared_context, {}, shared_features, _trace_logger.get(), status));
+
+    // The seed used is composed of uniform_hash(app_id) + uniform_hash(event_id)
+    const uint64_t seed = VW::uniform_hash(event_id, strlen(event_id), 0) + _seed_shift;
+
+    std::vector<int> ranked_action_ids;
+    std::vector<float> action_pdf;
+    std::string model_version;
+    RETURN_IF_FAIL(_model->choose_rank_registered(event_id, seed, shared_features, registered_actions,
+        registry_generation, context, ranked_action_ids, action_pdf, model_version, status));
+    RETURN_IF_FAIL(sample_and_populate_response(
+        seed, ranked_action_ids, action_pdf, std::move(model_version), response, _trace_logger.get(), status));
+  }
+  return log_ranking(event_id, context, flags, response, status);
+}
+
+int live_model_impl::choose_rank_batch(const std::vector<const char*>& event_ids,
+    const std::vector<string_view>& contexts, unsigned int flags, std::vector<ranking_response>& responses,
+    api_status* status)
+{
+  responses.clear();
+  // clear previous errors if any
+  api_status::try_clear(status);
+
+  // check arguments
+  if (event_ids.size() != contexts.size())
+  {
+    RETURN_ERROR_LS(_trace_logger.get(), status, invalid_argument)
+        << "event_ids and contexts must have the same size";
+  }
+  for (size_t i = 0; i < contexts.size(); ++i)
+  { RETURN_IF_FAIL(check_null_or_empty(event_ids[i], contexts[i], _trace_logger.get(), status)); }
+
+  responses.resize(contexts.size());
+  if (!_model_ready)
+  {
+    for (size_t i = 0; i < contexts.size(); ++i)
+    {
+      RETURN_IF_FAIL(explore_only(event_ids[i], contexts[i], responses[i], status));
+      responses[i].set_model_id("N/A");
+    }
+  }
+  else
+  {
+    // The seed used is composed of uniform_hash(app_id) + uniform_hash(event_id)
+    std::vector<uint64_t> seeds;
+    seeds.reserve(event_ids.size());
+    for (const auto* event_id : event_ids)
+    { seeds.push_back(VW::uniform_hash(event_id, strlen(event_id), 0) + _seed_shift); }
+
+    std::vector<std::vector<int>> action_ids;
+    std::vector<std::vector<float>> action_pdfs;
+    std::vector<std::string> model_versions;
+    RETURN_IF_FAIL(
+        _model->choose_rank_batch(event_ids, seeds, contexts, action_ids, action_pdfs, model_versions, status));
+
+    for (size_t i = 0; i < contexts.size(); ++i)
+    {
+      RETURN_IF_FAIL(sample_and_populate_response(seeds[i], action_ids[i], action_pdfs[i],
+          std::move(model_versions[i]), responses[i], _trace_logger.get(), status));
+    }
+  }
+
+  for (size_t i = 0; i < contexts.size(); ++i)
+  {
+    responses[i].set_event_id(event_ids[i]);
+    // Reset the ranked action order before logging
+    if (_learning_mode == LOGGINGONLY) { RETURN_IF_FAIL(reset_action_order(responses[i])); }
+  }
+
+  RETURN_IF_FAIL(_interaction_logger->log_batch(contexts, flags, responses, status, _learning_mode));
+
+  if (_learning_mode == APPRENTICE)
+  {
+    // Reset the ranked action order after logging
+    for (auto& response : responses) { RETURN_IF_FAIL(reset_action_order(response)); }
+  }
+
+  // Check watchdog for any background errors. Do this at the end of function so that the work is still done.
+  if (_watchdog.has_background_error_been_reported())
+  { RETURN_ERROR_LS(_trace_logger.get(), status, unhandled_background_error_occurred); }
+
+  return error_code::success;
 }
 
 int live_model_impl::request_continuous_action(const char* event_id, string_view context, unsigned int flags,
@@ -148,8 +319,9 @@ int live_model_impl::request_continuous_action(const char* event_id, string_view
 int live_model_impl::request_continuous_action(
     string_view context, unsigned int flags, continuous_action_response& response, api_status* status)
 {
-  const auto uuid = boost::uuids::to_string(boost::uuids::random_generator()());
-  return request_continuous_action(uuid.c_str(), context, flags, response, status);
+  char event_id[utility::EVENT_ID_LENGTH + 1];
+  _event_id_generator.generate(event_id);
+  return request_continuous_action(event_id, context, flags, response, status);
 }
 
 int live_model_impl::request_decision(
@@ -187,10 +359,8 @@ int live_model_impl::request_decision(
 
   std::vector<std::string> event_ids_str(num_decisions);
   std::vector<const char*> event_ids(num_decisions, nullptr);
-  std::map<size_t, std::string> found_ids;
-  RETURN_IF_FAIL(utility::get_event_ids(context_json, found_ids, _trace_logger.get(), status));
-
-  autogenerate_missing_uuids(found_ids, event_ids_str, _seed_shift);
+  // the event ids are the slot ids found while scanning the context
+  autogenerate_missing_uuids(context_info.slot_ids, event_ids_str, _seed_shift, _event_id_generator);
 
   for (int i = 0; i < event_ids.size(); i++) { event_ids[i] = event_ids_str[i].c_str(); }
 
@@ -216,6 +386,16 @@ int live_model_impl::request_multi_slot_decision_impl(const char* event_id, stri
   // clear previous errors if any
   api_status::try_clear(status);
 
+  RETURN_IF_FAIL(get_multi_slot_ids(event_id, context_json, slot_ids, status));
+
+  RETURN_IF_FAIL(_model->request_multi_slot_decision(
+      event_id, slot_ids, context_json, action_ids, action_pdfs, model_version, status));
+  return error_code::success;
+}
+
+int live_model_impl::get_multi_slot_ids(
+    const char* event_id, string_view context_json, std::vector<std::string>& slot_ids, api_status* status)
+{
   // check arguments
   RETURN_IF_FAIL(check_null_or_empty(event_id, _trace_logger.get(), status));
   RETURN_IF_FAIL(check_null_or_empty(context_json, _trace_logger.get(), status));
@@ -232,20 +412,16 @@ int live_model_impl::request_multi_slot_decision_impl(const char* event_id, stri
   }
 
   slot_ids.resize(context_info.slots.size());
-  std::map<size_t, std::string> found_ids;
-  RETURN_IF_FAIL(utility::get_slot_ids(context_json, context_info.slots, found_ids, _trace_logger.get(), status));
-  autogenerate_missing_uuids(found_ids, slot_ids, _seed_shift);
-
-  RETURN_IF_FAIL(_model->request_multi_slot_decision(
-      event_id, slot_ids, context_json, action_ids, action_pdfs, model_version, status));
+  autogenerate_missing_uuids(context_info.slot_ids, slot_ids, _seed_shift, _event_id_generator);
   return error_code::success;
 }
 
 int live_model_impl::request_multi_slot_decision(string_view context_json, unsigned int flags,
     multi_slot_response& resp, const std::vector<int>& baseline_actions, api_status* status)
 {
-  const auto uuid = boost::uuids::to_string(boost::uuids::random_generator()());
-  return request_multi_slot_decision(uuid.c_str(), context_json, flags, resp, baseline_actions, status);
+  char event_id[utility::EVENT_ID_LENGTH + 1];
+  _event_id_generator.generate(event_id);
+  return request_multi_slot_decision(event_id, context_json, flags, resp, baseline_actions, status);
 }
 
 int live_model_impl::request_multi_slot_decision(const char* event_id, string_view context_json, unsigned int flags,
@@ -284,8 +460,9 @@ int live_model_impl::request_multi_slot_decision(const char* event_id, string_vi
 int live_model_impl::request_multi_slot_decision(string_view context_json, unsigned int flags,
     multi_slot_response_detailed& resp, const std::vector<int>& baseline_actions, api_status* status)
 {
-  const auto uuid = boost::uuids::to_string(boost::uuids::random_generator()());
-  return request_multi_slot_decision(uuid.c_str(), context_json, flags, resp, baseline_actions, status);
+  char event_id[utility::EVENT_ID_LENGTH + 1];
+  _event_id_generator.generate(event_id);
+  return request_multi_slot_decision(event_id, context_json, flags, resp, baseline_actions, status);
 }
 
 int live_model_impl::request_multi_slot_decision(const char* event_id, string_view context_json, unsigned int flags,
@@ -325,6 +502,57 @@ int live_model_impl::request_multi_slot_decision(const char* event_id, string_vi
   return error_code::success;
 }
 
+int live_model_impl::request_multi_slot_decision_batch(const std::vector<const char*>& event_ids,
+    const std::vector<string_view>& contexts, unsigned int flags, std::vector<multi_slot_response_detailed>& responses,
+    api_status* status)
+{
+  responses.clear();
+  // clear previous errors if any
+  api_status::try_clear(status);
+
+  // the batch API takes no baseline actions
+  if (_learning_mode == APPRENTICE) { return error_code::baseline_actions_not_defined; }
+
+  if (event_ids.size() != contexts.size())
+  {
+    RETURN_ERROR_LS(_trace_logger.get(), status, invalid_argument)
+        << "event_ids and contexts must have the same size";
+  }
+
+  std::vector<std::vector<std::string>> slot_ids(contexts.size());
+  for (size_t i = 0; i < contexts.size(); ++i)
+  { RETURN_IF_FAIL(get_multi_slot_ids(event_ids[i], contexts[i], slot_ids[i], status)); }
+
+  std::vector<std::vector<std::vector<uint32_t>>> action_ids;
+  std::vector<std::vector<std::vector<float>>> action_pdfs;
+  std::vector<std::string> model_versions;
+  RETURN_IF_FAIL(_model->request_multi_slot_decision_batch(
+      event_ids, slot_ids, contexts, action_ids, action_pdfs, model_versions, status));
+
+  responses.resize(contexts.size());
+  for (size_t i = 0; i < contexts.size(); ++i)
+  {
+    // set the size of buffer in response to match the number of slots
+    responses[i].resize(slot_ids[i].size());
+    RETURN_IF_FAIL(populate_multi_slot_response_detailed(action_ids[i], action_pdfs[i], std::string(event_ids[i]),
+        std::string(model_versions[i]), slot_ids[i], responses[i], _trace_logger.get(), status));
+  }
+
+  RETURN_IF_FAIL(_interaction_logger->log_decision_batch(
+      event_ids, contexts, flags, action_ids, action_pdfs, model_versions, slot_ids, status, _learning_mode));
+
+  if (_learning_mode == LOGGINGONLY)
+  {
+    // Reset the chosenAction.
+    for (auto& response : responses) { RETURN_IF_FAIL(reset_chosen_action_multi_slot(response)); }
+  }
+
+  // Check watchdog for any background errors. Do this at the end of function so that the work is still done.
+  if (_watchdog.has_background_error_been_reported())
+  { RETURN_ERROR_LS(_trace_logger.get(), status, unhandled_background_error_occurred); }
+  return error_code::success;
+}
+
 int live_model_impl::report_action_taken(const char* event_id, api_status* status)
 {
   // Clear previous errors if any
@@ -455,6 +683,12 @@ live_model_impl::live_model_impl(const utility::configuration& config, std::func
   _learning_mode = learning::to_learning_mode(_configuration.get(name::LEARNING_MODE, value::LEARNING_MODE_ONLINE));
 }
 
+live_model_impl::~live_model_impl()
+{
+  // the background refresh is destroyed before the transport, which must stop calling it first
+  if (_transport != nullptr) { _transport->set_model_changed_callback(nullptr); }
+}
+
 int live_model_impl::init_trace(api_status* status)
 {
   const auto* const trace_impl = _configuration.get(name::TRACE_LOG_IMPLEMENTATION, value::NULL_TRACE_LOGGER);
@@ -504,6 +738,7 @@ int live_model_impl::init_loggers(api_status* status)
   // Create the logger extension
   _logger_extensions.reset(
       logger::i_logger_extensions::get_extensions(_configuration, logger_extensions_time_provider));
+  RETURN_IF_FAIL(_logger_extensions->init(status));
 
   i_time_provider* ranking_time_provider = nullptr;
   RETURN_IF_FAIL(_time_provider_factory->create(
@@ -653,8 +888,8 @@ int live_model_impl::explore_only(
   return error_code::success;
 }
 
-int live_model_impl::explore_exploit(
-    const char* event_id, string_view context, ranking_response& response, api_status* status) const
+int live_model_impl::explore_exploit(const char* event_id, string_view context, unsigned int flags,
+    ranking_response& response, api_status* status) const
 {
   // The seed used is composed of uniform_hash(app_id) + uniform_hash(event_id)
   const uint64_t seed = VW::uniform_hash(event_id, strlen(event_id), 0) + _seed_shift;
@@ -663,7 +898,15 @@ int live_model_impl::explore_exploit(
   std::vector<float> action_pdf;
   std::string model_version;
 
-  RETURN_IF_FAIL(_model->choose_rank(event_id, seed, context, action_ids, action_pdf, model_version, status));
+  if ((flags & action_flags::REUSE_CONTEXT_BUFFER) != 0u)
+  {
+    RETURN_IF_FAIL(_model->choose_rank_with_context_buffer(
+        event_id, seed, context, action_ids, action_pdf, model_version, status));
+  }
+  else
+  {
+    RETURN_IF_FAIL(_model->choose_rank(event_id, seed, context, action_ids, action_pdf, model_version, status));
+  }
 
   return sample_and_populate_response(
       seed, action_ids, action_pdf, std::move(model_version), response, _trace_logger.get(), status);
@@ -682,7 +925,11 @@ int live_model_impl::init_model_mgmt(api_status* status)
   {
     // Initialize background process and start downloading models
     this->_model_download.reset(new m::model_downloader(ptransport, &_data_cb, _trace_logger.get()));
-    return _bg_model_proc->init(_model_download.get(), status);
+    RETURN_IF_FAIL(_bg_model_proc->init(_model_download.get(), status));
+    // download as soon as the transport sees a new model rather than at the end of the refresh interval
+    if (ptransport->set_model_changed_callback([this]() { _bg_model_proc->run_now(); }))
+    { TRACE_INFO(_trace_logger, "Model changes are reported by the data transport."); }
+    return error_code::success;
   }
 
   return refresh_model(status);
@@ -703,8 +950,10 @@ int live_model_impl::request_episodic_decision(const char* event_id, const char*
   std::vector<float> action_pdf;
   std::string model_version;
 
-  const auto history = episode.get_history();
-  const std::string context_patched = history.get_context(previous_id, context_json);
+  const auto& history = episode.get_history();
+  // reused across the steps made on this thread, the loggers copy the context
+  static thread_local std::string context_patched;
+  history.get_context(previous_id, context_json, context_patched);
 
   RETURN_IF_FAIL(_model->choose_rank_multistep(
       event_id, seed, context_patched.c_str(), history, action_ids, action_pdf, model_version, status));
@@ -715,7 +964,8 @@ int live_model_impl::request_episodic_decision(const char* event_id, const char*
 
   RETURN_IF_FAIL(episode.update(event_id, previous_id, context_json, resp, status));
 
-  if (episode.size() == 1)
+  // a bounded history may hold a single event at every step, the first update starts the episode
+  if (episode.get_history().update_count() == 1)
   {
     // Log the episode id when starting a new episode
     RETURN_IF_FAIL(_episode_logger->log(episode.get_episode_id(), status));
@@ -791,15 +1041,14 @@ int reset_chosen_action_multi_slot(multi_slot_response_detailed& response, const
   return error_code::success;
 }
 
-void autogenerate_missing_uuids(
-    const std::map<size_t, std::string>& found_ids, std::vector<std::string>& complete_ids, uint64_t seed_shift)
+void autogenerate_missing_uuids(const std::map<size_t, std::string>& found_ids, std::vector<std::string>& complete_ids,
+    uint64_t seed_shift, const utility::event_id_generator& generator)
 {
   for (const auto& ids : found_ids) { complete_ids[ids.first] = ids.second; }
 
   for (auto& complete_id : complete_ids)
   {
-    if (complete_id.empty())
-    { complete_id = boost::uuids::to_string(boost::uuids::random_generator()()) + std::to_string(seed_shift); }
+    if (complete_id.empty()) { complete_id = generator.generate() + std::to_string(seed_shift); }
   }
 }
 }  // namespace reinforcement_learning
@@ -7,12 +7,16 @@
 #include "model_mgmt/model_downloader.h"
 #include "multi_slot_response_detailed.h"
 #include "multistep.h"
+#include "utility/event_id_generator.h"
 #include "utility/periodic_background_proc.h"
 #include "utility/watchdog.h"
 
 #include <atomic>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 
 namespace reinforcement_learning
 {
@@ -32,6 +36,12 @@ public:
       const char* event_id, string_view context, unsigned int flags, ranking_response& response, api_status* status);
   // here the event_id is auto-generated
   int choose_rank(string_view context, unsigned int flags, ranking_response& response, api_status* status);
+  int choose_rank_batch(const std::vector<const char*>& event_ids, const std::vector<string_view>& contexts,
+      unsigned int flags, std::vector<ranking_response>& responses, api_status* status);
+  int register_action(string_view action_json, uint64_t& action_id, api_status* status);
+  int unregister_action(uint64_t action_id, api_status* status);
+  int choose_rank(const char* event_id, string_view shared_context, const std::vector<uint64_t>& action_ids,
+      unsigned int flags, ranking_response& response, api_status* status);
   int request_continuous_action(const char* event_id, string_view context, unsigned int flags,
       continuous_action_response& response, api_status* status);
   // here the event_id is auto-generated
@@ -46,6 +56,9 @@ public:
       multi_slot_response_detailed& resp, const std::vector<int>& baseline_actions, api_status* status = nullptr);
   int request_multi_slot_decision(string_view context_json, unsigned int flags, multi_slot_response_detailed& resp,
       const std::vector<int>& baseline_actions, api_status* status = nullptr);
+  int request_multi_slot_decision_batch(const std::vector<const char*>& event_ids,
+      const std::vector<string_view>& contexts, unsigned int flags,
+      std::vector<multi_slot_response_detailed>& responses, api_status* status);
   int request_episodic_decision(const char* event_id, const char* previous_id, string_view context_json,
       unsigned int flags, ranking_response& resp, episode_state& episode, api_status* status = nullptr);
 
@@ -71,6 +84,8 @@ public:
       trace_logger_factory_t* trace_factory, data_transport_factory_t* t_factory, model_factory_t* m_factory,
       sender_factory_t* sender_factory, time_provider_factory_t* time_provider_factory);
 
+  ~live_model_impl();
+
   live_model_impl(const live_model_impl&) = delete;
   live_model_impl(live_model_impl&&) = delete;
   live_model_impl& operator=(const live_model_impl&) = delete;
@@ -85,11 +100,16 @@ private:
   static void _handle_model_update(const model_management::model_data& data, live_model_impl* ctxt);
   void handle_model_update(const model_management::model_data& data);
   int explore_only(const char* event_id, string_view context, ranking_response& response, api_status* status) const;
-  int explore_exploit(const char* event_id, string_view context, ranking_response& response, api_status* status) const;
+  int explore_exploit(const char* event_id, string_view context, unsigned int flags, ranking_response& response,
+      api_status* status) const;
+  int log_ranking(const char* event_id, string_view context, unsigned int flags, ranking_response& response,
+      api_status* status);
   template <typename D>
   int report_outcome_internal(const char* event_id, D outcome, api_status* status);
   template <typename D, typename I>
   int report_outcome_internal(const char* primary_id, I secondary_id, D outcome, api_status* status);
+  int get_multi_slot_ids(
+      const char* event_id, string_view context_json, std::vector<std::string>& slot_ids, api_status* status);
   int request_multi_slot_decision_impl(const char* event_id, string_view context_json,
       std::vector<std::string>& slot_ids, std::vector<std::vector<uint32_t>>& action_ids,
       std::vector<std::vector<float>>& action_pdfs, std::string& model_version, api_status* status);
@@ -128,6 +148,13 @@ private:
 
   std::unique_ptr<utility::periodic_background_proc<model_management::model_downloader>> _bg_model_proc;
   uint64_t _seed_shift{};
+  utility::event_id_generator _event_id_generator;
+
+  // actions added with register_action(), requests hold on to the json of the actions they use
+  std::mutex _registered_actions_mutex;
+  std::unordered_map<uint64_t, std::shared_ptr<const std::string>> _registered_actions;
+  // bumped by unregister_action(), the models drop the actions they parsed under an older generation
+  uint64_t _registry_generation{};
 };
 
 template <typename D>
@@ -1,25 +1,32 @@
 #pragma once
 
 #include "api_status.h"
+#include "batch_compression.h"
 #include "constants.h"
 #include "data_buffer.h"
 #include "err_constants.h"
 #include "error_callback_fn.h"
 #include "event_queue.h"
 #include "message_sender.h"
+#include "ring_buffer_event_queue.h"
 #include "rl_string_view.h"
 #include "serialization/fb_serializer.h"
 #include "serialization/json_serializer.h"
 #include "utility/config_helper.h"
 #include "utility/object_pool.h"
 #include "utility/periodic_background_proc.h"
+#include "utility/worker_pool.h"
 #include "vw/common/hash.h"
 #include "vw/explore/explore.h"
 
 // float comparisons
 #include "vw/core/vw_math.h"
 
+#include <algorithm>
 #include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
 
 namespace reinforcement_learning
 {
@@ -41,6 +48,12 @@ public:
 
   virtual int append(TFunc&& func, TEvent* event, api_status* status = nullptr) = 0;
   virtual int append(TFunc& func, TEvent* event, api_status* status = nullptr) = 0;
+  // append an event that is ready to be serialized, storing it by value when the queue supports it
+  virtual int append(TEvent&& event, api_status* status = nullptr) = 0;
+  // append a batch of events that are ready to be serialized with a single queue operation
+  virtual int append(std::vector<TEvent>&& events, api_status* status = nullptr) = 0;
+  // append a batch of functions, funcs[i] producing events[i], with a single queue operation
+  virtual int append(std::vector<TFunc>&& funcs, std::vector<TEvent*>&& events, api_status* status = nullptr) = 0;
 
   virtual int run_iteration(api_status* status) = 0;
 };
@@ -62,14 +75,25 @@ public:
 
   int append(TFunc&& func, TEvent* event, api_status* status = nullptr) override;
   int append(TFunc& func, TEvent* event, api_status* status = nullptr) override;
+  int append(TEvent&& event, api_status* status = nullptr) override;
+  int append(std::vector<TEvent>&& events, api_status* status = nullptr) override;
+  int append(std::vector<TFunc>&& funcs, std::vector<TEvent*>&& events, api_status* status = nullptr) override;
 
   int run_iteration(api_status* status) override;
 
 private:
   int fill_buffer(std::shared_ptr<utility::data_buffer>& retbuffer, size_t& remaining, api_status* status);
+  // pops the next run of events and transforms them on the worker threads into _transformed
+  int transform_run(size_t& remaining, api_status* status);
+  int push(TEvent&& event);
+  int push(std::vector<TEvent>&& events);
 
   void flush();  // flush all batches
 
+  void handle_full_queue();
+
+  static i_event_queue<TEvent>* create_queue(const utility::async_batcher_config& config);
+
 public:
   async_batcher(i_message_sender* sender, utility::watchdog& watchdog, shared_state_t& shared_state,
       error_callback_fn* perror_cb, const utility::async_batcher_config& config);
@@ -78,7 +102,7 @@ public:
 private:
   std::unique_ptr<i_message_sender> _sender;
 
-  event_queue<TEvent> _queue;  // A queue to accumulate batch of events.
+  std::unique_ptr<i_event_queue<TEvent>> _queue;  // A queue to accumulate batch of events.
   size_t _send_high_water_mark;
   error_callback_fn* _perror_cb;
   shared_state_t& _shared_state;
@@ -90,9 +114,21 @@ private:
   std::mutex _m;
   utility::object_pool<utility::data_buffer> _buffer_pool;
   const char* _batch_content_encoding;
+  bool _batch_compression;
+  int _batch_compression_level;
   float _subsample_rate;
   events_counter_status _events_counter_status;
   uint64_t _buffer_end_event_index = 0;
+  transform_mode_enum _transform_mode;
+  size_t _transform_threads;
+  // started once in POOL mode, the batcher thread takes part in every transform run
+  std::unique_ptr<utility::worker_pool> _transform_workers;
+  // events transformed by the worker threads and not added to a batch yet
+  std::vector<TEvent> _transformed;
+  size_t _transformed_next = 0;
+
+  // number of events popped for each worker thread in a transform run
+  static const size_t TRANSFORM_RUN_PER_THREAD = 64;
 };
 
 template <typename TEvent, template <typename> class TSerializer>
@@ -122,29 +158,137 @@ int async_batcher<TEvent, TSerializer>::append(TFunc&& func, TEvent* event, api_
     }
   }
 
-  _queue.push(std::move(func), TSerializer<TEvent>::serializer_t::size_estimate(*event), event);
+  if (transform_mode_enum::CALLER == _transform_mode || transform_mode_enum::DIRECT == _transform_mode)
+  {
+    // the event is queued by value once transformed, the batcher thread only has to serialize it
+    TEvent evt;
+    RETURN_IF_FAIL(func(evt, status));
+    return push(std::move(evt));
+  }
 
-  // block or drop events if the queue if full
-  if (_queue.is_full())
+  _queue->push(std::move(func), TSerializer<TEvent>::serializer_t::size_estimate(*event), event);
+  handle_full_queue();
+  return error_code::success;
+}
+
+template <typename TEvent, template <typename> class TSerializer>
+int async_batcher<TEvent, TSerializer>::append(TFunc& func, TEvent* event, api_status* status)
+{
+  return append(std::move(func), event, status);
+}
+
+template <typename TEvent, template <typename> class TSerializer>
+int async_batcher<TEvent, TSerializer>::append(TEvent&& event, api_status* status)
+{
+  // If subsampling rate is < 1, then run subsampling logic
+  if (_subsample_rate < 1.f)
   {
-    if (queue_mode_enum::BLOCK == _queue_mode)
+    if (event.try_drop(_subsample_rate, constants::SUBSAMPLE_RATE_DROP_PASS))
     {
-      std::unique_lock<std::mutex> lk(_m);
-      _cv.wait(lk, [this] { return !_queue.is_full(); });
+      // If the event is dropped, just get out of here
+      return error_code::success;
     }
-    else if (queue_mode_enum::DROP == _queue_mode)
+  }
+
+  return push(std::move(event));
+}
+
+template <typename TEvent, template <typename> class TSerializer>
+int async_batcher<TEvent, TSerializer>::push(TEvent&& event)
+{
+  const auto item_size = TSerializer<TEvent>::serializer_t::size_estimate(event);
+  _queue->push(std::move(event), item_size);
+  handle_full_queue();
+  return error_code::success;
+}
+
+template <typename TEvent, template <typename> class TSerializer>
+int async_batcher<TEvent, TSerializer>::append(std::vector<TEvent>&& events, api_status* status)
+{
+  // If subsampling rate is < 1, then run subsampling logic
+  if (_subsample_rate < 1.f)
+  {
+    size_t kept = 0;
+    for (auto& event : events)
     {
-      _queue.prune(_pass_prob);
+      if (event.try_drop(_subsample_rate, constants::SUBSAMPLE_RATE_DROP_PASS)) { continue; }
+      if (&events[kept] != &event) { events[kept] = std::move(event); }
+      ++kept;
     }
+    events.resize(kept);
   }
 
+  return push(std::move(events));
+}
+
+template <typename TEvent, template <typename> class TSerializer>
+int async_batcher<TEvent, TSerializer>::push(std::vector<TEvent>&& events)
+{
+  if (events.empty()) { return error_code::success; }
+
+  std::vector<size_t> item_sizes;
+  item_sizes.reserve(events.size());
+  for (const auto& event : events) { item_sizes.push_back(TSerializer<TEvent>::serializer_t::size_estimate(event)); }
+  _queue->push(std::move(events), item_sizes);
+  handle_full_queue();
   return error_code::success;
 }
 
 template <typename TEvent, template <typename> class TSerializer>
-int async_batcher<TEvent, TSerializer>::append(TFunc& func, TEvent* event, api_status* status)
+int async_batcher<TEvent, TSerializer>::append(
+    std::vector<TFunc>&& funcs, std::vector<TEvent*>&& events, api_status* status)
 {
-  return append(std::move(func), event, status);
+  // If subsampling rate is < 1, then run subsampling logic
+  if (_subsample_rate < 1.f)
+  {
+    size_t kept = 0;
+    for (size_t i = 0; i < events.size(); ++i)
+    {
+      if (events[i]->try_drop(_subsample_rate, constants::SUBSAMPLE_RATE_DROP_PASS)) { continue; }
+      if (kept != i)
+      {
+        funcs[kept] = std::move(funcs[i]);
+        events[kept] = events[i];
+      }
+      ++kept;
+    }
+    funcs.resize(kept);
+    events.resize(kept);
+  }
+  if (events.empty()) { return error_code::success; }
+
+  if (transform_mode_enum::CALLER == _transform_mode || transform_mode_enum::DIRECT == _transform_mode)
+  {
+    // the events are queued by value once transformed, the batcher thread only has to serialize them
+    std::vector<TEvent> transformed(funcs.size());
+    for (size_t i = 0; i < funcs.size(); ++i) { RETURN_IF_FAIL(funcs[i](transformed[i], status)); }
+    return push(std::move(transformed));
+  }
+
+  std::vector<size_t> item_sizes;
+  item_sizes.reserve(events.size());
+  for (const auto* event : events) { item_sizes.push_back(TSerializer<TEvent>::serializer_t::size_estimate(*event)); }
+  _queue->push(std::move(funcs), item_sizes, events);
+  handle_full_queue();
+  return error_code::success;
+}
+
+template <typename TEvent, template <typename> class TSerializer>
+void async_batcher<TEvent, TSerializer>::handle_full_queue()
+{
+  // block or drop events if the queue if full
+  if (_queue->is_full())
+  {
+    if (queue_mode_enum::BLOCK == _queue_mode)
+    {
+      std::unique_lock<std::mutex> lk(_m);
+      _cv.wait(lk, [this] { return !_queue->is_full(); });
+    }
+    else if (queue_mode_enum::DROP == _queue_mode)
+    {
+      _queue->prune(_pass_prob);
+    }
+  }
 }
 
 template <typename TEvent, template <typename> class TSerializer>
@@ -164,13 +308,24 @@ int async_batcher<TEvent, TSerializer>::fill_buffer(
 
   while (remaining > 0 && collection_serializer.size() < _send_high_water_mark)
   {
-    if (_queue.pop(&f_evt))
+    if (transform_mode_enum::POOL == _transform_mode)
     {
+      if (_transformed_next == _transformed.size())
+      {
+        RETURN_IF_FAIL(transform_run(remaining, status));
+        continue;
+      }
+      evt = std::move(_transformed[_transformed_next++]);
+    }
+    else
+    {
+      if (!_queue->pop(&evt, &f_evt)) { continue; }
       if (queue_mode_enum::BLOCK == _queue_mode) { _cv.notify_one(); }
-      RETURN_IF_FAIL(f_evt(evt, status));
-      RETURN_IF_FAIL(collection_serializer.add(evt, status));
-      --remaining;
+      // events stored by value are already in evt
+      if (f_evt) { RETURN_IF_FAIL(f_evt(evt, status)); }
     }
+    RETURN_IF_FAIL(collection_serializer.add(evt, status));
+    --remaining;
   }
 
   if (_events_counter_status == events_counter_status::ENABLE)
@@ -187,10 +342,68 @@ int async_batcher<TEvent, TSerializer>::fill_buffer(
   return error_code::success;
 }
 
+template <typename TEvent, template <typename> class TSerializer>
+int async_batcher<TEvent, TSerializer>::transform_run(size_t& remaining, api_status* status)
+{
+  const size_t max_count = (std::min)(remaining, _transform_threads * TRANSFORM_RUN_PER_THREAD);
+  std::vector<TFunc> funcs(max_count);
+  _transformed.clear();
+  _transformed.resize(max_count);
+  _transformed_next = 0;
+  // only the events already in the queue are taken, fill_buffer comes back for the others
+  size_t count = 0;
+  while (count < max_count && _queue->pop(&_transformed[count], &funcs[count]))
+  {
+    if (queue_mode_enum::BLOCK == _queue_mode) { _cv.notify_one(); }
+    ++count;
+  }
+  _transformed.resize(count);
+  if (count == 0)
+  {
+    std::this_thread::yield();
+    return error_code::success;
+  }
+
+  const size_t chunks = (std::min)(count, _transform_workers->size());
+  const size_t chunk_size = (count + chunks - 1) / chunks;
+  std::vector<api_status> errors(chunks);
+  std::vector<char> failed(count, 0);
+  _transform_workers->run(chunks, [&](size_t c) {
+    const size_t end = (std::min)(count, (c + 1) * chunk_size);
+    for (size_t i = c * chunk_size; i < end; ++i)
+    {
+      // events stored by value are already transformed
+      if (funcs[i] && funcs[i](_transformed[i], &errors[c]) != error_code::success) { failed[i] = 1; }
+    }
+  });
+
+  // events that failed to transform are reported once and skipped
+  size_t kept = 0;
+  for (size_t i = 0; i < count; ++i)
+  {
+    if (failed[i] != 0) { continue; }
+    if (kept != i) { _transformed[kept] = std::move(_transformed[i]); }
+    ++kept;
+  }
+  _transformed.resize(kept);
+  remaining -= count - kept;
+
+  for (const auto& error : errors)
+  {
+    if (error.get_error_code() != error_code::success)
+    {
+      api_status::try_update(status, error.get_error_code(), error.get_error_msg());
+      return error.get_error_code();
+    }
+  }
+  return error_code::success;
+}
+
 template <typename TEvent, template <typename> class TSerializer>
 void async_batcher<TEvent, TSerializer>::flush()
 {
-  const auto queue_size = _queue.size();
+  // events left over by the previous transform run are sent first
+  const auto queue_size = _queue->size() + (_transformed.size() - _transformed_next);
 
   // Early exit if queue is empty.
   if (queue_size == 0) { return; }
@@ -203,17 +416,35 @@ void async_batcher<TEvent, TSerializer>::flush()
 
     auto buffer = _buffer_pool.acquire();
     if (fill_buffer(buffer, remaining, &status) != error_code::success) { ERROR_CALLBACK(_perror_cb, status); }
+    else if (_batch_compression &&
+        compress_batch_body(*buffer, _batch_compression_level, &status) != error_code::success)
+    {
+      ERROR_CALLBACK(_perror_cb, status);
+    }
     if (_sender->send(TSerializer<TEvent>::message_id(), buffer, &status) != error_code::success)
     { ERROR_CALLBACK(_perror_cb, status); }
   }
 }
 
+template <typename TEvent, template <typename> class TSerializer>
+i_event_queue<TEvent>* async_batcher<TEvent, TSerializer>::create_queue(const utility::async_batcher_config& config)
+{
+  if (config.queue_implementation == queue_implementation_enum::RING_BUFFER)
+  {
+    const size_t slots = config.queue_ring_buffer_slots > 0 ? static_cast<size_t>(config.queue_ring_buffer_slots)
+                                                            : value::DEFAULT_QUEUE_RING_BUFFER_SLOTS;
+    return new ring_buffer_event_queue<TEvent>(config.send_queue_max_capacity, slots, config.event_counter_status,
+        config.subsample_rate, config.queue_mode);
+  }
+  return new event_queue<TEvent>(config.send_queue_max_capacity, config.event_counter_status, config.subsample_rate);
+}
+
 template <typename TEvent, template <typename> class TSerializer>
 async_batcher<TEvent, TSerializer>::async_batcher(i_message_sender* sender, utility::watchdog& watchdog,
     typename TSerializer<TEvent>::shared_state_t& shared_state, error_callback_fn* perror_cb,
     const utility::async_batcher_config& config)
     : _sender(sender)
-    , _queue(config.send_queue_max_capacity, config.event_counter_status, config.subsample_rate)
+    , _queue(create_queue(config))
     , _send_high_water_mark(config.send_high_water_mark)
     , _perror_cb(perror_cb)
     , _shared_state(shared_state)
@@ -222,9 +453,16 @@ async_batcher<TEvent, TSerializer>::async_batcher(i_message_sender* sender, util
     , _pass_prob(0.5)
     , _queue_mode(config.queue_mode)
     , _batch_content_encoding(config.batch_content_encoding)
+    , _batch_compression(config.batch_compression)
+    , _batch_compression_level(config.batch_compression_level)
     , _subsample_rate(config.subsample_rate)
     , _events_counter_status(config.event_counter_status)
+    , _transform_mode(config.transform_mode)
+    , _transform_threads(config.transform_threads > 0 ? static_cast<size_t>(config.transform_threads)
+                                                      : (std::max)(std::thread::hardware_concurrency(), 1u))
 {
+  if (transform_mode_enum::POOL == _transform_mode)
+  { _transform_workers.reset(new utility::worker_pool(_transform_threads)); }
 }
 
 template <typename TEvent, template <typename> class TSerializer>
@@ -232,7 +470,7 @@ async_batcher<TEvent, TSerializer>::~async_batcher()
 {
   // Stop the background procedure the queue before exiting
   _periodic_background_proc.stop();
-  if (_queue.size() > 0) { flush(); }
+  if (_queue->size() > 0 || _transformed_next < _transformed.size()) { flush(); }
 }
 }  // namespace logger
 }  // namespace reinforcement_learning
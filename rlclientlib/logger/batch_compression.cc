@@ -0,0 +1,47 @@
+#include "batch_compression.h"
+
+#include "api_status.h"
+#include "data_buffer.h"
+#include "err_constants.h"
+#include "preamble.h"
+#include "zstd.h"
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace reinforcement_learning
+{
+namespace logger
+{
+namespace
+{
+struct cctx_deleter
+{
+  void operator()(ZSTD_CCtx* ctx) const { ZSTD_freeCCtx(ctx); }
+};
+}  // namespace
+
+int compress_batch_body(utility::data_buffer& buffer, int level, api_status* status)
+{
+  // only the batcher threads get here, each keeps its context and output buffer across batches
+  static thread_local std::unique_ptr<ZSTD_CCtx, cctx_deleter> ctx(ZSTD_createCCtx());
+  static thread_local std::vector<unsigned char> compressed;
+
+  const auto body_size = buffer.body_filled_size();
+  compressed.resize(ZSTD_compressBound(body_size));
+  const auto res =
+      ZSTD_compressCCtx(ctx.get(), compressed.data(), compressed.size(), buffer.body_begin(), body_size, level);
+  if (ZSTD_isError(res) != 0u) { RETURN_ERROR_ARG(nullptr, status, compression_error, ZSTD_getErrorName(res)); }
+  if (res >= body_size) { return error_code::success; }
+
+  // the compressed body is smaller, so it fits right after the preamble region
+  const auto begin = buffer.preamble_size();
+  std::memcpy(buffer.raw_begin() + begin, compressed.data(), res);
+  RETURN_IF_FAIL(buffer.set_body_beginoffset(begin));
+  RETURN_IF_FAIL(buffer.set_body_endoffset(begin + res));
+  buffer.set_content_encoding(preamble_content_encoding::ZSTD);
+  return error_code::success;
+}
+}  // namespace logger
+}  // namespace reinforcement_learning
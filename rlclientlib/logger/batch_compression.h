@@ -0,0 +1,18 @@
+#pragma once
+
+namespace reinforcement_learning
+{
+class api_status;
+
+namespace utility
+{
+class data_buffer;
+}
+
+namespace logger
+{
+// Compresses the filled body of a batch into a single zstd frame and records the encoding for the preamble.
+// The body is left as it is if compressing it does not make it smaller.
+int compress_batch_body(utility::data_buffer& buffer, int level, api_status* status);
+}  // namespace logger
+}  // namespace reinforcement_learning
@@ -6,6 +6,7 @@
 
 #include <functional>
 #include <memory>
+#include <vector>
 namespace reinforcement_learning
 {
 namespace logger
@@ -14,18 +15,21 @@ int interaction_logger::log(const char* event_id, string_view context, unsigned
     const ranking_response& response, api_status* status, learning_mode learning_mode)
 {
   const auto now = _time_provider != nullptr ? _time_provider->gmt_now() : timestamp();
-  // using shared_ptr because we can't move a unique_ptr in C++11
-  // We should replace them in C++14
-  auto evt_sp = std::make_shared<ranking_event>();
-  // A gross little shuffle because report_outcome returns a copy, but we actually need a pointer
-  auto evt_copy = ranking_event::choose_rank(event_id, context, flags, response, now, 1.0f, learning_mode);
-  *evt_sp = std::move(evt_copy);
+  return append(ranking_event::choose_rank(event_id, context, flags, response, now, 1.0f, learning_mode), status);
+}
 
-  auto evt_fn = [evt_sp](ranking_event& out_evt, api_status* status) -> int {
-    out_evt = std::move(*evt_sp);
-    return error_code::success;
-  };
-  return append(std::move(evt_fn), evt_sp.get(), status);
+int interaction_logger::log_batch(const std::vector<string_view>& contexts, unsigned int flags,
+    const std::vector<ranking_response>& responses, api_status* status, learning_mode learning_mode)
+{
+  const auto now = _time_provider != nullptr ? _time_provider->gmt_now() : timestamp();
+  std::vector<ranking_event> events;
+  events.reserve(responses.size());
+  for (size_t i = 0; i < responses.size(); ++i)
+  {
+    events.push_back(ranking_event::choose_rank(
+        responses[i].get_event_id(), contexts[i], flags, responses[i], now, 1.0f, learning_mode));
+  }
+  return append(std::move(events), status);
 }
 
 int ccb_logger::log_decisions(std::vector<const char*>& event_ids, string_view context, unsigned int flags,
@@ -33,17 +37,9 @@ int ccb_logger::log_decisions(std::vector<const char*>& event_ids, string_view c
     const std::string& model_version, api_status* status)
 {
   const auto now = _time_provider != nullptr ? _time_provider->gmt_now() : timestamp();
-  auto evt_sp = std::make_shared<decision_ranking_event>();
-  auto evt_copy =
-      decision_ranking_event::request_decision(event_ids, context, flags, action_ids, pdfs, model_version, now);
-  *evt_sp = std::move(evt_copy);
-
-  const char* evt_id = evt_sp->get_seed_id().c_str();
-  auto evt_fn = [evt_sp](decision_ranking_event& out_evt, api_status* status) -> int {
-    out_evt = std::move(*evt_sp);
-    return error_code::success;
-  };
-  return append(std::move(evt_fn), evt_sp.get(), status);
+  return append(
+      decision_ranking_event::request_decision(event_ids, context, flags, action_ids, pdfs, model_version, now),
+      status);
 }
 
 int multi_slot_logger::log_decision(const std::string& event_id, string_view context, unsigned int flags,
@@ -51,32 +47,32 @@ int multi_slot_logger::log_decision(const std::string& event_id, string_view con
     const std::string& model_version, api_status* status)
 {
   const auto now = _time_provider != nullptr ? _time_provider->gmt_now() : timestamp();
+  return append(
+      multi_slot_decision_event::request_decision(event_id, context, flags, action_ids, pdfs, model_version, now),
+      status);
+}
 
-  auto evt_sp = std::make_shared<multi_slot_decision_event>();
-  auto evt_copy =
-      multi_slot_decision_event::request_decision(event_id, context, flags, action_ids, pdfs, model_version, now);
-  *evt_sp = std::move(evt_copy);
-
-  auto evt_fn = [evt_sp](multi_slot_decision_event& out_evt, api_status* status) -> int {
-    out_evt = std::move(*evt_sp);
-    return error_code::success;
-  };
-  ;
-  return append(std::move(evt_fn), evt_sp.get(), status);
+int multi_slot_logger::log_decision_batch(const std::vector<const char*>& event_ids,
+    const std::vector<string_view>& contexts, unsigned int flags,
+    const std::vector<std::vector<std::vector<uint32_t>>>& action_ids,
+    const std::vector<std::vector<std::vector<float>>>& pdfs, const std::vector<std::string>& model_versions,
+    api_status* status)
+{
+  const auto now = _time_provider != nullptr ? _time_provider->gmt_now() : timestamp();
+  std::vector<multi_slot_decision_event> events;
+  events.reserve(event_ids.size());
+  for (size_t i = 0; i < event_ids.size(); ++i)
+  {
+    events.push_back(multi_slot_decision_event::request_decision(
+        event_ids[i], contexts[i], flags, action_ids[i], pdfs[i], model_versions[i], now));
+  }
+  return append(std::move(events), status);
 }
 
 int observation_logger::report_action_taken(const char* event_id, api_status* status)
 {
   const auto now = _time_provider != nullptr ? _time_provider->gmt_now() : timestamp();
-  auto evt_sp = std::make_shared<outcome_event>();
-  auto evt_copy = outcome_event::report_action_taken(event_id, now);
-  *evt_sp = std::move(evt_copy);
-
-  auto evt_fn = [evt_sp](outcome_event& out_evt, api_status* status) -> int {
-    out_evt = std::move(*evt_sp);
-    return error_code::success;
-  };
-  return append(std::move(evt_fn), evt_sp.get(), status);
+  return append(outcome_event::report_action_taken(event_id, now), status);
 }
 
 int generic_event_logger::log(const char* event_id, generic_event::payload_buffer_t&& payload,
@@ -91,14 +87,16 @@ int generic_event_logger::log(const char* event_id, generic_event::payload_buffe
     api_status* status)
 {
   const auto now = _time_provider != nullptr ? _time_provider->gmt_now() : timestamp();
-  auto evt_sp = std::make_shared<generic_event>(
-      event_id, now, type, std::move(payload), content_type, std::move(objects), _app_id);
+  generic_event evt(event_id, now, type, std::move(payload), content_type, std::move(objects), _app_id);
+  if (_serialize_on_caller) { RETURN_IF_FAIL(fb_event_serializer<generic_event>::serialize_event(evt, status)); }
+  return append(std::move(evt), status);
+}
 
-  auto evt_fn = [evt_sp](generic_event& out_evt, api_status* status) -> int {
-    out_evt = std::move(*evt_sp);
-    return error_code::success;
-  };
-  return append(std::move(evt_fn), evt_sp.get(), status);
+int generic_event_logger::log_batch(event_batch&& batch, api_status* status)
+{
+  if (!batch._events.empty()) { RETURN_IF_FAIL(append(std::move(batch._events), status)); }
+  if (!batch._funcs.empty()) { RETURN_IF_FAIL(append(std::move(batch._funcs), std::move(batch._func_events), status)); }
+  return error_code::success;
 }
 }  // namespace logger
 }  // namespace reinforcement_learning
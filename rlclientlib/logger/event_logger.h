@@ -20,6 +20,9 @@
 
 #include <functional>
 #include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace reinforcement_learning
 {
@@ -44,6 +47,9 @@ public:
 protected:
   int append(TFunc&& func, TEvent* event, api_status* status);
   int append(TFunc& func, TEvent* event, api_status* status);
+  int append(TEvent&& event, api_status* status);
+  int append(std::vector<TEvent>&& events, api_status* status);
+  int append(std::vector<TFunc>&& funcs, std::vector<TEvent*>&& events, api_status* status);
 
 protected:
   bool _initialized = false;
@@ -94,6 +100,45 @@ int event_logger<TEvent>::append(TFunc& func, TEvent* event, api_status* status)
   return append(std::move(func), status);
 }
 
+template <typename TEvent>
+int event_logger<TEvent>::append(TEvent&& event, api_status* status)
+{
+  if (!_initialized)
+  {
+    api_status::try_update(status, error_code::not_initialized, "Logger not initialized. Call init() first.");
+    return error_code::not_initialized;
+  }
+
+  // Add item to the batch (will be sent later)
+  return _batcher->append(std::move(event), status);
+}
+
+template <typename TEvent>
+int event_logger<TEvent>::append(std::vector<TEvent>&& events, api_status* status)
+{
+  if (!_initialized)
+  {
+    api_status::try_update(status, error_code::not_initialized, "Logger not initialized. Call init() first.");
+    return error_code::not_initialized;
+  }
+
+  // Add items to the batch (will be sent later)
+  return _batcher->append(std::move(events), status);
+}
+
+template <typename TEvent>
+int event_logger<TEvent>::append(std::vector<TFunc>&& funcs, std::vector<TEvent*>&& events, api_status* status)
+{
+  if (!_initialized)
+  {
+    api_status::try_update(status, error_code::not_initialized, "Logger not initialized. Call init() first.");
+    return error_code::not_initialized;
+  }
+
+  // Add items to the batch (will be sent later)
+  return _batcher->append(std::move(funcs), std::move(events), status);
+}
+
 class interaction_logger : public event_logger<ranking_event>
 {
 public:
@@ -104,6 +149,10 @@ public:
 
   int log(const char* event_id, string_view context, unsigned int flags, const ranking_response& response,
       api_status* status, learning_mode learning_mode = ONLINE);
+
+  // logs responses[i] for contexts[i], all the events are appended at once
+  int log_batch(const std::vector<string_view>& contexts, unsigned int flags,
+      const std::vector<ranking_response>& responses, api_status* status, learning_mode learning_mode = ONLINE);
 };
 
 class ccb_logger : public event_logger<decision_ranking_event>
@@ -130,6 +179,12 @@ public:
   int log_decision(const std::string& event_id, string_view context, unsigned int flags,
       const std::vector<std::vector<uint32_t>>& action_ids, const std::vector<std::vector<float>>& pdfs,
       const std::string& model_version, api_status* status);
+
+  // logs the decision i of every vector, all the events are appended at once
+  int log_decision_batch(const std::vector<const char*>& event_ids, const std::vector<string_view>& contexts,
+      unsigned int flags, const std::vector<std::vector<std::vector<uint32_t>>>& action_ids,
+      const std::vector<std::vector<std::vector<float>>>& pdfs, const std::vector<std::string>& model_versions,
+      api_status* status);
 };
 
 class observation_logger : public event_logger<outcome_event>
@@ -144,15 +199,7 @@ public:
   int log(const char* event_id, D outcome, api_status* status)
   {
     const auto now = _time_provider != nullptr ? _time_provider->gmt_now() : timestamp();
-    // A gross little shuffle because report_outcome returns a copy, but we actually need a pointer
-    auto evt_sp = std::make_shared<outcome_event>();
-    auto evt_copy = outcome_event::report_outcome(event_id, outcome, now);
-    *evt_sp = std::move(evt_copy);
-    auto evt_fn = [evt_sp](outcome_event& out_evt, api_status* status) -> int {
-      out_evt = std::move(*evt_sp);
-      return error_code::success;
-    };
-    return append(std::move(evt_fn), evt_sp.get(), status);
+    return append(outcome_event::report_outcome(event_id, outcome, now), status);
   }
 
   int report_action_taken(const char* event_id, api_status* status);
@@ -161,31 +208,69 @@ public:
 class generic_event_logger : public event_logger<generic_event>
 {
 public:
-  generic_event_logger(i_time_provider* time_provider, i_async_batcher<generic_event>* batcher, const char* app_id)
-      : event_logger(time_provider, batcher, app_id)
+  // serialize_on_caller: the events are serialized into their final flatbuffer by the thread that logs them
+  generic_event_logger(i_time_provider* time_provider, i_async_batcher<generic_event>* batcher, const char* app_id,
+      bool serialize_on_caller = false)
+      : event_logger(time_provider, batcher, app_id), _serialize_on_caller(serialize_on_caller)
   {
   }
 
+  // events collected by add_to_batch, log_batch appends all of them at once
+  class event_batch
+  {
+  public:
+    void reserve(size_t count)
+    {
+      _events.reserve(count);
+      _funcs.reserve(count);
+      _func_events.reserve(count);
+    }
+
+  private:
+    friend class generic_event_logger;
+    std::vector<generic_event> _events;  // serialized on the caller
+    std::vector<TFunc> _funcs;           // transformed by the batcher, _funcs[i] producing *_func_events[i]
+    std::vector<generic_event*> _func_events;
+  };
+
   template <typename TSerializer, typename... Args>
   int log(const char* event_id, string_view context, generic_event::payload_type_t type, i_logger_extensions* ext,
-      TSerializer& serializer, api_status* status, const Args&... args)
+      TSerializer& serializer, api_status* status, Args&&... args)
   {
     const auto now = _time_provider != nullptr ? _time_provider->gmt_now() : timestamp();
-    // using shared_ptr because we can't move a unique_ptr in C++11
-    // We should replace them in C++14
-    auto evt_sp = std::make_shared<generic_event>(event_id, now, type, context, _app_id);
-    // there's no guarantee that the parameter pack Args will stay in scope, so we need to capture them
-    // as a copy the ensure their lifetime.
-    // TODO: See if there's a way to do this without the copy, since the pack can contain some pretty
-    //       expensive objects
-    auto evt_fn = [evt_sp, type, ext, serializer, args...](generic_event& out_evt, api_status* status) -> int {
-      RETURN_IF_FAIL(evt_sp->transform(ext, serializer, status, args...));
-      out_evt = std::move(*evt_sp);
-      return error_code::success;
-    };
+    if (_serialize_on_caller)
+    {
+      generic_event evt;
+      RETURN_IF_FAIL(serialize_now(evt, event_id, now, context, type, ext, serializer, status, args...));
+      return append(std::move(evt), status);
+    }
+    std::shared_ptr<generic_event> evt_sp;
+    auto evt_fn = transform_later(evt_sp, event_id, now, context, type, ext, serializer, std::forward<Args>(args)...);
     return append(std::move(evt_fn), evt_sp.get(), status);
   }
 
+  // same as log(), the event is added to the batch instead of being appended
+  template <typename TSerializer, typename... Args>
+  int add_to_batch(event_batch& batch, const char* event_id, string_view context, generic_event::payload_type_t type,
+      i_logger_extensions* ext, TSerializer& serializer, api_status* status, Args&&... args)
+  {
+    const auto now = _time_provider != nullptr ? _time_provider->gmt_now() : timestamp();
+    if (_serialize_on_caller)
+    {
+      generic_event evt;
+      RETURN_IF_FAIL(serialize_now(evt, event_id, now, context, type, ext, serializer, status, args...));
+      batch._events.push_back(std::move(evt));
+      return error_code::success;
+    }
+    std::shared_ptr<generic_event> evt_sp;
+    batch._funcs.push_back(
+        transform_later(evt_sp, event_id, now, context, type, ext, serializer, std::forward<Args>(args)...));
+    batch._func_events.push_back(evt_sp.get());
+    return error_code::success;
+  }
+
+  int log_batch(event_batch&& batch, api_status* status);
+
   // TODO: used for observations for now.. may want to change that later
   // These functions will take in fully transformed generic_event objects, and should only be used
   // when the creation of those types are very cheap
@@ -193,6 +278,42 @@ public:
       event_content_type content_type, api_status* status);
   int log(const char* event_id, generic_event::payload_buffer_t&& payload, generic_event::payload_type_t type,
       event_content_type content_type, generic_event::object_list_t&& objects, api_status* status);
+
+private:
+  // the context is read from the caller's buffer, it is never copied into the event
+  template <typename TSerializer, typename... Args>
+  int serialize_now(generic_event& evt, const char* event_id, const timestamp& now, string_view context,
+      generic_event::payload_type_t type, i_logger_extensions* ext, TSerializer& serializer, api_status* status,
+      const Args&... args)
+  {
+    evt = generic_event(event_id, now, type, string_view(), _app_id);
+    RETURN_IF_FAIL(evt.transform_context(context, ext, serializer, status, args...));
+    return fb_event_serializer<generic_event>::serialize_event(evt, status);
+  }
+
+  // returns the function that transforms evt_sp, the context is copied into the event
+  template <typename TSerializer, typename... Args>
+  TFunc transform_later(std::shared_ptr<generic_event>& evt_sp, const char* event_id, const timestamp& now,
+      string_view context, generic_event::payload_type_t type, i_logger_extensions* ext, TSerializer& serializer,
+      Args&&... args)
+  {
+    // using shared_ptr because we can't move a unique_ptr in C++11
+    // We should replace them in C++14
+    evt_sp = std::make_shared<generic_event>(event_id, now, type, context, _app_id);
+    auto evt = evt_sp;
+    // there's no guarantee that the parameter pack Args will stay in scope, so the bound function keeps its own
+    // copy of them. C++11 lambdas cannot capture by move, std::bind moves the arguments passed as rvalues.
+    return std::bind(
+        [evt, ext, serializer](generic_event& out_evt, api_status* status,
+            const typename std::decay<Args>::type&... bound_args) -> int {
+          RETURN_IF_FAIL(evt->transform(ext, serializer, status, bound_args...));
+          out_evt = std::move(*evt);
+          return error_code::success;
+        },
+        std::placeholders::_1, std::placeholders::_2, std::forward<Args>(args)...);
+  }
+
+  const bool _serialize_on_caller;
 };
 }  // namespace logger
 }  // namespace reinforcement_learning
@@ -1,22 +1,51 @@
 #pragma once
 
 #include "constants.h"
+#include "err_constants.h"
 #include "ranking_event.h"
 #include "utility/config_helper.h"
 
+#include <functional>
 #include <list>
+#include <memory>
 #include <mutex>
 #include <queue>
 #include <type_traits>
+#include <vector>
 
 namespace reinforcement_learning
 {
-// a moving concurrent queue with locks and mutex
+// interface of the queue used by async_batcher to accumulate events
 template <class T>
-class event_queue
+class i_event_queue
 {
 public:
   using TFunc = std::function<int(T&, api_status*)>;
+  virtual ~i_event_queue() = default;
+
+  // pops the next entry: events pushed by value are moved into *event and leave *item empty,
+  // otherwise *item is set to the function producing the event
+  virtual bool pop(T* event, TFunc* item) = 0;
+  virtual bool push(TFunc&& item, size_t item_size, T* event) = 0;
+  virtual bool push(T&& event, size_t item_size) = 0;
+  // pushes a batch of events, item_sizes[i] is the size estimate of events[i]
+  virtual void push(std::vector<T>&& events, const std::vector<size_t>& item_sizes) = 0;
+  // pushes a batch of functions, item_sizes[i] and events[i] are the size estimate and the event of items[i]
+  virtual void push(
+      std::vector<TFunc>&& items, const std::vector<size_t>& item_sizes, const std::vector<T*>& events) = 0;
+  virtual void prune(float pass_prob) = 0;
+  // approximate size
+  virtual size_t size() = 0;
+  virtual bool is_full() const = 0;
+  virtual size_t capacity() const = 0;
+};
+
+// a moving concurrent queue with locks and mutex
+template <class T>
+class event_queue : public i_event_queue<T>
+{
+public:
+  using TFunc = typename i_event_queue<T>::TFunc;
 
 private:
   // T's lifetime is tied to TFunc
@@ -39,6 +68,8 @@ public:
   {
   }
 
+  bool pop(T* event, TFunc* item) override { return pop(item); }
+
   bool pop(TFunc* item)
   {
     std::unique_lock<std::mutex> mlock(_mutex);
@@ -55,7 +86,7 @@ public:
 
   bool push(TFunc& item, size_t item_size, T* event) { return push(std::move(item), item_size, event); }
 
-  bool push(TFunc&& item, size_t item_size, T* event)
+  bool push(TFunc&& item, size_t item_size, T* event) override
   {
     std::unique_lock<std::mutex> mlock(_mutex);
     if (_event_counter_status == events_counter_status::ENABLE)
@@ -77,7 +108,42 @@ public:
     return true;
   }
 
-  void prune(float pass_prob)
+  // the list has no storage for events, so they are kept alive by the function
+  bool push(T&& event, size_t item_size) override
+  {
+    auto evt_sp = std::make_shared<T>(std::move(event));
+    auto evt_fn = [evt_sp](T& out_evt, api_status*) -> int {
+      out_evt = std::move(*evt_sp);
+      return error_code::success;
+    };
+    return push(std::move(evt_fn), item_size, evt_sp.get());
+  }
+
+  // the entries are built before taking the lock, which is then taken once for the whole batch
+  void push(std::vector<T>&& events, const std::vector<size_t>& item_sizes) override
+  {
+    queue_t batch;
+    for (size_t i = 0; i < events.size(); ++i)
+    {
+      auto evt_sp = std::make_shared<T>(std::move(events[i]));
+      T* event = evt_sp.get();
+      auto evt_fn = [evt_sp](T& out_evt, api_status*) -> int {
+        out_evt = std::move(*evt_sp);
+        return error_code::success;
+      };
+      batch.emplace_back(std::move(evt_fn), item_sizes[i], event);
+    }
+    push(batch);
+  }
+
+  void push(std::vector<TFunc>&& items, const std::vector<size_t>& item_sizes, const std::vector<T*>& events) override
+  {
+    queue_t batch;
+    for (size_t i = 0; i < items.size(); ++i) { batch.emplace_back(std::move(items[i]), item_sizes[i], events[i]); }
+    push(batch);
+  }
+
+  void prune(float pass_prob) override
   {
     std::unique_lock<std::mutex> mlock(_mutex);
     if (!is_full()) return;
@@ -87,17 +153,41 @@ public:
   }
 
   // approximate size
-  size_t size()
+  size_t size() override
   {
     std::unique_lock<std::mutex> mlock(_mutex);
     return _queue.size();
   }
 
-  bool is_full() const { return capacity() >= _max_capacity; }
+  bool is_full() const override { return capacity() >= _max_capacity; }
 
-  size_t capacity() const { return _capacity; }
+  size_t capacity() const override { return _capacity; }
 
 private:
+  // takes the lock once to count, subsample and append a batch of entries
+  void push(queue_t& batch)
+  {
+    std::unique_lock<std::mutex> mlock(_mutex);
+    for (auto it = batch.begin(); it != batch.end();)
+    {
+      T* event = std::get<2>(*it);
+      if (_event_counter_status == events_counter_status::ENABLE)
+      {
+        ++_event_index;
+        event->set_event_index(_event_index);
+      }
+      // If subsampling rate is < 1, then run subsampling logic
+      if (_subsample_rate < 1 && event->try_drop(_subsample_rate, constants::SUBSAMPLE_RATE_DROP_PASS))
+      {
+        it = batch.erase(it);
+        continue;
+      }
+      _capacity += std::get<1>(*it);
+      ++it;
+    }
+    _queue.splice(_queue.end(), batch);
+  }
+
   // thread-unsafe
   iterator_t erase(iterator_t it)
   {
@@ -13,6 +13,8 @@ public:
     delete provider;  // We don't use it
   }
 
+  int init(api_status* status) override { return error_code::success; }
+
   i_async_batcher<generic_event>* create_batcher(
       i_message_sender* sender, utility::watchdog& watchdog, error_callback_fn* perror_cb, const char* section) override
   {
@@ -37,6 +39,8 @@ public:
     return error_code::success;
   }
 
+  void release_objects(const generic_event::object_list_t& objects) override {}
+
 private:
   int _dummy_state = 0;
 };
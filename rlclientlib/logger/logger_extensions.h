@@ -29,14 +29,13 @@ class i_message_sender;
 
 namespace logger
 {
-// WARNING: This interface is a bit complex in its usage. It currently lives in the live_model_impl, but is passed
-// into the interaction logger and is eventually called in the logger thread. However, it (currently) does not
-// need any form of locking because the object is ONLY called in the SINGLE logger thead.
+// The extensions live in the live_model_impl, but are passed into the interaction logger and called from the thread
+// that transforms the events. Depending on the batcher's transform mode that is the logger thread, the threads that
+// log the events or the batcher's transform workers, so implementations must be safe to call concurrently.
 // The workflow looks like:
 //   live_model_impl (owner) CONTAINS interaction_logger_facade CONTAINS generic_event_logger CONTAINS
 //     async_batcher CONTROLS logger thread AND CONTAINS a queue of generic_event. generic_event will hold a pointer to
 //     this object
-// If this condition changes, then the relevant calls must be locked!
 class i_logger_extensions
 {
 public:
@@ -53,6 +52,8 @@ public:
 
   virtual ~i_logger_extensions();
 
+  virtual int init(api_status* status) = 0;
+
   virtual bool is_object_extraction_enabled() const = 0;
   virtual bool is_serialization_transform_enabled() const = 0;
 
@@ -62,6 +63,8 @@ public:
       string_view context, std::string& edited_payload, object_list_t& objects, api_status* status) = 0;
   virtual int transform_serialized_payload(
       payload_buffer_t& input, event_content_type& content_type, api_status* status) const = 0;
+  // gives back the objects extracted from an event that is dropped before it is batched
+  virtual void release_objects(const object_list_t& objects) = 0;
 
   static i_logger_extensions* get_extensions(const utility::configuration& config, i_time_provider* time_provider);
 };
@@ -24,6 +24,21 @@ i_async_batcher<T>* create_legacy_async_batcher(const utility::configuration& c,
   return new async_batcher<T, fb_collection_serializer>(sender, watchdog, shared_state, perror_cb, config);
 }
 
+bool serialize_on_caller(const utility::configuration& c, const char* section)
+{
+  return utility::get_batcher_config(c, section).transform_mode == transform_mode_enum::DIRECT;
+}
+
+// the response is reused by the caller once the event is logged, the serializer may run later on the batcher thread.
+// A single flat copy of the ranking is moved into the event and serialized as is.
+std::vector<action_prob> copy_ranking(const ranking_response& response)
+{
+  std::vector<action_prob> ranking;
+  ranking.reserve(response.size());
+  for (auto const& r : response) { ranking.push_back(r); }
+  return ranking;
+}
+
 interaction_logger_facade::interaction_logger_facade(model_type_t model_type, const utility::configuration& c,
     i_message_sender* sender, utility::watchdog& watchdog, i_time_provider* time_provider, i_logger_extensions* ext,
     error_callback_fn* perror_cb)
@@ -48,7 +63,8 @@ interaction_logger_facade::interaction_logger_facade(model_type_t model_type, co
               : nullptr)
     , _v2(_version == 2
               ? new generic_event_logger(time_provider,
-                    ext->create_batcher(sender, watchdog, perror_cb, INTERACTION_SECTION), c.get(name::APP_ID, ""))
+                    ext->create_batcher(sender, watchdog, perror_cb, INTERACTION_SECTION), c.get(name::APP_ID, ""),
+                    serialize_on_caller(c, INTERACTION_SECTION))
               : nullptr)
 {
 }
@@ -88,18 +104,34 @@ int interaction_logger_facade::log(string_view context, unsigned int flags, cons
       v2::LearningModeType lmt;
       RETURN_IF_FAIL(get_learning_mode(learning_mode, lmt, status));
 
-      // needed for the serializer
-      std::vector<uint64_t> action_ids;
-      std::vector<float> probabilities;
-      std::string model_id(response.get_model_id());
-      for (auto const& r : response)
+      return _v2->log(response.get_event_id(), context, _serializer_cb.type, _ext_p, _serializer_cb, status, flags, lmt,
+          copy_ranking(response), std::string(response.get_model_id()));
+    }
+    default:
+      return protocol_not_supported(status);
+  }
+}
+
+int interaction_logger_facade::log_batch(const std::vector<string_view>& contexts, unsigned int flags,
+    const std::vector<ranking_response>& responses, api_status* status, learning_mode learning_mode)
+{
+  switch (_version)
+  {
+    case 1:
+      return _v1_cb->log_batch(contexts, flags, responses, status, learning_mode);
+    case 2:
+    {
+      v2::LearningModeType lmt;
+      RETURN_IF_FAIL(get_learning_mode(learning_mode, lmt, status));
+
+      generic_event_logger::event_batch batch;
+      batch.reserve(responses.size());
+      for (size_t i = 0; i < responses.size(); ++i)
       {
-        action_ids.push_back(r.action_id + 1);
-        probabilities.push_back(r.probability);
+        RETURN_IF_FAIL(_v2->add_to_batch(batch, responses[i].get_event_id(), contexts[i], _serializer_cb.type, _ext_p,
+            _serializer_cb, status, flags, lmt, copy_ranking(responses[i]), std::string(responses[i].get_model_id())));
       }
-
-      return _v2->log(response.get_event_id(), context, _serializer_cb.type, _ext_p, _serializer_cb, status, flags, lmt,
-          action_ids, probabilities, model_id);
+      return _v2->log_batch(std::move(batch), status);
     }
     default:
       return protocol_not_supported(status);
@@ -201,6 +233,49 @@ int interaction_logger_facade::log_decision(const std::string& event_id, string_
   }
 }
 
+int interaction_logger_facade::log_decision_batch(const std::vector<const char*>& event_ids,
+    const std::vector<string_view>& contexts, unsigned int flags,
+    const std::vector<std::vector<std::vector<uint32_t>>>& action_ids,
+    const std::vector<std::vector<std::vector<float>>>& pdfs, const std::vector<std::string>& model_versions,
+    const std::vector<std::vector<std::string>>& slot_ids, api_status* status, learning_mode learning_mode)
+{
+  switch (_version)
+  {
+    case 1:
+    {
+      switch (_model_type)
+      {
+        case model_type_t::SLATES:
+          return _v1_multislot->log_decision_batch(
+              event_ids, contexts, flags, action_ids, pdfs, model_versions, status);
+        default:
+          RETURN_ERROR_ARG(
+              nullptr, status, protocol_not_supported, "multi_slot logger under v1 protocol can only log slates.");
+      }
+    }
+    case 2:
+    {
+      v2::LearningModeType lmt;
+      RETURN_IF_FAIL(get_learning_mode(learning_mode, lmt, status));
+
+      generic_event::payload_type_t payload_type;
+      RETURN_IF_FAIL(multi_slot_model_type_to_payload_type(_model_type, payload_type, status));
+
+      const std::vector<int> baseline_actions;
+      generic_event_logger::event_batch batch;
+      batch.reserve(event_ids.size());
+      for (size_t i = 0; i < event_ids.size(); ++i)
+      {
+        RETURN_IF_FAIL(_v2->add_to_batch(batch, event_ids[i], contexts[i], payload_type, _ext_p, _serializer_multislot,
+            status, flags, action_ids[i], pdfs[i], model_versions[i], slot_ids[i], baseline_actions, lmt));
+      }
+      return _v2->log_batch(std::move(batch), status);
+    }
+    default:
+      return protocol_not_supported(status);
+  }
+}
+
 int interaction_logger_facade::log_continuous_action(
     string_view context, unsigned int flags, const continuous_action_response& response, api_status* status)
 {
@@ -230,7 +305,7 @@ observation_logger_facade::observation_logger_facade(const utility::configuratio
     , _v2(_version == 2 ? new generic_event_logger(time_provider,
                               create_legacy_async_batcher<generic_event>(
                                   c, sender, watchdog, perror_cb, OBSERVATION_SECTION, _serializer_shared_state),
-                              c.get(name::APP_ID, ""))
+                              c.get(name::APP_ID, ""), serialize_on_caller(c, OBSERVATION_SECTION))
                         : nullptr)
 {
 }
@@ -363,7 +438,7 @@ episode_logger_facade::episode_logger_facade(const utility::configuration& c, i_
     , _v2(_version == 2 ? new generic_event_logger(time_provider,
                               create_legacy_async_batcher<generic_event>(
                                   c, sender, watchdog, perror_cb, OBSERVATION_SECTION, _serializer_shared_state),
-                              c.get(name::APP_ID, ""))
+                              c.get(name::APP_ID, ""), serialize_on_caller(c, OBSERVATION_SECTION))
                         : nullptr)
 {
 }
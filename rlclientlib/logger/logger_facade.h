@@ -40,6 +40,10 @@ public:
   int log(string_view context, unsigned int flags, const ranking_response& response, api_status* status,
       learning_mode learning_mode = ONLINE);
 
+  // CB v1/v2, under v1 the batch is enqueued at once
+  int log_batch(const std::vector<string_view>& contexts, unsigned int flags,
+      const std::vector<ranking_response>& responses, api_status* status, learning_mode learning_mode = ONLINE);
+
   int log_decisions(std::vector<const char*>& event_ids, string_view context, unsigned int flags,
       const std::vector<std::vector<uint32_t>>& action_ids, const std::vector<std::vector<float>>& pdfs,
       const std::string& model_version, api_status* status);
@@ -50,6 +54,13 @@ public:
       const std::string& model_version, const std::vector<std::string>& slot_ids, api_status* status,
       const std::vector<int>& baseline_actions, learning_mode learning_mode = ONLINE);
 
+  // Multislot batch, under v1 the batch is enqueued at once
+  int log_decision_batch(const std::vector<const char*>& event_ids, const std::vector<string_view>& contexts,
+      unsigned int flags, const std::vector<std::vector<std::vector<uint32_t>>>& action_ids,
+      const std::vector<std::vector<std::vector<float>>>& pdfs, const std::vector<std::string>& model_versions,
+      const std::vector<std::vector<std::string>>& slot_ids, api_status* status,
+      learning_mode learning_mode = ONLINE);
+
   // Continuous
   int log_continuous_action(
       string_view context, unsigned int flags, const continuous_action_response& response, api_status* status);
@@ -10,7 +10,7 @@ bool preamble::write_to_bytes(uint8_t* buffer, size_t buffersz) const
 {
   if (buffersz < size()) { return false; }
 
-  buffer[0] = reserved;
+  buffer[0] = content_encoding;
   buffer[1] = version;
   auto* p_type = reinterpret_cast<uint16_t*>(buffer + 2);
   *p_type = endian::htons(msg_type);
@@ -23,7 +23,7 @@ bool preamble::read_from_bytes(uint8_t* buffer, size_t buffersz)
 {
   if (buffersz < size()) { return false; }
 
-  reserved = buffer[0];
+  content_encoding = buffer[0];
   version = buffer[1];
   auto* p_type = reinterpret_cast<uint16_t*>(buffer + 2);
   msg_type = endian::ntohs(*p_type);
@@ -6,9 +6,18 @@ namespace reinforcement_learning
 {
 namespace logger
 {
+// Values of preamble::content_encoding, only ever add to this list
+struct preamble_content_encoding
+{
+  static const uint8_t IDENTITY = 0;
+  // the whole body is a single zstd frame
+  static const uint8_t ZSTD = 1;
+};
+
 struct preamble
 {
-  uint8_t reserved = 0;
+  // this byte used to be reserved and always 0, which is IDENTITY
+  uint8_t content_encoding = preamble_content_encoding::IDENTITY;
   uint8_t version = 0;
   uint16_t msg_type = 0;
   uint32_t msg_size = 0;
@@ -0,0 +1,302 @@
+#pragma once
+
+#include "constants.h"
+#include "err_constants.h"
+#include "event_queue.h"
+#include "ranking_event.h"
+#include "utility/config_helper.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace reinforcement_learning
+{
+// a bounded multi-producer/single-consumer queue backed by a pre-allocated ring of slots
+// Producers reserve a slot with a CAS on the tail and never take a lock; pop() must only be called by a single
+// consumer thread. If every slot is in use, producers wait for the consumer to release one in BLOCK mode and drop
+// their event in DROP mode, so the number of slots should exceed the number of events logged during one batching
+// interval.
+// Events pushed by value are stored in the slots themselves, avoiding any per-event allocation.
+template <class T>
+class ring_buffer_event_queue : public i_event_queue<T>
+{
+public:
+  using TFunc = typename i_event_queue<T>::TFunc;
+
+private:
+  static constexpr size_t CACHE_LINE_SIZE = 64;
+  // larger slot counts are clamped, the ring is allocated upfront
+  static constexpr uint64_t MAX_SLOTS_COUNT = uint64_t(1) << 30;
+
+  enum slot_state : int
+  {
+    EMPTY,
+    READY,      // published and waiting for the consumer
+    SKIPPED,    // dropped by subsampling, released by the consumer without being handed out
+    CONSUMING,  // owned by the consumer
+    PRUNING,    // owned by prune()
+    PRUNED      // dropped by prune(), released by the consumer without being handed out
+  };
+
+  struct slot
+  {
+    // slot is free for position p when sequence == p, and published for position p when sequence == p + 1
+    std::atomic<uint64_t> sequence{0};
+    std::atomic<int> state{EMPTY};
+    TFunc func;
+    T value;
+    bool has_value{false};
+    size_t item_size{0};
+    T* event{nullptr};
+  };
+
+  const uint64_t _slots_count;
+  const uint64_t _mask;
+  std::unique_ptr<slot[]> _slots;
+  const bool _drop_when_full;
+  size_t _max_capacity{0};
+  events_counter_status _event_counter_status{events_counter_status::DISABLE};
+  float _subsample_rate{1.0f};
+
+  // producers and the consumer each own a cache line so that they do not invalidate each other
+  char _pad0[CACHE_LINE_SIZE];
+  std::atomic<uint64_t> _tail{0};
+  char _pad1[CACHE_LINE_SIZE];
+  std::atomic<uint64_t> _head{0};
+  char _pad2[CACHE_LINE_SIZE];
+  std::atomic<size_t> _size{0};
+  std::atomic<size_t> _capacity{0};
+  char _pad3[CACHE_LINE_SIZE];
+
+  std::mutex _prune_mutex;
+  int _drop_pass{0};
+
+public:
+  ring_buffer_event_queue(size_t max_capacity, size_t slots_count,
+      events_counter_status event_counter_status = events_counter_status::DISABLE, float subsample_rate = 1.0f,
+      queue_mode_enum queue_mode = queue_mode_enum::BLOCK)
+      : _slots_count(round_up_pow2(slots_count))
+      , _mask(_slots_count - 1)
+      , _slots(new slot[_slots_count])
+      , _drop_when_full(queue_mode == queue_mode_enum::DROP)
+      , _max_capacity(max_capacity)
+      , _event_counter_status(event_counter_status)
+      , _subsample_rate(subsample_rate)
+  {
+    for (uint64_t i = 0; i < _slots_count; ++i) { _slots[i].sequence.store(i, std::memory_order_relaxed); }
+  }
+
+  bool pop(T* event, TFunc* item) override
+  {
+    uint64_t pos = _head.load(std::memory_order_relaxed);
+    while (true)
+    {
+      slot& s = _slots[pos & _mask];
+      // the next position is not published yet
+      if (s.sequence.load(std::memory_order_acquire) != pos + 1) { return false; }
+
+      int expected = READY;
+      if (s.state.compare_exchange_strong(expected, CONSUMING, std::memory_order_acq_rel))
+      {
+        if (s.has_value)
+        {
+          *event = std::move(s.value);
+          *item = nullptr;
+        }
+        else
+        {
+          *item = std::move(s.func);
+          s.func = nullptr;
+        }
+        _capacity.fetch_sub(s.item_size);
+        _size.fetch_sub(1);
+        release(s, pos);
+        return true;
+      }
+      // prune() is deciding the fate of this slot, try again on the next call
+      if (expected == PRUNING) { return false; }
+
+      release(s, pos);
+      ++pos;
+    }
+  }
+
+  // Entries pushed by value are handed out wrapped in a function
+  bool pop(TFunc* item)
+  {
+    T value;
+    if (!pop(&value, item)) { return false; }
+    if (!*item)
+    {
+      auto evt_sp = std::make_shared<T>(std::move(value));
+      *item = [evt_sp](T& out_evt, api_status*) -> int {
+        out_evt = std::move(*evt_sp);
+        return error_code::success;
+      };
+    }
+    return true;
+  }
+
+  bool push(TFunc& item, size_t item_size, T* event) { return push(std::move(item), item_size, event); }
+
+  bool push(TFunc&& item, size_t item_size, T* event) override
+  {
+    uint64_t pos;
+    if (!reserve(pos)) { return false; }
+    slot& s = _slots[pos & _mask];
+    if (!admit(s, pos, event)) { return false; }
+
+    s.func = std::move(item);
+    s.has_value = false;
+    publish(s, pos, item_size, event);
+    return true;
+  }
+
+  // The event is moved into the pre-allocated slot, so no allocation happens on this path
+  bool push(T&& event, size_t item_size) override
+  {
+    uint64_t pos;
+    if (!reserve(pos)) { return false; }
+    slot& s = _slots[pos & _mask];
+    if (!admit(s, pos, &event)) { return false; }
+
+    s.value = std::move(event);
+    s.has_value = true;
+    publish(s, pos, item_size, &s.value);
+    return true;
+  }
+
+  // the batch pushes take a slot per event, there is no lock to amortize
+  void push(std::vector<T>&& events, const std::vector<size_t>& item_sizes) override
+  {
+    for (size_t i = 0; i < events.size(); ++i) { push(std::move(events[i]), item_sizes[i]); }
+  }
+
+  void push(std::vector<TFunc>&& items, const std::vector<size_t>& item_sizes, const std::vector<T*>& events) override
+  {
+    for (size_t i = 0; i < items.size(); ++i) { push(std::move(items[i]), item_sizes[i], events[i]); }
+  }
+
+  void prune(float pass_prob) override
+  {
+    if (!is_full()) return;
+    // only one producer prunes at a time, the others can keep going
+    std::unique_lock<std::mutex> lock(_prune_mutex, std::try_to_lock);
+    if (!lock.owns_lock()) return;
+
+    const uint64_t tail = _tail.load(std::memory_order_acquire);
+    for (uint64_t pos = _head.load(std::memory_order_acquire); pos < tail; ++pos)
+    {
+      slot& s = _slots[pos & _mask];
+      if (s.sequence.load(std::memory_order_acquire) != pos + 1) continue;
+
+      int expected = READY;
+      if (!s.state.compare_exchange_strong(expected, PRUNING, std::memory_order_acq_rel)) continue;
+
+      if (s.event->try_drop(pass_prob, _drop_pass))
+      {
+        s.func = nullptr;
+        s.value = T();
+        s.has_value = false;
+        _capacity.fetch_sub(s.item_size);
+        _size.fetch_sub(1);
+        s.state.store(PRUNED, std::memory_order_release);
+      }
+      else
+      {
+        s.state.store(READY, std::memory_order_release);
+      }
+    }
+    ++_drop_pass;
+  }
+
+  // approximate size
+  size_t size() override { return _size.load(); }
+
+  bool is_full() const override { return capacity() >= _max_capacity; }
+
+  size_t capacity() const override { return _capacity.load(); }
+
+  size_t slots_count() const { return static_cast<size_t>(_slots_count); }
+
+private:
+  // returns false if every slot is in use in DROP mode
+  bool reserve(uint64_t& pos)
+  {
+    pos = _tail.load(std::memory_order_relaxed);
+    while (true)
+    {
+      slot& s = _slots[pos & _mask];
+      const auto diff =
+          static_cast<int64_t>(s.sequence.load(std::memory_order_acquire)) - static_cast<int64_t>(pos);
+      if (diff == 0)
+      {
+        if (_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) { return true; }
+      }
+      else if (diff < 0)
+      {
+        if (_drop_when_full) { return false; }
+        // every slot is in use, wait for the consumer to release one
+        std::this_thread::yield();
+        pos = _tail.load(std::memory_order_relaxed);
+      }
+      else
+      {
+        pos = _tail.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // sets the event index and runs subsampling, a dropped event still publishes its slot
+  bool admit(slot& s, uint64_t pos, T* event)
+  {
+    // positions are handed out in order, so they double as the event index
+    if (_event_counter_status == events_counter_status::ENABLE) { event->set_event_index(pos + 1); }
+    // If subsampling rate is < 1, then run subsampling logic
+    if (_subsample_rate < 1)
+    {
+      if (event->try_drop(_subsample_rate, constants::SUBSAMPLE_RATE_DROP_PASS))
+      {
+        // The slot is still published to keep positions contiguous for the consumer
+        s.state.store(SKIPPED, std::memory_order_relaxed);
+        s.sequence.store(pos + 1, std::memory_order_release);
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void publish(slot& s, uint64_t pos, size_t item_size, T* event)
+  {
+    s.item_size = item_size;
+    s.event = event;
+    // counters are updated before publishing so that size() never under-reports what pop() can return
+    _capacity.fetch_add(item_size);
+    _size.fetch_add(1);
+    s.state.store(READY, std::memory_order_release);
+    s.sequence.store(pos + 1, std::memory_order_release);
+  }
+
+  // consumer-only
+  void release(slot& s, uint64_t pos)
+  {
+    s.event = nullptr;
+    s.state.store(EMPTY, std::memory_order_relaxed);
+    s.sequence.store(pos + _slots_count, std::memory_order_release);
+    _head.store(pos + 1, std::memory_order_release);
+  }
+
+  static uint64_t round_up_pow2(size_t value)
+  {
+    uint64_t result = 2;
+    while (result < value && result < MAX_SLOTS_COUNT) { result <<= 1; }
+    return result;
+  }
+};
+}  // namespace reinforcement_learning
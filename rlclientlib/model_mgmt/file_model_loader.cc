@@ -2,6 +2,7 @@
 
 #include "api_status.h"
 #include "err_constants.h"
+#include "trace_logger.h"
 
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -9,8 +10,15 @@
 #include <fstream>
 #include <utility>
 #ifndef _WIN32
+#  include <fcntl.h>
+#  include <sys/mman.h>
 #  include <unistd.h>
 #endif
+#ifdef __linux__
+#  include <cerrno>
+#  include <poll.h>
+#  include <sys/inotify.h>
+#endif
 
 #ifdef _WIN32
 #  define stat _stat
@@ -33,11 +41,18 @@ int file_model_loader::get_file_modified_time(time_t& file_time, api_status* sta
   RETURN_ERROR_LS(_trace, status, file_stats_error) << " file_name = " << _file_name;
 }
 
-file_model_loader::file_model_loader(std::string file_name, bool file_must_exist, i_trace* trace_logger)
-    : _file_name{std::move(file_name)}, _file_must_exist{file_must_exist}, _trace{trace_logger}
+file_model_loader::file_model_loader(
+    std::string file_name, bool file_must_exist, i_trace* trace_logger, bool use_mmap, bool watch)
+    : _file_name{std::move(file_name)}
+    , _file_must_exist{file_must_exist}
+    , _trace{trace_logger}
+    , _use_mmap{use_mmap}
+    , _watch{watch}
 {
 }
 
+file_model_loader::~file_model_loader() { stop_watch(); }
+
 int file_model_loader::init(api_status* status)
 {
   if (_file_must_exist)
@@ -45,11 +60,28 @@ int file_model_loader::init(api_status* status)
     std::ifstream in_strm(_file_name.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
     if (!in_strm.good()) { RETURN_ERROR_LS(_trace, status, file_open_error) << " file_name = " << _file_name; }
   }
+#ifdef _WIN32
+  if (_use_mmap)
+  {
+    TRACE_WARN(_trace, "Memory mapped model files are not supported on this platform, the file will be read.");
+    _use_mmap = false;
+  }
+#endif
+  if (_watch) { RETURN_IF_FAIL(start_watch(status)); }
   return error_code::success;
 }
 
+bool file_model_loader::set_model_changed_callback(std::function<void()> fn)
+{
+  std::lock_guard<std::mutex> lock(_callback_mutex);
+  _model_changed_cb = std::move(fn);
+  return _watch_thread.joinable();
+}
+
 int file_model_loader::get_data(model_data& data, api_status* status)
 {
+  if (_use_mmap) { return get_mapped_data(data, status); }
+
   std::ifstream in_strm(_file_name.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
 
   if (in_strm.good())
@@ -81,5 +113,134 @@ int file_model_loader::get_data(model_data& data, api_status* status)
   return error_code::success;
 }
 
+int file_model_loader::get_mapped_data(model_data& data, api_status* status)
+{
+#ifndef _WIN32
+  const int fd = open(_file_name.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    // File does not exist or cannot open
+    if (_file_must_exist) { RETURN_ERROR_LS(_trace, status, file_open_error) << " file_name = " << _file_name; }
+    return error_code::success;
+  }
+
+  struct stat result
+  {
+  };
+  if (fstat(fd, &result) != 0)
+  {
+    close(fd);
+    RETURN_ERROR_LS(_trace, status, file_stats_error) << " file_name = " << _file_name;
+  }
+
+  const auto curr_file_size = static_cast<size_t>(result.st_size);
+  const auto curr_file_id = static_cast<uint64_t>(result.st_ino);
+  // If the same file has the same size and same timestamp, no need to reload
+  if (result.st_mtime == _last_modified && curr_file_size == _datasz && curr_file_id == _file_id)
+  {
+    close(fd);
+    return error_code::success;
+  }
+
+  if (curr_file_size == 0) { data.alloc(0); }
+  else
+  {
+    void* addr = mmap(nullptr, curr_file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr == MAP_FAILED)
+    {
+      close(fd);
+      RETURN_ERROR_LS(_trace, status, file_read_error) << " file_name = " << _file_name;
+    }
+    // the mapping is released once the last copy of the model data is gone
+    std::shared_ptr<void> mapping(addr, [curr_file_size](void* ptr) { munmap(ptr, curr_file_size); });
+    data.assign_external(static_cast<char*>(addr), curr_file_size, std::move(mapping));
+  }
+  close(fd);
+
+  data.increment_refresh_count();
+  _last_modified = result.st_mtime;
+  _datasz = curr_file_size;
+  _file_id = curr_file_id;
+#endif
+  return error_code::success;
+}
+
+int file_model_loader::start_watch(api_status* status)
+{
+#ifdef __linux__
+  const auto separator = _file_name.find_last_of('/');
+  const std::string directory = separator == std::string::npos ? "." : _file_name.substr(0, separator + 1);
+
+  _inotify_fd = inotify_init1(IN_CLOEXEC);
+  if (_inotify_fd < 0) { RETURN_ERROR_LS(_trace, status, file_open_error) << " inotify, file_name = " << _file_name; }
+  // a model is either written in place or renamed over the watched file
+  if (inotify_add_watch(_inotify_fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0 || pipe(_stop_pipe) != 0)
+  {
+    stop_watch();
+    RETURN_ERROR_LS(_trace, status, file_open_error) << " inotify, directory = " << directory;
+  }
+  _watch_thread = std::thread(&file_model_loader::watch_loop, this);
+#else
+  TRACE_WARN(_trace, "Watching model files is not supported on this platform, the file will be polled.");
+#endif
+  return error_code::success;
+}
+
+void file_model_loader::stop_watch()
+{
+#ifdef __linux__
+  if (_watch_thread.joinable())
+  {
+    const char stop = 0;
+    while (write(_stop_pipe[1], &stop, 1) < 0 && errno == EINTR) {}
+    _watch_thread.join();
+  }
+  for (int* fd : {&_inotify_fd, &_stop_pipe[0], &_stop_pipe[1]})
+  {
+    if (*fd >= 0) { close(*fd); }
+    *fd = -1;
+  }
+#endif
+}
+
+void file_model_loader::watch_loop()
+{
+#ifdef __linux__
+  const auto separator = _file_name.find_last_of('/');
+  const std::string base_name = separator == std::string::npos ? _file_name : _file_name.substr(separator + 1);
+
+  alignas(struct inotify_event) char buffer[4096];
+  pollfd fds[2] = {{_inotify_fd, POLLIN, 0}, {_stop_pipe[0], POLLIN, 0}};
+  while (true)
+  {
+    if (poll(fds, 2, -1) < 0)
+    {
+      if (errno == EINTR) { continue; }
+      TRACE_ERROR(_trace, "Stopped watching the model file, poll failed.");
+      return;
+    }
+    if (fds[1].revents != 0) { return; }
+    if ((fds[0].revents & POLLIN) == 0) { continue; }
+
+    const auto len = read(_inotify_fd, buffer, sizeof(buffer));
+    if (len <= 0) { continue; }
+
+    bool changed = false;
+    for (char* ptr = buffer; ptr < buffer + len;)
+    {
+      const auto* event = reinterpret_cast<const struct inotify_event*>(ptr);
+      if (event->len > 0 && base_name == event->name) { changed = true; }
+      ptr += sizeof(struct inotify_event) + event->len;
+    }
+
+    if (changed)
+    {
+      std::lock_guard<std::mutex> lock(_callback_mutex);
+      if (_model_changed_cb) { _model_changed_cb(); }
+    }
+  }
+#endif
+}
+
 }  // namespace model_management
 }  // namespace reinforcement_learning
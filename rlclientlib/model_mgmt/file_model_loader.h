@@ -1,5 +1,10 @@
 #pragma once
 #include "model_mgmt.h"
+
+#include <functional>
+#include <mutex>
+#include <thread>
+
 namespace reinforcement_learning
 {
 class i_trace;
@@ -12,19 +17,44 @@ namespace model_management
 class file_model_loader : public i_data_transport
 {
 public:
-  file_model_loader(std::string file_name, bool file_must_exist, i_trace* trace_logger);
+  // use_mmap hands a read-only mapping of the file to model_data instead of a copy. The file must then be replaced,
+  // e.g. by renaming the new model over it, rather than rewritten in place.
+  // watch reports changes of the file as they happen (inotify), where supported.
+  file_model_loader(std::string file_name, bool file_must_exist, i_trace* trace_logger, bool use_mmap = false,
+      bool watch = false);
+  ~file_model_loader() override;
+
+  file_model_loader(const file_model_loader&) = delete;
+  file_model_loader& operator=(const file_model_loader&) = delete;
+
   int init(api_status* status = nullptr);
   int get_data(model_data& data, api_status* status = nullptr) override;
+  bool set_model_changed_callback(std::function<void()> fn) override;
 
 private:
   int get_file_modified_time(time_t& file_time, api_status* status) const;
+  int get_mapped_data(model_data& data, api_status* status);
+  int start_watch(api_status* status);
+  void stop_watch();
+  void watch_loop();
 
 private:
   std::string _file_name;
   bool _file_must_exist;
   i_trace* _trace;
+  bool _use_mmap;
+  bool _watch;
   time_t _last_modified = 0;
   size_t _datasz{};
+  // identifies the file behind _file_name, which changes when a new model is renamed over it
+  uint64_t _file_id = 0;
+
+  std::mutex _callback_mutex;
+  std::function<void()> _model_changed_cb;
+  int _inotify_fd = -1;
+  // written to by stop_watch() to wake watch_loop()
+  int _stop_pipe[2] = {-1, -1};
+  std::thread _watch_thread;
 };
 
 }  // namespace model_management
@@ -1,6 +1,10 @@
 #include "model_downloader.h"
 
 #include "api_status.h"
+#include "err_constants.h"
+#include "trace_logger.h"
+
+#include <utility>
 
 namespace reinforcement_learning
 {
@@ -19,6 +23,7 @@ model_downloader::model_downloader(model_downloader&& temp) noexcept
   temp._pdata_cb = nullptr;
   _trace = temp._trace;
   temp._trace = nullptr;
+  _model_data = std::move(temp._model_data);
 }
 
 model_downloader& model_downloader::operator=(model_downloader&& temp) noexcept
@@ -31,16 +36,24 @@ model_downloader& model_downloader::operator=(model_downloader&& temp) noexcept
     temp._pdata_cb = nullptr;
     _trace = temp._trace;
     temp._trace = nullptr;
+    _model_data = std::move(temp._model_data);
   }
   return *this;
 }
 
-int model_downloader::run_iteration(api_status* status) const
+int model_downloader::run_iteration(api_status* status)
 {
-  model_data md;
-  RETURN_IF_FAIL(_ptrans->get_data(md, status));
+  const auto refresh_count = _model_data.refresh_count();
+  RETURN_IF_FAIL(_ptrans->get_data(_model_data, status));
+
+  // transports only increment the refresh count when they downloaded a new model
+  if (_model_data.refresh_count() == refresh_count)
+  {
+    TRACE_INFO(_trace, "Model was not updated since previous download");
+    return error_code::success;
+  }
 
-  const auto scode = _pdata_cb->report_data(md, _trace, status);
+  const auto scode = _pdata_cb->report_data(_model_data, _trace, status);
   return scode;
 }
 }  // namespace model_management
@@ -16,13 +16,15 @@ public:
   model_downloader(model_downloader&& temp) noexcept;
   model_downloader& operator=(model_downloader&& temp) noexcept;
 
-  int run_iteration(api_status* status) const;
+  int run_iteration(api_status* status);
 
 private:
   // Lifetime of pointers managed by user of this class
   i_data_transport* _ptrans = nullptr;
   data_callback_fn* _pdata_cb = nullptr;
   i_trace* _trace;
+  // kept across iterations so that transports can download into the buffer of the previous model
+  model_data _model_data;
 };
 }  // namespace model_management
 }  // namespace reinforcement_learning
@@ -1,5 +1,8 @@
 #include "model_mgmt.h"
 
+#include "api_status.h"
+#include "err_constants.h"
+
 #include <cstring>
 #include <new>
 
@@ -9,18 +12,31 @@ namespace model_management
 {
 model_data::model_data() = default;
 
-// copy constructor: allocate new memory and copy over other's data
+// copy constructor: allocate new memory and copy over other's data, read-only external memory is shared instead
 model_data::model_data(model_data const& other)
-    : _data(new char[other._data_sz]), _data_sz(other._data_sz), _refresh_count(other._refresh_count)
+    : _data_sz(other._data_sz), _refresh_count(other._refresh_count), _external_owner(other._external_owner)
 {
+  if (_external_owner != nullptr)
+  {
+    _data = other._data;
+    return;
+  }
+  _data = new char[other._data_sz];
+  _capacity = other._data_sz;
   if (_data_sz > 0) { std::memcpy(_data, other._data, _data_sz); }
 }
 
 // move constructor: take other's data pointer and set original pointer to null
 model_data::model_data(model_data&& other) noexcept
-    : _data(other._data), _data_sz(other._data_sz), _refresh_count(other._refresh_count)
+    : _data(other._data)
+    , _data_sz(other._data_sz)
+    , _capacity(other._capacity)
+    , _refresh_count(other._refresh_count)
+    , _external_owner(std::move(other._external_owner))
 {
   other._data = nullptr;
+  other._data_sz = 0;
+  other._capacity = 0;
 }
 
 // pass-by-value assignment operator
@@ -28,7 +44,9 @@ model_data& model_data::operator=(model_data other) noexcept
 {
   std::swap(_data, other._data);
   std::swap(_data_sz, other._data_sz);
+  std::swap(_capacity, other._capacity);
   std::swap(_refresh_count, other._refresh_count);
+  std::swap(_external_owner, other._external_owner);
   return *this;
 }
 
@@ -44,14 +62,34 @@ uint32_t model_data::refresh_count() const { return _refresh_count; }
 
 void model_data::data_sz(const size_t fillsz) { _data_sz = fillsz; }
 
+size_t model_data::capacity() const { return _capacity; }
+
+void model_data::assign_external(char* data, size_t sz, std::shared_ptr<void> owner)
+{
+  free();
+  _data = data;
+  _data_sz = sz;
+  _external_owner = std::move(owner);
+}
+
 char* model_data::alloc(const size_t desired)
 {
+  // external memory cannot be written to
+  if (_external_owner != nullptr) { free(); }
+
+  if (_data != nullptr && desired <= _capacity)
+  {
+    _data_sz = desired;
+    return _data;
+  }
+
   // wrap the allocation in a unique_ptr for exception safety
   std::unique_ptr<char> data_new(new char[desired]);
   char* data_new_ptr = data_new.get();
   std::swap(_data, data_new_ptr);
   data_new.release();
   _data_sz = desired;
+  _capacity = desired;
 
   // after swap, data_new_ptr now holds the original _data ptr
   if (data_new_ptr != nullptr)
@@ -65,13 +103,50 @@ char* model_data::alloc(const size_t desired)
 
 void model_data::free()
 {
+  if (_external_owner != nullptr)
+  {
+    _external_owner.reset();
+    _data = nullptr;
+  }
   if (_data != nullptr)
   {
     delete[] _data;
     _data = nullptr;
   }
   _data_sz = 0;
+  _capacity = 0;
 }
 
+int i_model::choose_rank_batch(const std::vector<const char*>& event_ids, const std::vector<uint64_t>& rnd_seeds,
+    const std::vector<string_view>& features, std::vector<std::vector<int>>& action_ids,
+    std::vector<std::vector<float>>& action_pdfs, std::vector<std::string>& model_versions, api_status* status)
+{
+  action_ids.resize(features.size());
+  action_pdfs.resize(features.size());
+  model_versions.resize(features.size());
+  for (size_t i = 0; i < features.size(); ++i)
+  {
+    RETURN_IF_FAIL(choose_rank(
+        event_ids[i], rnd_seeds[i], features[i], action_ids[i], action_pdfs[i], model_versions[i], status));
+  }
+  return error_code::success;
+}
+
+int i_model::request_multi_slot_decision_batch(const std::vector<const char*>& event_ids,
+    const std::vector<std::vector<std::string>>& slot_ids, const std::vector<string_view>& features,
+    std::vector<std::vector<std::vector<uint32_t>>>& actions_ids,
+    std::vector<std::vector<std::vector<float>>>& action_pdfs, std::vector<std::string>& model_versions,
+    api_status* status)
+{
+  actions_ids.resize(features.size());
+  action_pdfs.resize(features.size());
+  model_versions.resize(features.size());
+  for (size_t i = 0; i < features.size(); ++i)
+  {
+    RETURN_IF_FAIL(request_multi_slot_decision(
+        event_ids[i], slot_ids[i], features[i], actions_ids[i], action_pdfs[i], model_versions[i], status));
+  }
+  return error_code::success;
+}
 }  // namespace model_management
 }  // namespace reinforcement_learning
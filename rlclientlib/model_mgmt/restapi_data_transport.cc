@@ -52,51 +52,6 @@ restapi_data_transport::restapi_data_transport(
  * x-ms-version = 2017-04-17
  */
 
-int restapi_data_transport::get_data_info(
-    ::utility::datetime& last_modified, ::utility::size64_t& sz, api_status* status)
-{
-  // Get request URI and start the request.
-  http_request request(_method_type);
-  RETURN_IF_FAIL(add_authentiction_header(request.headers(), status));
-  // Build request URI and start the request.
-  auto request_task = _httpcli->request(request).then([&](http_response response) {
-    if (response.status_code() != 200)
-    {
-      // if the call using HEAD fails, try with GET only once and return the results of GET request call
-      if (_retry_get_data)
-      {
-        _retry_get_data = false;
-        _method_type = methods::GET;
-        RETURN_IF_FAIL(get_data_info(last_modified, sz, status));
-        return error_code::success;
-      }
-
-      RETURN_ERROR_ARG(_trace, status, http_bad_status_code, "Found: ", response.status_code(), _httpcli->get_url());
-    }
-    const auto iter = response.headers().find(U("Last-Modified"));
-    if (iter == response.headers().end())
-    { RETURN_ERROR_ARG(_trace, status, last_modified_not_found, _httpcli->get_url()); }
-
-    last_modified = ::utility::datetime::from_string(iter->second);
-    if (last_modified.to_interval() == 0)
-    { RETURN_ERROR_ARG(_trace, status, last_modified_invalid, _httpcli->get_url()); }
-
-    sz = response.headers().content_length();
-
-    return error_code::success;
-  });
-
-  // Wait for all the outstanding I/O to complete and handle any exceptions
-  try
-  {
-    return request_task.get();
-  }
-  catch (const std::exception& e)
-  {
-    RETURN_ERROR_LS(_trace, status, exception_during_http_req) << e.what() << "\n URL: " << _httpcli->get_url();
-  }
-}
-
 int restapi_data_transport::add_authentiction_header(http_headers& header, api_status* status)
 {
   if (_model_source != model_source::AZURE)
@@ -107,18 +62,29 @@ int restapi_data_transport::add_authentiction_header(http_headers& header, api_s
   return error_code::success;
 }
 
+void restapi_data_transport::add_conditional_headers(http_headers& header) const
+{
+  // the server answers 304 without a body when the model did not change
+  if (!_etag.empty()) { header.add(header_names::if_none_match, _etag); }
+  if (_last_modified.is_initialized())
+  { header.add(header_names::if_modified_since, _last_modified.to_string(::utility::datetime::RFC_1123)); }
+}
+
+bool restapi_data_transport::is_current_model(
+    const http_headers& header, const ::utility::datetime& last_modified) const
+{
+  // for servers that ignore the conditional headers
+  const auto iter = header.find(header_names::etag);
+  if (iter != header.end() && !_etag.empty()) { return iter->second == _etag; }
+  return last_modified == _last_modified && header.content_length() == _datasz;
+}
+
 int restapi_data_transport::get_data(model_data& ret, api_status* status)
 {
-  ::utility::datetime curr_last_modified;
-  ::utility::size64_t curr_datasz = 0;
-  _method_type = methods::HEAD;
-  _retry_get_data = true;
-  RETURN_IF_FAIL(get_data_info(curr_last_modified, curr_datasz, status));
-
-  if (curr_last_modified == _last_modified && curr_datasz == _datasz) { return error_code::success; }
-  _method_type = methods::GET;
-  http_request request(_method_type);
+  // a single conditional GET replaces the HEAD + GET pair
+  http_request request(methods::GET);
   RETURN_IF_FAIL(add_authentiction_header(request.headers(), status));
+  add_conditional_headers(request.headers());
   // Build request URI and start the request.
   auto request_task =
       _httpcli
@@ -126,7 +92,8 @@ int restapi_data_transport::get_data(model_data& ret, api_status* status)
           // Handle response headers arriving.
           .then([&](const pplx::task<http_response>& resp_task) {
             auto response = resp_task.get();
-            if (response.status_code() != 200)
+            if (response.status_code() == status_codes::NotModified) { return error_code::success; }
+            if (response.status_code() != status_codes::OK)
             {
               RETURN_ERROR_ARG(
                   _trace, status, http_bad_status_code, "Found: ", response.status_code(), _httpcli->get_url());
@@ -136,7 +103,7 @@ int restapi_data_transport::get_data(model_data& ret, api_status* status)
             if (iter == response.headers().end())
             { RETURN_ERROR_ARG(_trace, status, last_modified_not_found, _httpcli->get_url()); }
 
-            curr_last_modified = ::utility::datetime::from_string(iter->second);
+            const auto curr_last_modified = ::utility::datetime::from_string(iter->second);
             if (curr_last_modified.to_interval() == 0)
             {
               RETURN_ERROR_ARG(_trace, status, last_modified_invalid,
@@ -144,9 +111,12 @@ int restapi_data_transport::get_data(model_data& ret, api_status* status)
                   _httpcli->get_url());
             }
 
-            curr_datasz = response.headers().content_length();
+            if (is_current_model(response.headers(), curr_last_modified)) { return error_code::success; }
+
+            const auto curr_datasz = response.headers().content_length();
             if (curr_datasz > 0)
             {
+              // the body is streamed straight into the buffer of the previous model when it is large enough
               auto* const buff = ret.alloc(curr_datasz);
               const Concurrency::streams::rawptr_buffer<char> rb(buff, curr_datasz, std::ios::out);
 
@@ -164,6 +134,8 @@ int restapi_data_transport::get_data(model_data& ret, api_status* status)
             }
 
             _last_modified = curr_last_modified;
+            const auto etag = response.headers().find(header_names::etag);
+            _etag = etag != response.headers().end() ? etag->second : ::utility::string_t();
             return error_code::success;
           });
 
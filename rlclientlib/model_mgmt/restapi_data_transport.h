@@ -25,16 +25,16 @@ public:
 
 private:
   using time_t = std::chrono::time_point<std::chrono::system_clock>;
-  int get_data_info(::utility::datetime& last_modified, ::utility::size64_t& sz, api_status* status);
   int add_authentiction_header(http_headers& header, api_status* status);
+  void add_conditional_headers(http_headers& header) const;
+  bool is_current_model(const http_headers& header, const ::utility::datetime& last_modified) const;
   std::unique_ptr<i_http_client> _httpcli;
   ::utility::datetime _last_modified;
+  ::utility::string_t _etag;
   uint64_t _datasz;
   i_trace* _trace;
   const utility::configuration _cfg;
   model_source _model_source = model_source::AZURE;
-  method _method_type = methods::HEAD;
-  bool _retry_get_data = true;
   std::unique_ptr<header_authorization> _headerimpl = std::unique_ptr<header_authorization>(new header_authorization());
 };
 }  // namespace model_management
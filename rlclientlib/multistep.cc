@@ -2,30 +2,156 @@
 
 #include "err_constants.h"
 
+#include <cctype>
+
 namespace reinforcement_learning
 {
+namespace
+{
+// 64 bit FNV-1a, wide enough for the ids of an episode not to collide
+uint64_t hash_event_id(const char* id)
+{
+  uint64_t hash = 14695981039346656037ULL;
+  for (; *id != '\0'; ++id) { hash = (hash ^ static_cast<unsigned char>(*id)) * 1099511628211ULL; }
+  return hash == 0 ? 1 : hash;
+}
+
+const size_t MIN_SLOTS = 16;
+}  // namespace
+
+episode_history::episode_history(size_t max_size) : _max_size(max_size) {}
+
 void episode_history::update(
     const char* event_id, const char* previous_event_id, string_view context, const ranking_response& resp)
 {
-  _depths[event_id] = this->get_depth(previous_event_id) + 1;
+  const int depth = this->get_depth(previous_event_id) + 1;
+  const uint64_t key = hash_event_id(event_id);
+  const uint64_t sequence = ++_sequence;
+
+  if (_max_size > 0)
+  {
+    if (_window.size() < _max_size) { _window.emplace_back(key, sequence); }
+    else
+    {
+      // the oldest update is dropped, unless the same id was updated again since then
+      erase(_window[_window_next].first, _window[_window_next].second);
+      _window[_window_next] = std::make_pair(key, sequence);
+      _window_next = (_window_next + 1) % _max_size;
+    }
+  }
+
+  insert(key, sequence, depth);
 }
 
 std::string episode_history::get_context(const char* previous_event_id, string_view context) const
 {
-  return R"({"episode":{"depth":")" + std::to_string(this->get_depth(previous_event_id) + 1) + "\"}," +
-      std::string(context.data() + 1);
+  std::string out;
+  get_context(previous_event_id, context, out);
+  return out;
+}
+
+void episode_history::get_context(const char* previous_event_id, string_view context, std::string& out) const
+{
+  static const char prefix[] = R"({"episode":{"depth":")";
+  static const char suffix[] = R"("})";
+
+  char digits[16];
+  char* const end = digits + sizeof(digits);
+  char* begin = end;
+  auto depth = static_cast<unsigned int>(this->get_depth(previous_event_id) + 1);
+  do
+  {
+    *--begin = static_cast<char>('0' + depth % 10);
+    depth /= 10;
+  } while (depth != 0);
+
+  out.clear();
+  out.reserve(sizeof(prefix) + sizeof(digits) + sizeof(suffix) + context.size() + 1);
+  out.append(prefix, sizeof(prefix) - 1);
+  out.append(begin, end - begin);
+  out.append(suffix, sizeof(suffix) - 1);
+  if (context.empty()) { return; }
+
+  // the opening brace of the context is replaced by the episode object, an empty context only closes it
+  size_t members = 1;
+  while (members < context.size() && std::isspace(static_cast<unsigned char>(context[members]))) { ++members; }
+  if (members >= context.size() || context[members] != '}') { out += ','; }
+  out.append(context.data() + members, context.size() - members);
 }
 
 int episode_history::get_depth(const char* id) const
 {
   if (id == nullptr) { return 0; }
-  auto result = _depths.find(id);
-  return (result == _depths.end()) ? 0 : result->second;
+  const auto* result = find(hash_event_id(id));
+  return (result == nullptr) ? 0 : result->depth;
+}
+
+size_t episode_history::size() const { return _size; }
+
+uint64_t episode_history::update_count() const { return _sequence; }
+
+const episode_history::entry* episode_history::find(uint64_t key) const
+{
+  if (_slots.empty()) { return nullptr; }
+  const size_t mask = _slots.size() - 1;
+  for (size_t i = key & mask; _slots[i].key != 0; i = (i + 1) & mask)
+  {
+    if (_slots[i].key == key) { return &_slots[i]; }
+  }
+  return nullptr;
+}
+
+void episode_history::insert(uint64_t key, uint64_t sequence, int depth)
+{
+  // keep the load factor under 3/4
+  if ((_size + 1) * 4 > _slots.size() * 3) { grow(); }
+
+  const size_t mask = _slots.size() - 1;
+  size_t i = key & mask;
+  while (_slots[i].key != 0 && _slots[i].key != key) { i = (i + 1) & mask; }
+  if (_slots[i].key == 0) { ++_size; }
+  _slots[i].key = key;
+  _slots[i].sequence = sequence;
+  _slots[i].depth = depth;
 }
 
-size_t episode_history::size() const { return _depths.size(); }
+void episode_history::erase(uint64_t key, uint64_t sequence)
+{
+  const auto* found = find(key);
+  if (found == nullptr || found->sequence != sequence) { return; }
+
+  // backward shift deletion, so that the probe sequences stay unbroken without tombstones
+  const size_t mask = _slots.size() - 1;
+  size_t hole = static_cast<size_t>(found - _slots.data());
+  for (size_t next = (hole + 1) & mask; _slots[next].key != 0; next = (next + 1) & mask)
+  {
+    // the entry can move to the hole if the hole is between its home slot and where it is now
+    const size_t home = _slots[next].key & mask;
+    if (((next - home) & mask) >= ((next - hole) & mask))
+    {
+      _slots[hole] = _slots[next];
+      hole = next;
+    }
+  }
+  _slots[hole] = entry();
+  --_size;
+}
+
+void episode_history::grow()
+{
+  std::vector<entry> slots(_slots.empty() ? MIN_SLOTS : _slots.size() * 2);
+  std::swap(slots, _slots);
+  _size = 0;
+  for (const auto& e : slots)
+  {
+    if (e.key != 0) { insert(e.key, e.sequence, e.depth); }
+  }
+}
 
-episode_state::episode_state(const char* episode_id) : _episode_id(episode_id) {}
+episode_state::episode_state(const char* episode_id, size_t history_size)
+    : _episode_id(episode_id), _history(history_size)
+{
+}
 
 const char* episode_state::get_episode_id() const { return _episode_id.c_str(); }
 
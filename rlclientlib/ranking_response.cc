@@ -28,6 +28,8 @@ int ranking_response::set_chosen_action_id_unchecked(size_t action_id, api_statu
 
 void ranking_response::push_back(const size_t action_id, const float prob) { _slot_impl.push_back(action_id, prob); }
 
+void ranking_response::reserve(size_t action_count) { _slot_impl.reserve(action_count); }
+
 size_t ranking_response::size() const { return _slot_impl.size(); }
 
 void ranking_response::set_model_id(const char* model_id) { _model_id = model_id; }
@@ -13,6 +13,7 @@ namespace reinforcement_learning
 int populate_response(size_t chosen_action_index, std::vector<int>& action_ids, std::vector<float>& pdf,
     std::string&& model_id, ranking_response& response, i_trace* trace_logger, api_status* status)
 {
+  response.reserve(pdf.size());
   for (size_t idx = 0; idx < pdf.size(); ++idx) { response.push_back(action_ids[idx], pdf[idx]); }
 
   RETURN_IF_FAIL(response.set_chosen_action_id(action_ids[chosen_action_index]));
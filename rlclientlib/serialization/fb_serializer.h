@@ -13,6 +13,7 @@
 
 #include <flatbuffers/flatbuffers.h>
 
+#include <cstring>
 #include <vector>
 
 using namespace reinforcement_learning::messages::flatbuff;
@@ -323,16 +324,16 @@ struct fb_event_serializer<generic_event>
   using offset_vector_t = typename std::vector<flatbuffers::Offset<fb_event_t>>;
   using batch_builder_t = v2::EventBatchBuilder;
 
+  // room left for the fixed size part of the metadata when sizing the builder of a serialized event
+  static const size_t METADATA_SIZE_ESTIMATE = 128;
+
   static size_t size_estimate(const generic_event& evt)
   {
-    return evt.get_payload().size() + evt.get_context_string().size();
+    return evt.get_payload().size() + evt.get_serialized_event().size() + evt.get_context_string().size();
   }
 
-  static int serialize(generic_event& evt, flatbuffers::FlatBufferBuilder& outter_builder,
-      flatbuffers::Offset<fb_event_t>& ret_val, api_status* status)
+  static void create_event(const generic_event& evt, flatbuffers::FlatBufferBuilder& builder)
   {
-    flatbuffers::FlatBufferBuilder builder;
-
     const auto& ts = evt.get_client_time_gmt();
     v2::TimeStamp client_ts(ts.year, ts.month, ts.day, ts.hour, ts.minute, ts.second, ts.sub_second);
     const auto meta_offset = v2::CreateMetadataDirect(builder, evt.get_id(), &client_ts, evt.get_app_id(),
@@ -341,9 +342,41 @@ struct fb_event_serializer<generic_event>
     const auto& buffer = evt.get_payload();
     const auto payload_offset = builder.CreateVector(buffer.data(), buffer.size());
     builder.Finish(v2::CreateEvent(builder, meta_offset, payload_offset));
+  }
+
+  // Builds the v2::Event of a transformed event on the calling thread (transform mode DIRECT).
+  // The batcher then only copies it into the batch, after updating its pass probability in place.
+  static int serialize_event(generic_event& evt, api_status* status)
+  {
+    // sized so that the builder never grows, the buffer is handed to the event without a copy
+    flatbuffers::FlatBufferBuilder builder(
+        evt.get_payload().size() + strlen(evt.get_id()) + strlen(evt.get_app_id()) + METADATA_SIZE_ESTIMATE);
+    // a pass probability equal to the default must still be stored to be mutable
+    builder.ForceDefaults(true);
+    create_event(evt, builder);
+    evt.set_serialized_event(builder.Release());
+    return error_code::success;
+  }
 
-    auto event_buff = builder.Release();
-    const auto evt_offset = outter_builder.CreateVector(event_buff.data(), event_buff.size());
+  static int serialize(generic_event& evt, flatbuffers::FlatBufferBuilder& outter_builder,
+      flatbuffers::Offset<fb_event_t>& ret_val, api_status* status)
+  {
+    flatbuffers::Offset<flatbuffers::Vector<uint8_t>> evt_offset;
+    if (evt.is_serialized())
+    {
+      // the queue can drop events and lower the pass probability of the others after they are serialized
+      auto& event_buff = evt.get_serialized_event();
+      flatbuffers::GetMutableRoot<v2::Event>(event_buff.data())->mutable_meta()->mutate_pass_probability(
+          evt.get_pass_prob());
+      evt_offset = outter_builder.CreateVector(event_buff.data(), event_buff.size());
+    }
+    else
+    {
+      flatbuffers::FlatBufferBuilder builder;
+      create_event(evt, builder);
+      auto event_buff = builder.Release();
+      evt_offset = outter_builder.CreateVector(event_buff.data(), event_buff.size());
+    }
     ret_val = v2::CreateSerializedEvent(outter_builder, evt_offset);
 
     return error_code::success;
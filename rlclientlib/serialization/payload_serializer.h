@@ -17,6 +17,7 @@
 #include "logger/message_type.h"
 #include "ranking_event.h"
 #include "rl_string_view.h"
+#include "slot_ranking.h"
 #include "utility/data_buffer_streambuf.h"
 
 #include <flatbuffers/flatbuffers.h>
@@ -39,7 +40,7 @@ struct payload_serializer
 
 struct cb_serializer : payload_serializer<generic_event::payload_type_t::PayloadType_CB>
 {
-  static generic_event::payload_buffer_t event(const std::string& context_str, unsigned int flags,
+  static generic_event::payload_buffer_t event(string_view context_str, unsigned int flags,
       v2::LearningModeType learning_mode, const std::vector<uint64_t>& action_ids,
       const std::vector<float>& probabilities, const std::string& model_id)
   {
@@ -53,11 +54,39 @@ struct cb_serializer : payload_serializer<generic_event::payload_type_t::Payload
     fbb.Finish(fb);
     return fbb.Release();
   }
+
+  // Same event built from the (action, probability) pairs of a ranking_response, the ids and probabilities are
+  // written into the builder without intermediate vectors. The fields are created in the same order as above.
+  static generic_event::payload_buffer_t event(string_view context_str, unsigned int flags,
+      v2::LearningModeType learning_mode, const std::vector<action_prob>& ranking, const std::string& model_id)
+  {
+    flatbuffers::FlatBufferBuilder fbb;
+
+    // the pointers returned by CreateUninitializedVector are only valid until the builder allocates again
+    uint64_t* action_ids = nullptr;
+    const auto action_ids_offset = fbb.CreateUninitializedVector(ranking.size(), &action_ids);
+    for (size_t i = 0; i < ranking.size(); ++i)
+    { flatbuffers::WriteScalar(action_ids + i, static_cast<uint64_t>(ranking[i].action_id + 1)); }
+
+    const auto context_offset =
+        fbb.CreateVector(reinterpret_cast<const uint8_t*>(context_str.data()), context_str.size());
+
+    float* probabilities = nullptr;
+    const auto probabilities_offset = fbb.CreateUninitializedVector(ranking.size(), &probabilities);
+    for (size_t i = 0; i < ranking.size(); ++i) { flatbuffers::WriteScalar(probabilities + i, ranking[i].probability); }
+
+    const auto model_id_offset = fbb.CreateString(model_id);
+
+    auto fb = v2::CreateCbEvent(fbb, flags & action_flags::DEFERRED, action_ids_offset, context_offset,
+        probabilities_offset, model_id_offset, learning_mode);
+    fbb.Finish(fb);
+    return fbb.Release();
+  }
 };
 
 struct ca_serializer : payload_serializer<generic_event::payload_type_t::PayloadType_CA>
 {
-  static generic_event::payload_buffer_t event(const std::string& context_str, unsigned int flags, float chosen_action,
+  static generic_event::payload_buffer_t event(string_view context_str, unsigned int flags, float chosen_action,
       float chosen_action_pdf_value, const std::string& model_id)
   {
     flatbuffers::FlatBufferBuilder fbb;
@@ -74,7 +103,7 @@ struct ca_serializer : payload_serializer<generic_event::payload_type_t::Payload
 
 struct multi_slot_serializer : payload_serializer<generic_event::payload_type_t::PayloadType_Slates>
 {
-  static generic_event::payload_buffer_t event(const std::string& context_str, unsigned int flags,
+  static generic_event::payload_buffer_t event(string_view context_str, unsigned int flags,
       const std::vector<std::vector<uint32_t>>& action_ids, const std::vector<std::vector<float>>& pdfs,
       const std::string& model_version, const std::vector<std::string>& slot_ids,
       const std::vector<int>& baseline_actions, v2::LearningModeType learning_mode)
@@ -109,6 +138,21 @@ struct dedup_info_serializer : payload_serializer<generic_event::payload_type_t:
     fbb.Finish(fb);
     return fbb.Release();
   }
+
+  static generic_event::payload_buffer_t event(const std::vector<generic_event::object_id_t>& object_ids,
+      const std::vector<string_view>& object_values, v2::DedupMode mode,
+      const std::vector<generic_event::object_id_t>& evicted_ids, uint64_t sequence, uint64_t client_id)
+  {
+    flatbuffers::FlatBufferBuilder fbb;
+    std::vector<flatbuffers::Offset<flatbuffers::String>> vals;
+    vals.reserve(object_values.size());
+
+    for (auto sv : object_values) { vals.push_back(fbb.CreateString(sv.data(), sv.size())); }
+
+    auto fb = v2::CreateDedupInfoDirect(fbb, &object_ids, &vals, mode, &evicted_ids, sequence, client_id);
+    fbb.Finish(fb);
+    return fbb.Release();
+  }
 };
 
 struct outcome_serializer : payload_serializer<generic_event::payload_type_t::PayloadType_Outcome>
@@ -191,7 +235,7 @@ struct outcome_serializer : payload_serializer<generic_event::payload_type_t::Pa
 
 struct multistep_serializer : payload_serializer<generic_event::payload_type_t::PayloadType_MultiStep>
 {
-  static generic_event::payload_buffer_t event(const std::string& context_str, const std::string& previous_id,
+  static generic_event::payload_buffer_t event(string_view context_str, const std::string& previous_id,
       unsigned int flags, const std::vector<uint64_t>& action_ids, const std::vector<float>& probabilities,
       const std::string& event_id, const std::string& model_id)
   {
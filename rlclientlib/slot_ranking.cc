@@ -32,6 +32,8 @@ int slot_ranking::set_chosen_action_id_unchecked(size_t action_id, api_status* /
 
 void slot_ranking::push_back(const size_t action_id, const float prob) { _ranking.emplace_back(action_id, prob); }
 
+void slot_ranking::reserve(size_t action_count) { _ranking.reserve(action_count); }
+
 size_t slot_ranking::size() const { return _ranking.size(); }
 
 void slot_ranking::clear()
@@ -17,6 +17,21 @@ queue_mode_enum to_queue_mode_enum(const char* queue_mode)
   return queue_mode_enum::DROP;
 }
 
+queue_implementation_enum to_queue_implementation_enum(const char* queue_implementation)
+{
+  if (_stricmp(queue_implementation, value::QUEUE_IMPLEMENTATION_RING_BUFFER) == 0)
+  { return queue_implementation_enum::RING_BUFFER; }
+  return queue_implementation_enum::LIST;
+}
+
+transform_mode_enum to_transform_mode_enum(const char* transform_mode)
+{
+  if (_stricmp(transform_mode, value::TRANSFORM_MODE_CALLER) == 0) { return transform_mode_enum::CALLER; }
+  if (_stricmp(transform_mode, value::TRANSFORM_MODE_POOL) == 0) { return transform_mode_enum::POOL; }
+  if (_stricmp(transform_mode, value::TRANSFORM_MODE_DIRECT) == 0) { return transform_mode_enum::DIRECT; }
+  return transform_mode_enum::BATCHER;
+}
+
 namespace utility
 {
 static int get_int(const configuration& config, const char* section, const char* property, int defval)
@@ -76,8 +91,17 @@ async_batcher_config get_batcher_config(const configuration& config, const char*
   res.send_batch_interval_ms = get_int(config, section, name::SEND_BATCH_INTERVAL_MS, 1000);
   res.send_queue_max_capacity = get_int(config, section, name::SEND_QUEUE_MAX_CAPACITY_KB, 16 * 1024) * 1024;
   res.queue_mode = to_queue_mode_enum(get_str(config, section, name::QUEUE_MODE, value::QUEUE_MODE_DROP));
+  res.queue_implementation = to_queue_implementation_enum(
+      get_str(config, section, name::QUEUE_IMPLEMENTATION, value::QUEUE_IMPLEMENTATION_LIST));
+  res.queue_ring_buffer_slots =
+      get_int(config, section, name::QUEUE_RING_BUFFER_SLOTS, value::DEFAULT_QUEUE_RING_BUFFER_SLOTS);
+  res.transform_mode =
+      to_transform_mode_enum(get_str(config, section, name::TRANSFORM_MODE, value::TRANSFORM_MODE_BATCHER));
+  res.transform_threads = get_int(config, section, name::TRANSFORM_THREADS, value::DEFAULT_TRANSFORM_THREADS);
   res.batch_content_encoding = config.get_bool(section, name::USE_DEDUP, false) ? value::CONTENT_ENCODING_DEDUP
                                                                                 : value::CONTENT_ENCODING_IDENTITY;
+  res.batch_compression = config.get_bool(section, name::BATCH_COMPRESSION, false);
+  res.batch_compression_level = config.get_int(name::ZSTD_COMPRESSION_LEVEL, value::DEFAULT_ZSTD_COMPRESSION_LEVEL);
   res.subsample_rate = get_float(config, section, name::SUBSAMPLE_RATE, 1.f);
   res.event_counter_status = get_counter_status(config, section);
   return res;
@@ -88,6 +112,11 @@ async_batcher_config::async_batcher_config()
     , send_batch_interval_ms(1000)
     , send_queue_max_capacity(16 * 1024 * 1024)
     , queue_mode(queue_mode_enum::DROP)
+    , queue_implementation(queue_implementation_enum::LIST)
+    , queue_ring_buffer_slots(value::DEFAULT_QUEUE_RING_BUFFER_SLOTS)
+    , transform_mode(transform_mode_enum::BATCHER)
+    , transform_threads(value::DEFAULT_TRANSFORM_THREADS)
+    , batch_compression_level(value::DEFAULT_ZSTD_COMPRESSION_LEVEL)
     , event_counter_status(events_counter_status::DISABLE)
 {
 }
@@ -10,6 +10,22 @@ enum class queue_mode_enum
   BLOCK  // queue block if it is full
 };
 
+// this enum selects the queue implementation used by the async_batcher
+enum class queue_implementation_enum
+{
+  LIST,        // mutex protected linked list (default)
+  RING_BUFFER  // bounded lock-free multi-producer/single-consumer ring buffer
+};
+
+// this enum selects the thread that transforms the events logged as functions (dedup, serialization, compression)
+enum class transform_mode_enum
+{
+  BATCHER,  // the batcher thread while it fills a batch (default)
+  CALLER,   // the thread that appends the event
+  POOL,     // a pool of worker threads, started once, that the batcher thread hands each run of popped events to
+  DIRECT    // like CALLER, and v2 events are also serialized into their final flatbuffer by the thread that logs them
+};
+
 // this enum sets the counter for number of events behaviour in aysnc_batcher
 enum class events_counter_status
 {
@@ -30,9 +46,15 @@ struct async_batcher_config
   int send_batch_interval_ms;
   int send_queue_max_capacity;
   queue_mode_enum queue_mode;
+  queue_implementation_enum queue_implementation;
+  int queue_ring_buffer_slots;
+  transform_mode_enum transform_mode;
+  int transform_threads;
   // bool use_compression;
   // bool use_dedup;
   const char* batch_content_encoding{};
+  bool batch_compression = false;
+  int batch_compression_level;
   float subsample_rate = 1.f;  // percentage of kept events. 0 = drop all events, 1 = keep all events
   events_counter_status event_counter_status;
 };
@@ -3,9 +3,10 @@
 #include "err_constants.h"
 
 #include <object_factory.h>
-#include <rapidjson/document.h>
 #include <rapidjson/error/en.h>
+#include <rapidjson/memorystream.h>
 #include <rapidjson/prettywriter.h>
+#include <rapidjson/reader.h>
 
 #include <chrono>
 #include <cstring>
@@ -21,76 +22,20 @@ namespace rj = rapidjson;
 
 const auto multi = "_multi";
 const auto slots = "_slots";
-const auto event_id = "_id";
 const auto slot_id = "_id";
 
-/**
- * \brief Get the event IDs from the slots entries in the context json string.
- *
- * \param context   : String with context json
- * \param event_ids : Reference to the mapping from slot index to event ID string, results will be
- *                    put in here
- * \param trace     : Pointer to the trace logger
- * \param status    : Pointer to api_status object that contains an error code and error description in
- *                    case of failure
- * \return  error_code::success if there are no errors.  If there are errors then the error code is
- *          returned.
- */
-int get_event_ids(string_view context, std::map<size_t, std::string>& event_ids, i_trace* trace, api_status* status)
-{
-  try
-  {
-    rj::Document obj;
-    // obj.Parse expects zero terminated c-style string
-    std::string copy(context);
-    obj.Parse(copy.c_str());
-
-    if (obj.HasParseError())
-    {
-      RETURN_ERROR_LS(trace, status, json_parse_error)
-          << "JSON parse error: " << rj::GetParseError_En(obj.GetParseError()) << " (" << obj.GetErrorOffset() << ")";
-    }
-
-    const rj::Value::ConstMemberIterator& itr = obj.FindMember(slots);
-    if (itr != obj.MemberEnd() && itr->value.IsArray())
-    {
-      const auto& arr = itr->value.GetArray();
-      for (rj::SizeType i = 0; i < arr.Size(); ++i)
-      {
-        const auto& current = arr[i];
-        const auto member_itr = current.FindMember(event_id);
-        if (member_itr != current.MemberEnd() && member_itr->value.IsString())
-        {
-          const auto event_id_string = std::string(member_itr->value.GetString());
-          event_ids[i] = std::string{event_id_string.begin(), event_id_string.end()};
-        }
-      }
-
-      return error_code::success;
-    }
-    RETURN_ERROR_LS(trace, status, json_no_slots_found);
-  }
-  catch (const std::exception& e)
-  {
-    RETURN_ERROR_LS(trace, status, json_parse_error) << e.what();
-  }
-  catch (...)
-  {
-    RETURN_ERROR_LS(trace, status, json_parse_error) << error_code::unknown_s;
-  }
-}
-
 struct MessageHandler : public rj::BaseReaderHandler<rj::UTF8<>, MessageHandler>
 {
-  rj::InsituStringStream& _is;
+  rj::MemoryStream& _is;
   ContextInfo& _info;
   int _level = 0;
   int _array_level = 0;
   bool _is_multi = false;
   bool _is_slots = false;
+  bool _is_slot_id = false;
   size_t _item_start = 0;
 
-  MessageHandler(rj::InsituStringStream& is, ContextInfo& info) : _is(is), _info(info) {}
+  MessageHandler(rj::MemoryStream& is, ContextInfo& info) : _is(is), _info(info) {}
 
   bool Key(const char* str, size_t length, bool copy)
   {
@@ -99,11 +44,29 @@ struct MessageHandler : public rj::BaseReaderHandler<rj::UTF8<>, MessageHandler>
       _is_multi = (strcmp(str, multi) == 0);
       _is_slots = (strcmp(str, slots) == 0);
     }
+    // the "_id" at the top level of a slot object
+    _is_slot_id = _is_slots && _level == 2 && _array_level == 1 && strcmp(str, slot_id) == 0;
+    return true;
+  }
+
+  bool String(const char* str, size_t length, bool copy)
+  {
+    // the first _id of the slot wins, like a DOM lookup
+    if (_is_slot_id) { _info.slot_ids.emplace(_info.slots.size(), std::string(str, length)); }
+    _is_slot_id = false;
+    return true;
+  }
+
+  // numbers, booleans and nulls
+  bool Default()
+  {
+    _is_slot_id = false;
     return true;
   }
 
   bool StartObject()
   {
+    _is_slot_id = false;
     if (((static_cast<int>(_is_multi) | static_cast<int>(_is_slots)) != 0) && _level == 1 && _array_level == 1)
     { _item_start = _is.Tell() - 1; }
 
@@ -126,6 +89,7 @@ struct MessageHandler : public rj::BaseReaderHandler<rj::UTF8<>, MessageHandler>
 
   bool StartArray()
   {
+    _is_slot_id = false;
     ++_array_level;
     return true;
   }
@@ -137,17 +101,30 @@ struct MessageHandler : public rj::BaseReaderHandler<rj::UTF8<>, MessageHandler>
   }
 };
 
+/**
+ * \brief Scan the context json once for the _multi and _slots elements and the _id of each slot.
+ *
+ * The context is read in place, it is neither copied nor required to be null terminated.
+ *
+ * \param context : String with context json
+ * \param info    : Offsets of the actions and slots, and the slot ids found, results will be put in here
+ * \param trace   : Pointer to the trace logger
+ * \param status  : Pointer to api_status object that contains an error code and error description in
+ *                  case of failure
+ * \return  error_code::success if there are no errors.  If there are errors then the error code is
+ *          returned.
+ */
 int get_context_info(string_view context, ContextInfo& info, i_trace* trace, api_status* status)
 {
-  std::string copy(context);
   info.actions.clear();
   info.slots.clear();
+  info.slot_ids.clear();
 
-  rj::InsituStringStream iss((char*)copy.c_str());
-  MessageHandler mh(iss, info);
+  rj::MemoryStream ms(context.data(), context.size());
+  MessageHandler mh(ms, info);
 
   rj::Reader reader;
-  auto res = reader.Parse<rj::kParseInsituFlag>(iss, mh);
+  auto res = reader.Parse(ms, mh);
   if (res.IsError())
   {
     std::ostringstream os;
@@ -157,34 +134,218 @@ int get_context_info(string_view context, ContextInfo& info, i_trace* trace, api
   return error_code::success;
 }
 
-int get_slot_ids(string_view context, const ContextInfo::index_vector_t& slots, std::map<size_t, std::string>& slot_ids,
+struct ActionHandler : public rj::BaseReaderHandler<rj::UTF8<>, ActionHandler>
+{
+  rj::MemoryStream& _is;
+  void (*_on_action)(void*, size_t, size_t);
+  void* _on_action_context;
+  int _level = 0;
+  int _array_level = 0;
+  bool _is_multi = false;
+  size_t _item_start = 0;
+
+  ActionHandler(rj::MemoryStream& is, void (*on_action)(void*, size_t, size_t), void* on_action_context)
+      : _is(is), _on_action(on_action), _on_action_context(on_action_context)
+  {
+  }
+
+  bool Key(const char* str, size_t length, bool copy)
+  {
+    if (_level == 1 && _array_level == 0) { _is_multi = (strcmp(str, multi) == 0); }
+    return true;
+  }
+
+  bool StartObject()
+  {
+    if (_is_multi && _level == 1 && _array_level == 1) { _item_start = _is.Tell() - 1; }
+
+    ++_level;
+    return true;
+  }
+
+  bool EndObject(rj::SizeType memberCount)
+  {
+    --_level;
+
+    if (_is_multi && _level == 1 && _array_level == 1)
+    { _on_action(_on_action_context, _item_start, _is.Tell() - _item_start); }
+    return true;
+  }
+
+  bool StartArray()
+  {
+    ++_array_level;
+    return true;
+  }
+
+  bool EndArray(rj::SizeType elementCount)
+  {
+    --_array_level;
+    return true;
+  }
+};
+
+int for_each_action(string_view context, void (*on_action)(void*, size_t, size_t), void* on_action_context,
     i_trace* trace, api_status* status)
 {
-  for (size_t i = 0; i < slots.size(); i++)
+  rj::MemoryStream ms(context.data(), context.size());
+  ActionHandler ah(ms, on_action, on_action_context);
+
+  rj::Reader reader;
+  auto res = reader.Parse(ms, ah);
+  if (res.IsError())
   {
-    try
-    {
-      rj::Document obj;
-      obj.Parse(std::string(context.data() + slots[i].first, slots[i].second).c_str());
+    std::ostringstream os;
+    os << "JSON parse error: " << rj::GetParseError_En(res.Code()) << " (" << res.Offset() << ")";
+    RETURN_ERROR_LS(trace, status, json_parse_error) << os.str();
+  }
+  return error_code::success;
+}
+
+struct PdfHandler : public rj::BaseReaderHandler<rj::UTF8<>, PdfHandler>
+{
+  std::vector<float>& _pdf;
+  int _level = 0;
+  int _array_level = 0;
+  bool _is_pdf = false;
+  bool _in_pdf = false;
+  bool _invalid_pdf = false;
 
-      if (obj.HasParseError())
-      {
-        RETURN_ERROR_LS(trace, status, json_parse_error)
-            << "JSON parse error: " << rj::GetParseError_En(obj.GetParseError()) << " (" << obj.GetErrorOffset() << ")";
-      }
+  explicit PdfHandler(std::vector<float>& pdf) : _pdf(pdf) {}
 
-      const rj::Value::ConstMemberIterator& itr = obj.FindMember(slot_id);
-      if (itr != obj.MemberEnd() && itr->value.IsString()) { slot_ids[i] = std::string(itr->value.GetString()); }
-    }
-    catch (const std::exception& e)
+  bool Key(const char* str, size_t length, bool copy)
+  {
+    if (_level == 1 && _array_level == 0)
     {
-      RETURN_ERROR_LS(trace, status, json_parse_error) << e.what();
+      _is_pdf = (length == 1 && str[0] == 'p') || (length == 2 && str[0] == '_' && str[1] == 'p');
     }
-    catch (...)
+    return true;
+  }
+
+  bool add(double value)
+  {
+    if (_in_pdf) { _pdf.push_back(static_cast<float>(value)); }
+    return true;
+  }
+
+  bool Int(int i) { return add(i); }
+  bool Uint(unsigned u) { return add(u); }
+  bool Int64(int64_t i) { return add(static_cast<double>(i)); }
+  bool Uint64(uint64_t u) { return add(static_cast<double>(u)); }
+  bool Double(double d) { return add(d); }
+
+  // strings, booleans and nulls
+  bool Default()
+  {
+    _invalid_pdf = _in_pdf;
+    return !_invalid_pdf;
+  }
+
+  bool StartObject()
+  {
+    _invalid_pdf = _in_pdf;
+    ++_level;
+    return !_invalid_pdf;
+  }
+
+  bool EndObject(rj::SizeType memberCount)
+  {
+    --_level;
+    return true;
+  }
+
+  bool StartArray()
+  {
+    _invalid_pdf = _in_pdf;
+    if (_is_pdf && _level == 1 && _array_level == 0)
     {
-      RETURN_ERROR_LS(trace, status, json_parse_error) << error_code::unknown_s;
+      // the last pdf of the context wins
+      _pdf.clear();
+      _in_pdf = true;
     }
+    ++_array_level;
+    return !_invalid_pdf;
+  }
+
+  bool EndArray(rj::SizeType elementCount)
+  {
+    --_array_level;
+    _in_pdf = false;
+    return true;
+  }
+};
+
+/**
+ * \brief Get the pdf of a passthrough context, the "p" or "_p" array at the root of the context json.
+ *
+ * The context is parsed in a single pass without being copied, and no VW example is built.
+ *
+ * \param context    : String with context json, it does not need to be null terminated
+ * \param action_ids : Position of each probability in the pdf array
+ * \param pdf        : The probabilities, in the order of the pdf array
+ * \param trace      : Pointer to the trace logger
+ * \param status     : Pointer to api_status object that contains an error code and error description in
+ *                     case of failure
+ * \return  error_code::success if there are no errors.  If there are errors then the error code is
+ *          returned.
+ */
+int get_pdf(string_view context, std::vector<int>& action_ids, std::vector<float>& pdf, i_trace* trace,
+    api_status* status)
+{
+  action_ids.clear();
+  pdf.clear();
+
+  rj::MemoryStream ms(context.data(), context.size());
+  PdfHandler ph(pdf);
+
+  rj::Reader reader;
+  auto res = reader.Parse(ms, ph);
+  if (ph._invalid_pdf)
+  {
+    pdf.clear();
+    RETURN_ERROR_LS(trace, status, json_parse_error) << "The pdf must be an array of numbers (" << res.Offset() << ")";
+  }
+  if (res.IsError())
+  {
+    pdf.clear();
+    std::ostringstream os;
+    os << "JSON parse error: " << rj::GetParseError_En(res.Code()) << " (" << res.Offset() << ")";
+    RETURN_ERROR_LS(trace, status, json_parse_error) << os.str();
+  }
+
+  action_ids.resize(pdf.size());
+  for (size_t i = 0; i < pdf.size(); ++i) { action_ids[i] = static_cast<int>(i); }
+  return error_code::success;
+}
+
+int add_actions(string_view shared_context, const std::vector<string_view>& actions, std::string& context,
+    i_trace* trace, api_status* status)
+{
+  const auto is_space = [](char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; };
+  size_t begin = 0;
+  size_t end = shared_context.size();
+  while (begin < end && is_space(shared_context[begin])) { ++begin; }
+  while (end > begin && is_space(shared_context[end - 1])) { --end; }
+  if (end - begin < 2 || shared_context[begin] != '{' || shared_context[end - 1] != '}')
+  { RETURN_ERROR_LS(trace, status, json_parse_error) << "The shared context must be a json object"; }
+
+  // everything up to the closing brace of the shared object
+  size_t members_end = end - 1;
+  while (members_end > begin + 1 && is_space(shared_context[members_end - 1])) { --members_end; }
+
+  size_t size = members_end - begin + 12;
+  for (const auto& action : actions) { size += action.size() + 1; }
+  context.clear();
+  context.reserve(size);
+  context.append(shared_context.data() + begin, members_end - begin);
+  if (members_end > begin + 1) { context += ','; }
+  context += "\"_multi\":[";
+  for (size_t i = 0; i < actions.size(); ++i)
+  {
+    if (i > 0) { context += ','; }
+    context.append(actions[i].data(), actions[i].size());
   }
+  context += "]}";
   return error_code::success;
 }
 }  // namespace utility
@@ -3,6 +3,8 @@
 #include "rl_string_view.h"
 
 #include <map>
+#include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -21,11 +23,32 @@ struct ContextInfo
   index_vector_t actions;
   //! The index to each element in the _slots array
   index_vector_t slots;
+  //! The string _id of the slots that have one, by index in the _slots array
+  std::map<size_t, std::string> slot_ids;
 };
 
-int get_event_ids(string_view context, std::map<size_t, std::string>& event_ids, i_trace* trace, api_status* status);
 int get_context_info(string_view context, ContextInfo& info, i_trace* trace = nullptr, api_status* status = nullptr);
-int get_slot_ids(string_view context, const ContextInfo::index_vector_t& slots, std::map<size_t, std::string>& slot_ids,
+//! Calls on_action(on_action_context, offset, length) for each element of the _multi array, in document order.
+//! The context is parsed in a single pass without being copied.
+int for_each_action(string_view context, void (*on_action)(void*, size_t, size_t), void* on_action_context,
+    i_trace* trace = nullptr, api_status* status = nullptr);
+//! Same as above for any callable taking the offset and length, which is called without being type erased.
+template <typename F>
+int for_each_action(string_view context, F&& on_action, i_trace* trace = nullptr, api_status* status = nullptr)
+{
+  using callable_t = typename std::remove_reference<F>::type;
+  return for_each_action(
+      context,
+      [](void* callable, size_t start, size_t length) { (*static_cast<callable_t*>(callable))(start, length); },
+      const_cast<void*>(static_cast<const void*>(&on_action)), trace, status);
+}
+//! Reads the pdf passed in the "p" or "_p" array of the context, without building VW examples.
+//! The action ids are the positions in the array. Both vectors are left empty when the context has no pdf.
+int get_pdf(string_view context, std::vector<int>& action_ids, std::vector<float>& pdf, i_trace* trace = nullptr,
+    api_status* status = nullptr);
+//! Writes to context the shared_context object with a _multi array made of the actions, in order.
+//! The shared context must be a json object without a _multi array, it is not otherwise validated.
+int add_actions(string_view shared_context, const std::vector<string_view>& actions, std::string& context,
     i_trace* trace = nullptr, api_status* status = nullptr);
 }  // namespace utility
 }  // namespace reinforcement_learning
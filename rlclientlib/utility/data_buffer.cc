@@ -22,6 +22,7 @@ void data_buffer::reset()
   _buffer.resize(_preamble_size + 1);
   _body_beginoffset = _preamble_size;
   _body_endoffset = _preamble_size;
+  _content_encoding = 0;
 }
 
 data_buffer::value_type* data_buffer::raw_begin() { return _buffer.data(); }
@@ -70,5 +71,9 @@ void data_buffer::resize_body_region(size_t size)
 data_buffer::value_type* data_buffer::preamble_begin() { return _buffer.data() + _body_beginoffset - _preamble_size; }
 
 size_t data_buffer::preamble_size() const { return _preamble_size; }
+
+uint8_t data_buffer::content_encoding() const { return _content_encoding; }
+
+void data_buffer::set_content_encoding(uint8_t encoding) { _content_encoding = encoding; }
 }  // namespace utility
 }  // namespace reinforcement_learning
@@ -0,0 +1,124 @@
+#include "event_id_generator.h"
+
+#include "constants.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <thread>
+
+#ifndef _WIN32
+#  define _stricmp strcasecmp
+#endif
+
+namespace reinforcement_learning
+{
+namespace utility
+{
+namespace
+{
+uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+uint64_t splitmix64(uint64_t& x)
+{
+  uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+class xoshiro256
+{
+public:
+  xoshiro256()
+  {
+    // the thread and the time are mixed in for the platforms where random_device is deterministic
+    std::random_device device;
+    uint64_t seed = (static_cast<uint64_t>(device()) << 32) ^ device();
+    seed ^= std::hash<std::thread::id>()(std::this_thread::get_id());
+    seed ^= static_cast<uint64_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+    for (auto& word : _state) { word = splitmix64(seed); }
+  }
+
+  uint64_t next()
+  {
+    const uint64_t result = rotl(_state[1] * 5, 7) * 9;
+    const uint64_t t = _state[1] << 17;
+    _state[2] ^= _state[0];
+    _state[3] ^= _state[1];
+    _state[1] ^= _state[2];
+    _state[0] ^= _state[3];
+    _state[2] ^= t;
+    _state[3] = rotl(_state[3], 45);
+    return result;
+  }
+
+private:
+  uint64_t _state[4];
+};
+
+xoshiro256& thread_generator()
+{
+  static thread_local xoshiro256 generator;
+  return generator;
+}
+
+void write_hex(char*& out, uint64_t value, int digits)
+{
+  static const char hex[] = "0123456789abcdef";
+  for (int shift = 4 * (digits - 1); shift >= 0; shift -= 4) { *out++ = hex[(value >> shift) & 0xf]; }
+}
+}  // namespace
+
+event_id_kind to_event_id_kind(const char* kind)
+{
+  if (_stricmp(kind, value::EVENT_ID_TIME_ORDERED) == 0) { return event_id_kind::TIME_ORDERED; }
+  return event_id_kind::RANDOM;
+}
+
+event_id_generator::event_id_generator(event_id_kind kind) : _kind(kind) {}
+
+void event_id_generator::generate(char* id) const
+{
+  auto& generator = thread_generator();
+  uint64_t high = generator.next();
+  uint64_t low = generator.next();
+
+  if (_kind == event_id_kind::TIME_ORDERED)
+  {
+    const auto now = std::chrono::system_clock::now().time_since_epoch();
+    const auto ms = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(now).count());
+    // 48 bits of time, the version and 12 random bits
+    high = (ms << 16) | (high & 0x0fffULL) | 0x7000ULL;
+  }
+  else
+  {
+    high = (high & ~0xf000ULL) | 0x4000ULL;
+  }
+  // RFC 4122 variant
+  low = (low & 0x3fffffffffffffffULL) | 0x8000000000000000ULL;
+
+  // 8-4-4-4-12 hex digits, like boost::uuids::to_string
+  char* out = id;
+  write_hex(out, high >> 32, 8);
+  *out++ = '-';
+  write_hex(out, high >> 16, 4);
+  *out++ = '-';
+  write_hex(out, high, 4);
+  *out++ = '-';
+  write_hex(out, low >> 48, 4);
+  *out++ = '-';
+  write_hex(out, low, 12);
+  *out = '\0';
+}
+
+std::string event_id_generator::generate() const
+{
+  char id[EVENT_ID_LENGTH + 1];
+  generate(id);
+  return std::string(id, EVENT_ID_LENGTH);
+}
+}  // namespace utility
+}  // namespace reinforcement_learning
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace reinforcement_learning
+{
+namespace utility
+{
+// number of characters of a generated event id, without the terminating null
+const size_t EVENT_ID_LENGTH = 36;
+
+// this enum selects the ids generated for the decisions that are not given one
+enum class event_id_kind
+{
+  RANDOM,       // random RFC 4122 version 4 ids (default)
+  TIME_ORDERED  // RFC 9562 version 7 ids, the unix time in milliseconds comes first so close events sort close
+};
+
+event_id_kind to_event_id_kind(const char* kind);
+
+// Ids are drawn from a xoshiro256** generator per thread that is seeded once from std::random_device,
+// so generating one takes neither a lock nor a system call. The generator is shared by every
+// event_id_generator of the thread, which only selects the layout of the ids.
+class event_id_generator
+{
+public:
+  explicit event_id_generator(event_id_kind kind = event_id_kind::RANDOM);
+
+  // writes EVENT_ID_LENGTH characters and a terminating null to id
+  void generate(char* id) const;
+  std::string generate() const;
+
+private:
+  event_id_kind _kind;
+};
+}  // namespace utility
+}  // namespace reinforcement_learning
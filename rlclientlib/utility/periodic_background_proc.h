@@ -31,6 +31,8 @@ public:
   // Shutdown and Destructor
   ~periodic_background_proc();
   void stop();
+  // Run the next iteration now instead of at the end of the current interval
+  void run_now();
 
   // Cannot copy, assign
   periodic_background_proc(const periodic_background_proc&) = delete;
@@ -107,6 +109,12 @@ void periodic_background_proc<BgProc>::stop()
   }
 }
 
+template <typename BgProc>
+void periodic_background_proc<BgProc>::run_now()
+{
+  _sleeper.wake();
+}
+
 template <typename BGProc>
 periodic_background_proc<BGProc>::~periodic_background_proc()
 {
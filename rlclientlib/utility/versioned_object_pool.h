@@ -2,9 +2,14 @@
 #include "str_util.h"
 #include "trace_logger.h"
 
+#include <atomic>
+#include <cstdint>
+#include <exception>
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <thread>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -24,11 +29,44 @@ class versioned_object_pool_unsafe
 
 public:
   // Construct object pool given a factory function that allocates new objects when called
-  // Optionally, pre-populate the pool with a given count of objects
-  versioned_object_pool_unsafe(TFactory factory, int objects_count = 0, int version = 0)
+  // Optionally, pre-populate the pool with a given count of objects, spread over build_threads threads.
+  // The factory must be safe to call concurrently when build_threads > 1
+  versioned_object_pool_unsafe(TFactory factory, int objects_count = 0, int version = 0, int build_threads = 1)
       : _version(version), _factory(std::move(factory)), _objects_count(objects_count)
   {
-    for (int i = 0; i < _objects_count; ++i) { _pool.emplace_back(_factory()); }
+    if (build_threads <= 1 || _objects_count <= 1)
+    {
+      for (int i = 0; i < _objects_count; ++i) { _pool.emplace_back(_factory()); }
+      return;
+    }
+
+    _pool.resize(_objects_count, nullptr);
+    std::vector<std::exception_ptr> errors(build_threads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < build_threads && t < _objects_count; ++t)
+    {
+      threads.emplace_back([this, t, build_threads, &errors] {
+        try
+        {
+          for (int i = t; i < _objects_count; i += build_threads) { _pool[i] = _factory(); }
+        }
+        catch (...)
+        {
+          errors[t] = std::current_exception();
+        }
+      });
+    }
+    for (auto& thread : threads) { thread.join(); }
+
+    for (const auto& error : errors)
+    {
+      if (error)
+      {
+        for (auto obj : _pool) { delete obj; }
+        _pool.clear();
+        std::rethrow_exception(error);
+      }
+    }
   }
 
   versioned_object_pool_unsafe(const versioned_object_pool_unsafe&) = delete;
@@ -59,6 +97,13 @@ public:
     return obj;
   }
 
+  // Add an object built outside of the pool, which takes ownership of it
+  void add(TObject* obj)
+  {
+    _objects_count++;
+    _pool.emplace_back(obj);
+  }
+
   // Create a new object with the pool's factory function
   // The object must be returned to the pool along with its version, or else allocated memory will not be freed
   TObject* create()
@@ -86,22 +131,100 @@ public:
   const TFactory& get_factory_function() const { return _factory; }
 };
 
+// Snapshot of the pool usage counters
+struct object_pool_stats
+{
+  // objects handed out by get_or_create(), and by get_pinned() when it had to go to the pool
+  uint64_t acquired = 0;
+  // acquisitions that found the generation mutex already taken
+  uint64_t contended = 0;
+  // objects allocated because the pool was empty
+  uint64_t created = 0;
+  // get_pinned() calls served by the calling thread's cached object without locking
+  uint64_t pinned_hits = 0;
+  // get_pinned() calls that had to refresh the cached object after a factory update
+  uint64_t pinned_refreshes = 0;
+};
+
+// Thread-safe pool of versioned objects
+// Each factory update creates a new generation of objects. The generation is built without holding any lock that
+// get_or_create() needs and is then published with an atomic pointer swap, so readers never wait for a model swap.
+// Objects of an older generation are deleted as they are returned, and the generation itself is freed once its
+// last object is returned.
 template <typename TObject>
 class versioned_object_pool
 {
   using TFactory = std::function<TObject*(void)>;
   using TObjectDeleter = std::function<void(TObject*)>;
   using impl_type = versioned_object_pool_unsafe<TObject>;
-  std::mutex _mutex;
-  std::unique_ptr<impl_type> _impl;
+
+  struct generation
+  {
+    generation(TFactory factory, int objects_count, int version, int build_threads)
+        : pool(std::move(factory), objects_count, version, build_threads)
+    {
+    }
+
+    std::mutex mutex;
+    impl_type pool;
+    bool retired = false;
+  };
+  using generation_ptr = std::shared_ptr<generation>;
+
+  // Object of the current generation kept by a thread between get_pinned() calls
+  struct pinned_slot
+  {
+    generation_ptr gen;
+    TObject* obj = nullptr;
+    bool in_use = false;
+
+    pinned_slot() = default;
+    pinned_slot(const pinned_slot&) = delete;
+    pinned_slot& operator=(const pinned_slot&) = delete;
+    ~pinned_slot() { release(); }
+
+    void release()
+    {
+      if (obj != nullptr) { return_to_generation(*gen, obj); }
+      obj = nullptr;
+      gen.reset();
+    }
+  };
+
+  // Pinned objects of the calling thread, by pool id
+  struct thread_slots
+  {
+    std::unordered_map<uint64_t, pinned_slot> slots;
+    // value of retired_epoch() when the slots were last checked for retired generations
+    uint64_t epoch = 0;
+  };
+
+  // only accessed through std::atomic_load/std::atomic_store
+  generation_ptr _current;
+  // raw pointer of _current, lets get_pinned() check its cached generation without the shared_ptr atomics
+  std::atomic<generation*> _current_raw{nullptr};
+  // serializes concurrent updates, never taken by get_or_create()
+  std::mutex _update_mutex;
+  // unique for the life of the process, unlike the address of the pool
+  const uint64_t _id = next_pool_id()++;
+  int _build_threads;
   i_trace* _trace_logger = nullptr;
 
+  std::atomic<uint64_t> _acquired{0};
+  std::atomic<uint64_t> _contended{0};
+  std::atomic<uint64_t> _created{0};
+  std::atomic<uint64_t> _pinned_hits{0};
+  std::atomic<uint64_t> _pinned_refreshes{0};
+
 public:
   // Construct object pool given a factory function that allocates new objects when called
-  // Optionally, pre-populate the pool with a given count of objects
-  versioned_object_pool(TFactory factory, int init_size = 0, i_trace* trace_logger = nullptr)
-      : _impl(new impl_type(std::move(factory), init_size, 0)), _trace_logger(trace_logger)
+  // Optionally, pre-populate the pool with a given count of objects, built on build_threads threads
+  versioned_object_pool(TFactory factory, int init_size = 0, i_trace* trace_logger = nullptr, int build_threads = 1)
+      : _current(std::make_shared<generation>(std::move(factory), init_size, 0, build_threads))
+      , _build_threads(build_threads)
+      , _trace_logger(trace_logger)
   {
+    _current_raw.store(_current.get(), std::memory_order_release);
   }
 
   versioned_object_pool(const versioned_object_pool&) = delete;
@@ -110,71 +233,203 @@ public:
 
   ~versioned_object_pool()
   {
-    std::lock_guard<std::mutex> lock(_mutex);
-    _impl.reset();
+    // objects still in use are deleted when they are returned
+    retire(std::atomic_load(&_current));
   }
 
   // Retrieve an object from the pool, creating a new one if the pool is empty
   // The object is returned to pool when its std::unique_ptr is destroyed
   std::unique_ptr<TObject, TObjectDeleter> get_or_create()
   {
-    std::lock_guard<std::mutex> lock(_mutex);
-    // in the deleter function, capture a copy of the version at time of object creation
-    int current_version = _impl->version();
+    // the deleter keeps the generation alive until the object is returned
+    generation_ptr gen = std::atomic_load(&_current);
+
+    TObject* pool_obj = acquire_from(*gen);
+
+    return std::unique_ptr<TObject, TObjectDeleter>(
+        pool_obj, [gen](TObject* obj) { return_to_generation(*gen, obj); });
+  }
 
-    // try to get an existing object
-    TObject* pool_obj = _impl->get();
-    if (pool_obj != nullptr)
+  // Retrieve the object pinned to the calling thread for the current generation
+  // The thread keeps the object between calls, so the pool mutex is only taken again after a factory update.
+  // Nested calls on the same thread fall back to get_or_create(). Pinned objects of a retired generation, including
+  // those of destroyed pools, are released on the next get_pinned() call from their thread, or when it exits.
+  std::unique_ptr<TObject, TObjectDeleter> get_pinned()
+  {
+    thread_slots& pinned = pinned_slots();
+    const uint64_t epoch = retired_epoch().load(std::memory_order_acquire);
+    if (pinned.epoch != epoch)
     {
-      TRACE_INFO(_trace_logger,
-          utility::concat(
-              "versioned_object_pool::get_or_create() called: existing object returned, total pool size is ",
-              _impl->size()));
+      release_retired(pinned.slots, _id);
+      pinned.epoch = epoch;
     }
+
+    pinned_slot& slot = pinned.slots[_id];
+    if (slot.in_use) { return get_or_create(); }
+
+    if (slot.obj != nullptr && slot.gen.get() == _current_raw.load(std::memory_order_acquire)) { ++_pinned_hits; }
     else
     {
-      // pool was empty, create a new object
-      pool_obj = _impl->create();
-      TRACE_INFO(_trace_logger,
-          utility::concat(
-              "versioned_object_pool::get_or_create() called: new object created, total pool size is ", _impl->size()));
+      if (slot.obj != nullptr) { ++_pinned_refreshes; }
+      slot.release();
+      generation_ptr gen = std::atomic_load(&_current);
+      slot.obj = acquire_from(*gen);
+      slot.gen = std::move(gen);
     }
 
-#if __cplusplus >= 202002L
-    // C++20 deprecates implicit "this" capture by reference in [=] lambda
-    return std::unique_ptr<TObject, TObjectDeleter>(
-        pool_obj, [=, this](TObject* obj) { this->return_to_pool(obj, current_version); });
-#else
-    return std::unique_ptr<TObject, TObjectDeleter>(
-        pool_obj, [=](TObject* obj) { this->return_to_pool(obj, current_version); });
-#endif
+    slot.in_use = true;
+    // the deleter only captures a raw pointer, so std::function does not allocate
+    pinned_slot* pslot = &slot;
+    return std::unique_ptr<TObject, TObjectDeleter>(slot.obj, [pslot](TObject*) { pslot->in_use = false; });
+  }
+
+  object_pool_stats stats() const
+  {
+    object_pool_stats result;
+    result.acquired = _acquired.load(std::memory_order_relaxed);
+    result.contended = _contended.load(std::memory_order_relaxed);
+    result.created = _created.load(std::memory_order_relaxed);
+    result.pinned_hits = _pinned_hits.load(std::memory_order_relaxed);
+    result.pinned_refreshes = _pinned_refreshes.load(std::memory_order_relaxed);
+    return result;
   }
 
   // Update the pool's factory function and increment version number
-  void update_factory(TFactory new_factory)
+  // The new generation is fully built before it replaces the current one
+  // If given, seed is an already built object of the new generation and takes the place of one factory call
+  void update_factory(TFactory new_factory, std::unique_ptr<TObject> seed = nullptr)
   {
+    std::lock_guard<std::mutex> update_lock(_update_mutex);
+    generation_ptr old_gen = std::atomic_load(&_current);
+
     int objects_count = 0;
     int new_version = 0;
-
-    std::lock_guard<std::mutex> lock(_mutex);
-    objects_count = _impl->size();
-    new_version = _impl->version() + 1;
+    {
+      std::lock_guard<std::mutex> lock(old_gen->mutex);
+      objects_count = old_gen->pool.size();
+      new_version = old_gen->pool.version() + 1;
+    }
 
     TRACE_INFO(
         _trace_logger, utility::concat("versioned_object_pool::update_factory() called: pool size is ", objects_count));
 
-    std::unique_ptr<impl_type> new_impl(new impl_type(std::move(new_factory), objects_count, new_version));
-    _impl.swap(new_impl);
+    const int built_count = (seed != nullptr && objects_count > 0) ? objects_count - 1 : objects_count;
+    auto new_gen = std::make_shared<generation>(std::move(new_factory), built_count, new_version, _build_threads);
+    if (seed != nullptr) { new_gen->pool.add(seed.release()); }
+    std::atomic_store(&_current, new_gen);
+    _current_raw.store(new_gen.get(), std::memory_order_release);
+    retire(old_gen);
   }
 
   // Get a reference to the internal factory std::function
-  const TFactory& get_factory_function() const { return _impl->get_factory_function(); }
+  // The reference is only valid until the next update_factory() call
+  const TFactory& get_factory_function() const { return std::atomic_load(&_current)->pool.get_factory_function(); }
+
+  int version() const { return std::atomic_load(&_current)->pool.version(); }
 
 private:
-  void return_to_pool(TObject* obj, int obj_version)
+  static thread_slots& pinned_slots()
+  {
+    static thread_local thread_slots slots;
+    return slots;
+  }
+
+  static std::atomic<uint64_t>& next_pool_id()
   {
-    std::lock_guard<std::mutex> lock(_mutex);
-    _impl->return_to_pool(obj, obj_version);
+    static std::atomic<uint64_t> id{0};
+    return id;
+  }
+
+  // Bumped whenever a generation is retired, so that threads look for pinned objects to release
+  static std::atomic<uint64_t>& retired_epoch()
+  {
+    static std::atomic<uint64_t> epoch{0};
+    return epoch;
+  }
+
+  // the slot of the calling pool is left to get_pinned(), which refreshes it
+  static void release_retired(std::unordered_map<uint64_t, pinned_slot>& slots, uint64_t caller_id)
+  {
+    for (auto it = slots.begin(); it != slots.end();)
+    {
+      bool retired = false;
+      if (it->first != caller_id && !it->second.in_use && it->second.gen != nullptr)
+      {
+        std::lock_guard<std::mutex> lock(it->second.gen->mutex);
+        retired = it->second.gen->retired;
+      }
+      // the slot of a live pool is created again by its next get_pinned() call
+      if (retired) { it = slots.erase(it); }
+      else { ++it; }
+    }
+  }
+
+  TObject* acquire_from(generation& gen)
+  {
+    TObject* pool_obj = nullptr;
+    int pool_size = 0;
+    bool created = false;
+    {
+      std::unique_lock<std::mutex> lock(gen.mutex, std::try_to_lock);
+      if (!lock.owns_lock())
+      {
+        ++_contended;
+        lock.lock();
+      }
+      // try to get an existing object
+      pool_obj = gen.pool.get();
+      if (pool_obj == nullptr)
+      {
+        // pool was empty, create a new object
+        pool_obj = gen.pool.create();
+        created = true;
+      }
+      pool_size = gen.pool.size();
+    }
+    ++_acquired;
+
+    if (created)
+    {
+      ++_created;
+      TRACE_INFO(_trace_logger,
+          utility::concat(
+              "versioned_object_pool::get_or_create() called: new object created, total pool size is ", pool_size));
+    }
+    else
+    {
+      TRACE_INFO(_trace_logger,
+          utility::concat(
+              "versioned_object_pool::get_or_create() called: existing object returned, total pool size is ",
+              pool_size));
+    }
+    return pool_obj;
+  }
+
+  static void return_to_generation(generation& gen, TObject* obj)
+  {
+    {
+      std::lock_guard<std::mutex> lock(gen.mutex);
+      if (!gen.retired)
+      {
+        gen.pool.return_to_pool(obj, gen.pool.version());
+        return;
+      }
+    }
+    // delete outside of the lock
+    delete obj;
+  }
+
+  static void retire(const generation_ptr& gen)
+  {
+    std::vector<TObject*> idle;
+    {
+      std::lock_guard<std::mutex> lock(gen->mutex);
+      gen->retired = true;
+      // free the idle objects now rather than when the last object in use comes back
+      for (TObject* obj = gen->pool.get(); obj != nullptr; obj = gen->pool.get()) { idle.push_back(obj); }
+    }
+    retired_epoch().fetch_add(1, std::memory_order_release);
+    for (auto obj : idle) { delete obj; }
   }
 };
 }  // namespace utility
@@ -0,0 +1,85 @@
+#include "worker_pool.h"
+
+using namespace reinforcement_learning::utility;
+
+worker_pool::worker_pool(size_t threads) : _errors(threads > 0 ? threads : 1)
+{
+  for (size_t i = 1; i < threads; ++i) { _workers.emplace_back(&worker_pool::work, this, i); }
+}
+
+worker_pool::~worker_pool()
+{
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stop = true;
+  }
+  _start_cv.notify_all();
+  for (auto& worker : _workers) { worker.join(); }
+}
+
+size_t worker_pool::size() const { return _workers.size() + 1; }
+
+void worker_pool::run(size_t chunks, void (*fn)(void*, size_t), void* context)
+{
+  std::unique_lock<std::mutex> run_lock(_run_mutex, std::try_to_lock);
+  if (chunks <= 1 || _workers.empty() || !run_lock.owns_lock())
+  {
+    for (size_t c = 0; c < chunks; ++c) { fn(context, c); }
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _fn = fn;
+    _context = context;
+    _chunks = chunks;
+    _pending = _workers.size();
+    ++_generation;
+  }
+  _start_cv.notify_all();
+
+  run_chunks(0);
+
+  std::exception_ptr error;
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _done_cv.wait(lock, [this] { return _pending == 0; });
+    for (auto& e : _errors)
+    {
+      if (e && !error) { error = e; }
+      e = nullptr;
+    }
+  }
+  if (error) { std::rethrow_exception(error); }
+}
+
+void worker_pool::run_chunks(size_t index)
+{
+  // _fn, _context and _chunks are not modified until every thread is done with the run
+  try
+  {
+    for (size_t c = index; c < _chunks; c += size()) { _fn(_context, c); }
+  }
+  catch (...)
+  {
+    _errors[index] = std::current_exception();
+  }
+}
+
+void worker_pool::work(size_t index)
+{
+  uint64_t generation = 0;
+  std::unique_lock<std::mutex> lock(_mutex);
+  while (true)
+  {
+    _start_cv.wait(lock, [this, generation] { return _stop || _generation != generation; });
+    if (_stop) { return; }
+    generation = _generation;
+
+    lock.unlock();
+    run_chunks(index);
+    lock.lock();
+
+    if (--_pending == 0) { _done_cv.notify_one(); }
+  }
+}
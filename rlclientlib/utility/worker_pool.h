@@ -0,0 +1,66 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace reinforcement_learning
+{
+namespace utility
+{
+// Threads started once and handed runs of chunks through a condition variable.
+// The calling thread takes part in every run, so a pool of size 1 has no worker thread.
+class worker_pool
+{
+public:
+  // threads counts the calling thread, threads - 1 workers are started
+  explicit worker_pool(size_t threads);
+  ~worker_pool();
+
+  // Runs fn(chunk) for every chunk in [0, chunks) and returns once all of them are done.
+  // Chunk c runs on thread c % size(), the caller taking chunk 0. A run started while another one is in
+  // progress is done entirely on its calling thread. The first exception thrown by a chunk is rethrown.
+  template <typename TFunc>
+  void run(size_t chunks, const TFunc& fn);
+  void run(size_t chunks, void (*fn)(void*, size_t), void* context);
+
+  size_t size() const;
+
+  worker_pool(const worker_pool&) = delete;
+  worker_pool(worker_pool&&) = delete;
+  worker_pool& operator=(const worker_pool&) = delete;
+  worker_pool& operator=(worker_pool&&) = delete;
+
+private:
+  void work(size_t index);
+  void run_chunks(size_t index);
+
+  std::vector<std::thread> _workers;
+  std::mutex _run_mutex;  // held by the caller of the current run
+
+  std::mutex _mutex;
+  std::condition_variable _start_cv;
+  std::condition_variable _done_cv;
+  uint64_t _generation = 0;
+  size_t _pending = 0;
+  bool _stop = false;
+
+  // current run, published under _mutex with a new generation
+  void (*_fn)(void*, size_t) = nullptr;
+  void* _context = nullptr;
+  size_t _chunks = 0;
+  std::vector<std::exception_ptr> _errors;
+};
+
+template <typename TFunc>
+void worker_pool::run(size_t chunks, const TFunc& fn)
+{
+  run(
+      chunks, [](void* context, size_t chunk) { (*static_cast<const TFunc*>(context))(chunk); },
+      const_cast<void*>(static_cast<const void*>(&fn)));
+}
+}  // namespace utility
+}  // namespace reinforcement_learning
@@ -1,19 +1,28 @@
 #include "pdf_model.h"
 
+#include "configuration.h"
+#include "constants.h"
 #include "err_constants.h"
 #include "object_factory.h"
 #include "ranking_response.h"
 #include "str_util.h"
 #include "trace_logger.h"
+#include "utility/context_helper.h"
 
 namespace reinforcement_learning
 {
 namespace model_management
 {
-// We construct a VW object here to use the example parser to parse joined dsjson-style examples
-// to extract the PDF.
-pdf_model::pdf_model(i_trace* trace_logger, const utility::configuration& /*unused*/)
-    : _trace_logger(trace_logger), _vw(new safe_vw("--json --quiet --cb_adf"))
+// When enabled, we construct VW objects here to use the example parser to parse joined dsjson-style examples
+// to extract the PDF. The parser keeps per-example state, so concurrent calls each get their own instance.
+// Otherwise the pool stays empty and no VW workspace is ever created.
+pdf_model::pdf_model(i_trace* trace_logger, const utility::configuration& config)
+    : _use_vw_parser(config.get_bool(name::MODEL_PASSTHROUGH_PDF_VW_PARSER, false))
+    , _pin_per_thread(config.get_bool(name::VW_POOL_PIN_PER_THREAD, false))
+    , _vw_pool(safe_vw_factory(std::string("--json --quiet --cb_adf")),
+          _use_vw_parser ? config.get_int(name::VW_POOL_INIT_SIZE, value::DEFAULT_VW_POOL_INIT_SIZE) : 0,
+          trace_logger)
+    , _trace_logger(trace_logger)
 {
 }
 
@@ -26,10 +35,20 @@ int pdf_model::update(const model_data& data, bool& model_ready, api_status* sta
 int pdf_model::choose_rank(const char* event_id, uint64_t rnd_seed, string_view features, std::vector<int>& action_ids,
     std::vector<float>& action_pdf, std::string& model_version, api_status* status)
 {
+  if (!_use_vw_parser)
+  {
+    // the extractor does not throw, it reports malformed contexts through status
+    RETURN_IF_FAIL(utility::get_pdf(features, action_ids, action_pdf, _trace_logger, status));
+    model_version = _model_version;
+    return error_code::success;
+  }
+
   try
   {
+    auto vw = _pin_per_thread ? _vw_pool.get_pinned() : _vw_pool.get_or_create();
+
     // Get a ranked list of action_ids and corresponding pdf
-    _vw->parse_context_with_pdf(features, action_ids, action_pdf);
+    vw->parse_context_with_pdf(features, action_ids, action_pdf);
 
     model_version = _model_version;
 
@@ -68,6 +87,8 @@ int pdf_model::request_multi_slot_decision(const char* event_id, const std::vect
 
 model_type_t pdf_model::model_type() const { return model_type_t::CB; }
 
+utility::object_pool_stats pdf_model::pool_stats() const { return _vw_pool.stats(); }
+
 int pdf_model::choose_rank_multistep(const char* event_id, uint64_t rnd_seed, string_view features,
     const episode_history& history, std::vector<int>& action_ids, std::vector<float>& action_pdf,
     std::string& model_version, api_status* status)
@@ -1,4 +1,5 @@
 #pragma once
+#include "../utility/versioned_object_pool.h"
 #include "model_mgmt.h"
 #include "safe_vw.h"
 
@@ -15,6 +16,9 @@ namespace reinforcement_learning
 {
 namespace model_management
 {
+// Extracts the PDF passed in the context. Safe to call from several threads.
+// The PDF is read by a streaming JSON extractor, unless the VW parser is enabled in which case each call parses
+// with its own pooled VW instance.
 class pdf_model : public i_model
 {
 public:
@@ -35,8 +39,13 @@ public:
       std::string& model_version, api_status* status = nullptr) override;
   model_type_t model_type() const override;
 
+  // Usage counters of the parser pool, to check how often serving threads wait on it
+  utility::object_pool_stats pool_stats() const;
+
 private:
-  std::unique_ptr<safe_vw> _vw;
+  const bool _use_vw_parser;
+  const bool _pin_per_thread;
+  utility::versioned_object_pool<safe_vw> _vw_pool;
   i_trace* _trace_logger;
   // TODO Should we provide some mechanism for the user to inject the model ID?
   // model_version = ??
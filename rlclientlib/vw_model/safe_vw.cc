@@ -11,6 +11,7 @@
 #include <algorithm>
 #include <iostream>
 #include <iterator>
+#include <stdexcept>
 #include <utility>
 
 namespace mm = reinforcement_learning::model_management;
@@ -22,6 +23,8 @@ static const std::string SEED_TAG = "seed=";
 safe_vw::safe_vw(std::shared_ptr<safe_vw> master) : _master(std::move(master))
 {
   _vw = VW::seed_vw_model(_master->_vw, "", nullptr, nullptr);
+  // the model id comes from the model file, which seeded workspaces never read
+  _vw->id = _master->_vw->id;
   init();
 }
 
@@ -53,6 +56,7 @@ safe_vw::~safe_vw()
 {
   // cleanup examples
   for (auto&& ex : _example_pool) { VW::dealloc_examples(ex, 1); }
+  for (auto&& action : _registered_actions) { VW::dealloc_examples(action.second, 1); }
 
   // cleanup VW instance
   reset_source(*_vw, _vw->num_bits);
@@ -121,23 +125,118 @@ void safe_vw::parse_context_with_pdf(string_view context, std::vector<int>& acti
 }
 
 void safe_vw::rank(string_view context, std::vector<int>& actions, std::vector<float>& scores)
+{
+  // copy due to destructive parsing by rapidjson
+  std::string line_vec(context);
+  rank(&line_vec[0], line_vec.size(), actions, scores);
+}
+
+void safe_vw::rank_with_context_buffer(string_view context, std::vector<int>& actions, std::vector<float>& scores)
+{
+  // only allocates when the context is larger than any seen so far by this object
+  _context_buffer.assign(context.begin(), context.end());
+  // rapidjson in situ parsing stops at the null terminator
+  _context_buffer.push_back('\0');
+  rank(_context_buffer.data(), context.size(), actions, scores);
+}
+
+void safe_vw::rank(char* context, size_t len, std::vector<int>& actions, std::vector<float>& scores)
 {
   VW::multi_ex examples;
   examples.push_back(get_or_create_example());
 
-  // copy due to destructive parsing by rapidjson
-  std::string line_vec(context);
+  if (_vw->audit)
+  {
+    _vw->audit_buffer->clear();
+    VW::read_line_json_s<true>(*_vw, examples, context, len, get_or_create_example_f, this);
+  }
+  else
+  {
+    VW::read_line_json_s<false>(*_vw, examples, context, len, get_or_create_example_f, this);
+  }
+
+  predict_ranking(examples, actions, scores);
+}
+
+void safe_vw::rank_registered(string_view shared_context,
+    const std::vector<model_management::registered_action>& actions, uint64_t registry_generation,
+    std::vector<int>& action_ids, std::vector<float>& scores)
+{
+  // an id may have been unregistered and registered again with other features since the actions were cached
+  if (registry_generation != _registry_generation)
+  {
+    clear_registered_actions();
+    _registry_generation = registry_generation;
+  }
+
+  VW::multi_ex examples;
+  examples.push_back(get_or_create_example());
 
+  // the empty _multi array makes the parser label this example as shared
+  _context_buffer.assign(shared_context.begin(), shared_context.end());
+  _context_buffer.push_back('\0');
   if (_vw->audit)
   {
     _vw->audit_buffer->clear();
-    VW::read_line_json_s<true>(*_vw, examples, &line_vec[0], line_vec.size(), get_or_create_example_f, this);
+    VW::read_line_json_s<true>(
+        *_vw, examples, _context_buffer.data(), shared_context.size(), get_or_create_example_f, this);
   }
   else
   {
-    VW::read_line_json_s<false>(*_vw, examples, &line_vec[0], line_vec.size(), get_or_create_example_f, this);
+    VW::read_line_json_s<false>(
+        *_vw, examples, _context_buffer.data(), shared_context.size(), get_or_create_example_f, this);
   }
 
+  for (const auto& action : actions)
+  {
+    auto* ex = get_or_create_example();
+    VW::copy_example_data_with_label(ex, get_registered_action(action));
+    examples.push_back(ex);
+  }
+
+  predict_ranking(examples, action_ids, scores);
+}
+
+const VW::example* safe_vw::get_registered_action(const model_management::registered_action& action)
+{
+  const auto it = _registered_actions.find(action.id);
+  if (it != _registered_actions.end()) { return it->second; }
+
+  // the parser only reads actions inside a _multi array, the first example is the empty shared one
+  std::string json = "{\"_multi\":[";
+  json.append(action.json.data(), action.json.size());
+  json.append("]}");
+
+  VW::multi_ex examples;
+  examples.push_back(get_or_create_example());
+  if (_vw->audit)
+  {
+    VW::read_line_json_s<true>(*_vw, examples, &json[0], json.size(), get_or_create_example_f, this);
+  }
+  else
+  {
+    VW::read_line_json_s<false>(*_vw, examples, &json[0], json.size(), get_or_create_example_f, this);
+  }
+
+  if (examples.size() != 2)
+  {
+    for (auto&& ex : examples) { _example_pool.emplace_back(ex); }
+    throw std::runtime_error("A registered action must be a single json object");
+  }
+
+  _example_pool.emplace_back(examples[0]);
+  _registered_actions.emplace(action.id, examples[1]);
+  return examples[1];
+}
+
+void safe_vw::clear_registered_actions()
+{
+  for (auto&& action : _registered_actions) { _example_pool.emplace_back(action.second); }
+  _registered_actions.clear();
+}
+
+void safe_vw::predict_ranking(VW::multi_ex& examples, std::vector<int>& actions, std::vector<float>& scores)
+{
   // finalize example
   VW::setup_examples(*_vw, examples);
 
@@ -385,6 +484,8 @@ void safe_vw::init()
   }
 }
 
+safe_vw_factory::safe_vw_factory(std::shared_ptr<safe_vw> master) : _master(std::move(master)) {}
+
 safe_vw_factory::safe_vw_factory(std::string command_line) : _command_line(std::move(command_line)) {}
 
 safe_vw_factory::safe_vw_factory(const model_management::model_data& master_data) : _master_data(master_data) {}
@@ -403,6 +504,11 @@ safe_vw_factory::safe_vw_factory(const model_management::model_data&& master_dat
 
 safe_vw* safe_vw_factory::operator()()
 {
+  if (_master != nullptr)
+  {
+    // Construct new vw object sharing the weights of the master
+    return new safe_vw(_master);
+  }
   if ((_master_data.data() != nullptr) && !_command_line.empty())
   {
     // Construct new vw object from raw model data and command line argument
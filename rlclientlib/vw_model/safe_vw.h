@@ -4,6 +4,7 @@
 #include "vw/core/vw.h"
 
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 namespace reinforcement_learning
@@ -14,9 +15,18 @@ class safe_vw
   std::shared_ptr<safe_vw> _master;
   VW::workspace* _vw;
   std::vector<VW::example*> _example_pool;
+  // mutable copy of the context for in situ parsing, reused across calls
+  std::vector<char> _context_buffer;
+  // registered actions parsed by this workspace, by id, copied into the examples of each request
+  std::unordered_map<uint64_t, VW::example*> _registered_actions;
+  // registry generation the cached actions were parsed under, they are dropped when it changes
+  uint64_t _registry_generation = 0;
 
   VW::example* get_or_create_example();
   static VW::example& get_or_create_example_f(void* vw);
+  const VW::example* get_registered_action(const model_management::registered_action& action);
+  void clear_registered_actions();
+  void predict_ranking(VW::multi_ex& examples, std::vector<int>& actions, std::vector<float>& scores);
 
 public:
   safe_vw(std::shared_ptr<safe_vw> master);
@@ -28,6 +38,13 @@ public:
 
   void parse_context_with_pdf(string_view context, std::vector<int>& actions, std::vector<float>& scores);
   void rank(string_view context, std::vector<int>& actions, std::vector<float>& scores);
+  // context must be null terminated at context[len], it is parsed in place and its content is undefined afterwards
+  void rank(char* context, size_t len, std::vector<int>& actions, std::vector<float>& scores);
+  // context is copied into a scratch buffer owned by this object, which keeps its capacity across calls
+  void rank_with_context_buffer(string_view context, std::vector<int>& actions, std::vector<float>& scores);
+  // shared_context has an empty _multi array, actions are parsed once per id and registry generation, then copied
+  void rank_registered(string_view shared_context, const std::vector<model_management::registered_action>& actions,
+      uint64_t registry_generation, std::vector<int>& action_ids, std::vector<float>& scores);
   void choose_continuous_action(string_view context, float& action, float& pdf_value);
   // Used for CCB
   void rank_decisions(const std::vector<const char*>& event_ids, string_view context,
@@ -57,8 +74,11 @@ class safe_vw_factory
 {
   model_management::model_data _master_data;
   std::string _command_line;
+  std::shared_ptr<safe_vw> _master;
 
 public:
+  // Every object created shares the weights of master, only per-instance scratch state is allocated.
+  safe_vw_factory(std::shared_ptr<safe_vw> master);
   // model_data is copied and stored in the factory object.
   safe_vw_factory(std::string command_line);
   safe_vw_factory(const model_management::model_data& master_data);
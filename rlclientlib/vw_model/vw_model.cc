@@ -6,20 +6,58 @@
 #include "ranking_response.h"
 #include "str_util.h"
 
+#include <algorithm>
+#include <chrono>
+#include <exception>
 #include <fstream>
+#include <thread>
 
 namespace reinforcement_learning
 {
 namespace model_management
 {
+namespace
+{
+// Splits [0, count) in up to one contiguous chunk per thread of the pool and runs fn(begin, end) on each of them.
+// Batches smaller than the pool run on fewer threads, a single decision runs on the calling thread.
+template <typename TFunc>
+void for_each_chunk(size_t count, utility::worker_pool& workers, const TFunc& fn)
+{
+  const size_t chunks = (std::min)(count, workers.size());
+  if (chunks <= 1)
+  {
+    fn(0, count);
+    return;
+  }
+
+  const size_t chunk_size = (count + chunks - 1) / chunks;
+  workers.run(chunks, [&fn, count, chunk_size](size_t c) {
+    const size_t begin = c * chunk_size;
+    if (begin < count) { fn(begin, (std::min)(count, begin + chunk_size)); }
+  });
+}
+
+// 0 builds the pool on every core
+int pool_build_threads(int configured)
+{
+  if (configured > 0) { return configured; }
+  return (std::max)(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+}  // namespace
+
 vw_model::vw_model(i_trace* trace_logger, const utility::configuration& config)
     : _audit(config.get_bool(name::AUDIT_ENABLED, false))
+    , _share_weights(config.get_bool(name::VW_POOL_SHARE_WEIGHTS, false))
+    , _pin_per_thread(config.get_bool(name::VW_POOL_PIN_PER_THREAD, false))
+    , _batch_workers(static_cast<size_t>(
+          (std::max)(1, config.get_int(name::VW_BATCH_THREADS, value::DEFAULT_VW_BATCH_THREADS))))
     , _audit_output_path(config.get(name::AUDIT_OUTPUT_PATH, value::DEFAULT_AUDIT_OUTPUT_PATH))
     , _initial_command_line(std::string(config.get(name::MODEL_VW_INITIAL_COMMAND_LINE,
                                 "--cb_explore_adf --json --quiet --epsilon 0.0 --first_only --id N/A")) +
           (_audit ? " --audit" : ""))
     , _vw_pool(safe_vw_factory(_initial_command_line),
-          config.get_int(name::VW_POOL_INIT_SIZE, value::DEFAULT_VW_POOL_INIT_SIZE), trace_logger)
+          config.get_int(name::VW_POOL_INIT_SIZE, value::DEFAULT_VW_POOL_INIT_SIZE), trace_logger,
+          pool_build_threads(config.get_int(name::VW_POOL_BUILD_THREADS, value::DEFAULT_VW_POOL_BUILD_THREADS)))
     , _trace_logger(trace_logger)
 {
 }
@@ -30,27 +68,59 @@ int vw_model::update(const model_data& data, bool& model_ready, api_status* stat
   {
     TRACE_INFO(_trace_logger, utility::concat("Received new model data. With size ", data.data_sz()));
 
+    const auto stats = _vw_pool.stats();
+    TRACE_INFO(_trace_logger,
+        utility::concat("VW pool usage: acquired ", stats.acquired, ", contended ", stats.contended, ", created ",
+            stats.created, ", pinned hits ", stats.pinned_hits, ", pinned refreshes ", stats.pinned_refreshes));
+
     if (data.data_sz() > 0)
     {
-      std::string cmd_line = add_optional_audit_flag(_quiet_commandline_options);
+      using clock_t = std::chrono::steady_clock;
+      const auto start = clock_t::now();
+      model_load_stats load_stats;
 
-      std::unique_ptr<safe_vw> init_vw(new safe_vw(data.data(), data.data_sz(), cmd_line));
-      if (init_vw->is_CB_to_CCB_model_upgrade(_initial_command_line))
-      { cmd_line = add_optional_audit_flag(_upgrade_to_CCB_vw_commandline_options); }
+      std::string cmd_line = add_optional_audit_flag(_quiet_commandline_options);
 
-      safe_vw_factory factory(data, cmd_line);
-      std::unique_ptr<safe_vw> test_vw(factory());
-      if (test_vw->is_compatible(_initial_command_line))
+      // the instance loaded to inspect the model is validated and seeds the new generation, unless the model has to
+      // be reloaded with the CCB upgrade arguments
+      std::unique_ptr<safe_vw> test_vw(new safe_vw(data.data(), data.data_sz(), cmd_line));
+      if (test_vw->is_CB_to_CCB_model_upgrade(_initial_command_line))
       {
-        // safe_vw_factory will create a copy of the model data to use for vw object construction.
-        _vw_pool.update_factory(factory);
-        model_ready = true;
+        cmd_line = add_optional_audit_flag(_upgrade_to_CCB_vw_commandline_options);
+        test_vw.reset(new safe_vw(data.data(), data.data_sz(), cmd_line));
       }
-      else
+      const auto loaded = clock_t::now();
+      load_stats.deserialize_us = std::chrono::duration_cast<std::chrono::microseconds>(loaded - start).count();
+
+      if (!test_vw->is_compatible(_initial_command_line))
       {
         RETURN_ERROR_LS(_trace_logger, status, model_update_error)
             << "Received model is incompatible with initial configuration " << _initial_command_line;
       }
+
+      // the whole generation is built on the pool build threads before it is published
+      if (_share_weights)
+      {
+        // pooled objects only hold scratch state and read the weights of the validated instance
+        _vw_pool.update_factory(safe_vw_factory(std::shared_ptr<safe_vw>(std::move(test_vw))));
+      }
+      else
+      {
+        // safe_vw_factory will create a copy of the model data to use for vw object construction.
+        _vw_pool.update_factory(safe_vw_factory(data, cmd_line), std::move(test_vw));
+      }
+      const auto published = clock_t::now();
+      load_stats.pool_build_us = std::chrono::duration_cast<std::chrono::microseconds>(published - loaded).count();
+      load_stats.total_us = std::chrono::duration_cast<std::chrono::microseconds>(published - start).count();
+
+      TRACE_INFO(_trace_logger,
+          utility::concat("Model loaded in ", load_stats.total_us, "us: deserialize ", load_stats.deserialize_us,
+              "us, pool build ", load_stats.pool_build_us, "us"));
+      {
+        std::lock_guard<std::mutex> lock(_load_stats_mutex);
+        _load_stats = load_stats;
+      }
+      model_ready = true;
     }
   }
   catch (const std::exception& e)
@@ -67,13 +137,52 @@ int vw_model::update(const model_data& data, bool& model_ready, api_status* stat
 
 int vw_model::choose_rank(const char* event_id, uint64_t rnd_seed, string_view features, std::vector<int>& action_ids,
     std::vector<float>& action_pdf, std::string& model_version, api_status* status)
+{
+  return rank(event_id, features, false, action_ids, action_pdf, model_version, status);
+}
+
+int vw_model::choose_rank_with_context_buffer(const char* event_id, uint64_t rnd_seed, string_view features,
+    std::vector<int>& action_ids, std::vector<float>& action_pdf, std::string& model_version, api_status* status)
+{
+  return rank(event_id, features, true, action_ids, action_pdf, model_version, status);
+}
+
+int vw_model::choose_rank_registered(const char* event_id, uint64_t rnd_seed, string_view shared_features,
+    const std::vector<registered_action>& actions, uint64_t registry_generation, string_view features,
+    std::vector<int>& action_ids, std::vector<float>& action_pdf, std::string& model_version, api_status* status)
 {
   try
   {
-    auto vw = _vw_pool.get_or_create();
+    auto vw = acquire_vw();
+
+    vw->rank_registered(shared_features, actions, registry_generation, action_ids, action_pdf);
+
+    if (_audit) { write_audit_log(event_id, vw->get_audit_data()); }
+
+    model_version = vw->id();
+
+    return error_code::success;
+  }
+  catch (const std::exception& e)
+  {
+    RETURN_ERROR_LS(_trace_logger, status, model_rank_error) << e.what();
+  }
+  catch (...)
+  {
+    RETURN_ERROR_LS(_trace_logger, status, model_rank_error) << "Unknown error";
+  }
+}
+
+int vw_model::rank(const char* event_id, string_view features, bool reuse_context_buffer,
+    std::vector<int>& action_ids, std::vector<float>& action_pdf, std::string& model_version, api_status* status)
+{
+  try
+  {
+    auto vw = acquire_vw();
 
     // Get a ranked list of action_ids and corresponding pdf
-    vw->rank(features, action_ids, action_pdf);
+    if (reuse_context_buffer) { vw->rank_with_context_buffer(features, action_ids, action_pdf); }
+    else { vw->rank(features, action_ids, action_pdf); }
 
     if (_audit) { write_audit_log(event_id, vw->get_audit_data()); }
 
@@ -91,6 +200,39 @@ int vw_model::choose_rank(const char* event_id, uint64_t rnd_seed, string_view f
   }
 }
 
+int vw_model::choose_rank_batch(const std::vector<const char*>& event_ids, const std::vector<uint64_t>& rnd_seeds,
+    const std::vector<string_view>& features, std::vector<std::vector<int>>& action_ids,
+    std::vector<std::vector<float>>& action_pdfs, std::vector<std::string>& model_versions, api_status* status)
+{
+  try
+  {
+    action_ids.resize(features.size());
+    action_pdfs.resize(features.size());
+    model_versions.resize(features.size());
+
+    for_each_chunk(features.size(), _batch_workers, [&](size_t begin, size_t end) {
+      // the instance and its scratch buffers are reused for the whole chunk
+      auto vw = _vw_pool.get_or_create();
+      for (size_t i = begin; i < end; ++i)
+      {
+        vw->rank_with_context_buffer(features[i], action_ids[i], action_pdfs[i]);
+        if (_audit) { write_audit_log(event_ids[i], vw->get_audit_data()); }
+        model_versions[i] = vw->id();
+      }
+    });
+
+    return error_code::success;
+  }
+  catch (const std::exception& e)
+  {
+    RETURN_ERROR_LS(_trace_logger, status, model_rank_error) << e.what();
+  }
+  catch (...)
+  {
+    RETURN_ERROR_LS(_trace_logger, status, model_rank_error) << "Unknown error";
+  }
+}
+
 int vw_model::choose_rank_multistep(const char* event_id, uint64_t rnd_seed, string_view features,
     const episode_history& history, std::vector<int>& action_ids, std::vector<float>& action_pdf,
     std::string& model_version, api_status* status)
@@ -103,7 +245,7 @@ int vw_model::choose_continuous_action(
 {
   try
   {
-    auto vw = _vw_pool.get_or_create();
+    auto vw = acquire_vw();
 
     vw->choose_continuous_action(features, action, pdf_value);
 
@@ -127,7 +269,7 @@ int vw_model::request_decision(const std::vector<const char*>& event_ids, string
 {
   try
   {
-    auto vw = _vw_pool.get_or_create();
+    auto vw = acquire_vw();
 
     // Get a ranked list of action_ids and corresponding pdf
     vw->rank_decisions(event_ids, features, actions_ids, action_pdfs);
@@ -152,7 +294,7 @@ int vw_model::request_multi_slot_decision(const char* event_id, const std::vecto
 {
   try
   {
-    auto vw = _vw_pool.get_or_create();
+    auto vw = acquire_vw();
 
     // Get a ranked list of action_ids and corresponding pdf
     vw->rank_multi_slot_decisions(event_id, slot_ids, features, actions_ids, action_pdfs);
@@ -173,6 +315,53 @@ int vw_model::request_multi_slot_decision(const char* event_id, const std::vecto
   }
 }
 
+int vw_model::request_multi_slot_decision_batch(const std::vector<const char*>& event_ids,
+    const std::vector<std::vector<std::string>>& slot_ids, const std::vector<string_view>& features,
+    std::vector<std::vector<std::vector<uint32_t>>>& actions_ids,
+    std::vector<std::vector<std::vector<float>>>& action_pdfs, std::vector<std::string>& model_versions,
+    api_status* status)
+{
+  try
+  {
+    actions_ids.resize(features.size());
+    action_pdfs.resize(features.size());
+    model_versions.resize(features.size());
+
+    for_each_chunk(features.size(), _batch_workers, [&](size_t begin, size_t end) {
+      auto vw = _vw_pool.get_or_create();
+      for (size_t i = begin; i < end; ++i)
+      {
+        vw->rank_multi_slot_decisions(event_ids[i], slot_ids[i], features[i], actions_ids[i], action_pdfs[i]);
+        if (_audit) { write_audit_log(event_ids[i], vw->get_audit_data()); }
+        model_versions[i] = vw->id();
+      }
+    });
+
+    return error_code::success;
+  }
+  catch (const std::exception& e)
+  {
+    RETURN_ERROR_LS(_trace_logger, status, model_rank_error) << e.what();
+  }
+  catch (...)
+  {
+    RETURN_ERROR_LS(_trace_logger, status, model_rank_error) << "Unknown error";
+  }
+}
+
+utility::object_pool_stats vw_model::pool_stats() const { return _vw_pool.stats(); }
+
+vw_model::model_load_stats vw_model::last_load_stats() const
+{
+  std::lock_guard<std::mutex> lock(_load_stats_mutex);
+  return _load_stats;
+}
+
+vw_model::pooled_vw vw_model::acquire_vw()
+{
+  return _pin_per_thread ? _vw_pool.get_pinned() : _vw_pool.get_or_create();
+}
+
 std::string vw_model::add_optional_audit_flag(const std::string& command_line) const
 {
   if (_audit) { return command_line + " --audit"; }
@@ -1,10 +1,14 @@
 #pragma once
 #include "../utility/versioned_object_pool.h"
+#include "../utility/worker_pool.h"
 #include "model_mgmt.h"
 #include "multistep.h"
 #include "safe_vw.h"
 #include "trace_logger.h"
 
+#include <cstdint>
+#include <mutex>
+
 namespace reinforcement_learning
 {
 namespace utility
@@ -28,6 +32,19 @@ public:
   int update(const model_data& data, bool& model_ready, api_status* status = nullptr) override;
   int choose_rank(const char* event_id, uint64_t rnd_seed, string_view features, std::vector<int>& action_ids,
       std::vector<float>& action_pdf, std::string& model_version, api_status* status = nullptr) override;
+  int choose_rank_with_context_buffer(const char* event_id, uint64_t rnd_seed, string_view features,
+      std::vector<int>& action_ids, std::vector<float>& action_pdf, std::string& model_version,
+      api_status* status = nullptr) override;
+  // Every pooled instance parses a registered action the first time it ranks it
+  int choose_rank_registered(const char* event_id, uint64_t rnd_seed, string_view shared_features,
+      const std::vector<registered_action>& actions, uint64_t registry_generation, string_view features,
+      std::vector<int>& action_ids, std::vector<float>& action_pdf, std::string& model_version,
+      api_status* status = nullptr) override;
+  // Each worker thread acquires one pooled instance for its share of the batch
+  int choose_rank_batch(const std::vector<const char*>& event_ids, const std::vector<uint64_t>& rnd_seeds,
+      const std::vector<string_view>& features, std::vector<std::vector<int>>& action_ids,
+      std::vector<std::vector<float>>& action_pdfs, std::vector<std::string>& model_versions,
+      api_status* status = nullptr) override;
   int choose_continuous_action(string_view features, float& action, float& pdf_value, std::string& model_version,
       api_status* status = nullptr) override;
   int request_decision(const std::vector<const char*>& event_ids, string_view features,
@@ -36,19 +53,50 @@ public:
   int request_multi_slot_decision(const char* event_id, const std::vector<std::string>& slot_ids, string_view features,
       std::vector<std::vector<uint32_t>>& actions_ids, std::vector<std::vector<float>>& action_pdfs,
       std::string& model_version, api_status* status = nullptr) override;
+  int request_multi_slot_decision_batch(const std::vector<const char*>& event_ids,
+      const std::vector<std::vector<std::string>>& slot_ids, const std::vector<string_view>& features,
+      std::vector<std::vector<std::vector<uint32_t>>>& actions_ids,
+      std::vector<std::vector<std::vector<float>>>& action_pdfs, std::vector<std::string>& model_versions,
+      api_status* status = nullptr) override;
   int choose_rank_multistep(const char* event_id, uint64_t rnd_seed, string_view features,
       const episode_history& history, std::vector<int>& action_ids, std::vector<float>& action_pdf,
       std::string& model_version, api_status* status = nullptr) override;
   model_type_t model_type() const override;
 
+  // Usage counters of the instance pool, to check how often serving threads wait on it
+  utility::object_pool_stats pool_stats() const;
+
+  // Duration of each stage of the last successful model update, in microseconds
+  struct model_load_stats
+  {
+    // model data loaded into the instance that is validated
+    int64_t deserialize_us = 0;
+    // new pool generation built from the validated instance and published
+    int64_t pool_build_us = 0;
+    int64_t total_us = 0;
+  };
+  model_load_stats last_load_stats() const;
+
 private:
+  using pooled_vw = std::unique_ptr<safe_vw, std::function<void(safe_vw*)>>;
+  // Instance for a single call: pinned to the calling thread when enabled, from the shared pool otherwise
+  pooled_vw acquire_vw();
+  int rank(const char* event_id, string_view features, bool reuse_context_buffer, std::vector<int>& action_ids,
+      std::vector<float>& action_pdf, std::string& model_version, api_status* status);
+
   const bool _audit;
+  const bool _share_weights;
+  const bool _pin_per_thread;
+  // started once, the calling thread takes part in every batch
+  utility::worker_pool _batch_workers;
   const std::string _audit_output_path;
   const std::string _initial_command_line;
   const std::string _quiet_commandline_options{"--json --quiet"};
   const std::string _upgrade_to_CCB_vw_commandline_options{"--ccb_explore_adf --json --quiet"};
   utility::versioned_object_pool<safe_vw> _vw_pool;
   i_trace* _trace_logger;
+  mutable std::mutex _load_stats_mutex;
+  model_load_stats _load_stats;
 };
 }  // namespace model_management
 }  // namespace reinforcement_learning
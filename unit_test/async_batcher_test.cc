@@ -7,10 +7,13 @@
 
 #include "data_buffer.h"
 #include "err_constants.h"
+#include "logger/preamble.h"
 #include "sender.h"
 #include "serialization/json_serializer.h"
 #include "vw/core/vw_math.h"
+#include "zstd.h"
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <vector>
@@ -33,6 +36,23 @@ public:
   i_sender* sender;
 };
 
+// Keeps the raw body and its encoding, to check the batches compressed by the batcher
+class raw_message_sender : public logger::i_message_sender
+{
+  std::vector<std::pair<uint8_t, std::string>>& items;
+
+public:
+  explicit raw_message_sender(std::vector<std::pair<uint8_t, std::string>>& _items) : items(_items) {}
+
+  int send(const uint16_t msg_type, const buffer& db, api_status* status = nullptr) override
+  {
+    items.emplace_back(db->content_encoding(),
+        std::string(reinterpret_cast<char*>(db->body_begin()), db->body_filled_size()));
+    return error_code::success;
+  };
+  int init(api_status* status) override { return error_code::success; };
+};
+
 class test_undroppable_event : public event
 {
 public:
@@ -238,6 +258,60 @@ BOOST_AUTO_TEST_CASE(flush_batches)
   BOOST_CHECK_EQUAL(items[1], expected_batch_1);
 }
 
+BOOST_AUTO_TEST_CASE(flush_compressed_batches)
+{
+  std::vector<std::pair<uint8_t, std::string>> items;
+  auto s = new raw_message_sender(items);
+  error_callback_fn error_fn(expect_no_error, nullptr);
+  utility::watchdog watchdog(nullptr);
+  utility::async_batcher_config config;
+  config.send_batch_interval_ms = static_cast<int>(100000);
+  config.batch_compression = true;
+  int dummy = 0;
+  auto batcher = new logger::async_batcher<test_undroppable_event>(s, watchdog, dummy, &error_fn, config);
+  batcher->init(nullptr);
+
+  std::string expected;
+  for (int i = 0; i < 100; ++i)
+  {
+    const auto id = "similar-event-" + std::to_string(i % 10);
+    batcher->append(test_undroppable_event(id));
+    expected += id + "\n";
+  }
+  delete batcher;  // flush force
+
+  BOOST_REQUIRE_EQUAL(items.size(), 1);
+  BOOST_CHECK(items[0].first == logger::preamble_content_encoding::ZSTD);
+  BOOST_CHECK_LT(items[0].second.size(), expected.size());
+
+  const auto& body = items[0].second;
+  std::string decompressed(ZSTD_getFrameContentSize(body.data(), body.size()), '\0');
+  const auto res = ZSTD_decompress(&decompressed[0], decompressed.size(), body.data(), body.size());
+  BOOST_REQUIRE(!ZSTD_isError(res));
+  BOOST_CHECK_EQUAL(decompressed, expected);
+}
+
+BOOST_AUTO_TEST_CASE(flush_incompressible_batch)
+{
+  std::vector<std::pair<uint8_t, std::string>> items;
+  auto s = new raw_message_sender(items);
+  error_callback_fn error_fn(expect_no_error, nullptr);
+  utility::watchdog watchdog(nullptr);
+  utility::async_batcher_config config;
+  config.send_batch_interval_ms = static_cast<int>(100000);
+  config.batch_compression = true;
+  int dummy = 0;
+  auto batcher = new logger::async_batcher<test_undroppable_event>(s, watchdog, dummy, &error_fn, config);
+  batcher->init(nullptr);
+  batcher->append(test_undroppable_event("a"));
+  delete batcher;  // flush force
+
+  // a zstd frame would be larger than this body, so it is sent as it is
+  BOOST_REQUIRE_EQUAL(items.size(), 1);
+  BOOST_CHECK(items[0].first == logger::preamble_content_encoding::IDENTITY);
+  BOOST_CHECK_EQUAL(items[0].second, "a\n");
+}
+
 // test that the batcher flushes everything before deletion
 BOOST_AUTO_TEST_CASE(flush_after_deletion)
 {
@@ -275,6 +349,145 @@ BOOST_AUTO_TEST_CASE(flush_after_deletion)
   BOOST_CHECK_EQUAL(items[0], expected);
 }
 
+// test that events appended by value are flushed in order with both queue implementations
+BOOST_AUTO_TEST_CASE(flush_events_appended_by_value)
+{
+  for (auto queue_implementation : {queue_implementation_enum::LIST, queue_implementation_enum::RING_BUFFER})
+  {
+    std::vector<std::string> items;
+    auto s = new message_sender(items);
+    utility::watchdog watchdog(nullptr);
+    utility::async_batcher_config config;
+    config.queue_implementation = queue_implementation;
+    config.queue_ring_buffer_slots = 4;
+    int dummy = 0;
+    auto* batcher = new logger::async_batcher<test_undroppable_event>(s, watchdog, dummy, nullptr, config);
+    batcher->init(nullptr);  // Allow periodic_background_proc to start waiting
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    batcher->append(test_undroppable_event("foo"), nullptr);
+    // mix with an event produced by a function
+    {
+      auto bar_evt_sp = std::make_shared<test_undroppable_event>("bar");
+      auto evt_fn = [bar_evt_sp](test_undroppable_event& out_evt, api_status* status) -> int {
+        out_evt = std::move(*bar_evt_sp);
+        return error_code::success;
+      };
+      batcher->append(std::move(evt_fn), bar_evt_sp.get(), nullptr);
+    }
+    batcher->append(test_undroppable_event("baz"), nullptr);
+    delete batcher;
+    BOOST_REQUIRE_EQUAL(items.size(), 1);
+    BOOST_CHECK_EQUAL(items[0], "foo\nbar\nbaz\n");
+  }
+}
+
+BOOST_AUTO_TEST_CASE(flush_events_appended_as_batch)
+{
+  for (auto queue_implementation : {queue_implementation_enum::LIST, queue_implementation_enum::RING_BUFFER})
+  {
+    std::vector<std::string> items;
+    auto s = new message_sender(items);
+    utility::watchdog watchdog(nullptr);
+    utility::async_batcher_config config;
+    config.queue_implementation = queue_implementation;
+    config.queue_ring_buffer_slots = 4;
+    int dummy = 0;
+    auto* batcher = new logger::async_batcher<test_undroppable_event>(s, watchdog, dummy, nullptr, config);
+    batcher->init(nullptr);  // Allow periodic_background_proc to start waiting
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    batcher->append(test_undroppable_event("foo"), nullptr);
+    std::vector<test_undroppable_event> batch;
+    batch.emplace_back("bar");
+    batch.emplace_back("baz");
+    batcher->append(std::move(batch), nullptr);
+    delete batcher;
+    BOOST_REQUIRE_EQUAL(items.size(), 1);
+    BOOST_CHECK_EQUAL(items[0], "foo\nbar\nbaz\n");
+  }
+}
+
+// test that events logged as functions are transformed on the thread selected by the transform mode
+BOOST_AUTO_TEST_CASE(flush_events_with_transform_mode)
+{
+  for (auto transform_mode : {transform_mode_enum::CALLER, transform_mode_enum::POOL, transform_mode_enum::DIRECT})
+  {
+    std::vector<std::string> items;
+    auto s = new message_sender(items);
+    utility::watchdog watchdog(nullptr);
+    utility::async_batcher_config config;
+    config.transform_mode = transform_mode;
+    config.transform_threads = 3;
+    int dummy = 0;
+    auto* batcher = new logger::async_batcher<test_undroppable_event>(s, watchdog, dummy, nullptr, config);
+    batcher->init(nullptr);  // Allow periodic_background_proc to start waiting
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    const auto caller_id = std::this_thread::get_id();
+    // transforms may run on other threads, they are only counted there and checked below
+    std::atomic<int> on_caller{0};
+    std::string expected;
+    for (int i = 0; i < 10; ++i)
+    {
+      const auto id = std::to_string(i);
+      auto evt_sp = std::make_shared<test_undroppable_event>(id);
+      auto evt_fn = [evt_sp, caller_id, &on_caller](test_undroppable_event& out_evt, api_status* status) -> int {
+        if (std::this_thread::get_id() == caller_id) { ++on_caller; }
+        out_evt = std::move(*evt_sp);
+        return error_code::success;
+      };
+      batcher->append(std::move(evt_fn), evt_sp.get(), nullptr);
+      expected += id + "\n";
+    }
+    // counted before the deletion, whose final flush runs on this thread
+    BOOST_CHECK_EQUAL(on_caller.load(), transform_mode == transform_mode_enum::POOL ? 0 : 10);
+    delete batcher;
+    BOOST_REQUIRE_EQUAL(items.size(), 1);
+    BOOST_CHECK_EQUAL(items[0], expected);
+  }
+}
+
+// test that a batch of functions is transformed on the thread selected by the transform mode and keeps its order
+BOOST_AUTO_TEST_CASE(flush_function_batch_with_transform_mode)
+{
+  for (auto transform_mode : {transform_mode_enum::CALLER, transform_mode_enum::POOL, transform_mode_enum::DIRECT})
+  {
+    std::vector<std::string> items;
+    auto s = new message_sender(items);
+    utility::watchdog watchdog(nullptr);
+    utility::async_batcher_config config;
+    config.transform_mode = transform_mode;
+    config.transform_threads = 3;
+    int dummy = 0;
+    auto* batcher = new logger::async_batcher<test_undroppable_event>(s, watchdog, dummy, nullptr, config);
+    batcher->init(nullptr);  // Allow periodic_background_proc to start waiting
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    const auto caller_id = std::this_thread::get_id();
+    std::atomic<int> on_caller{0};
+    std::string expected;
+    std::vector<logger::async_batcher<test_undroppable_event>::TFunc> funcs;
+    std::vector<test_undroppable_event*> events;
+    for (int i = 0; i < 10; ++i)
+    {
+      const auto id = std::to_string(i);
+      auto evt_sp = std::make_shared<test_undroppable_event>(id);
+      funcs.push_back([evt_sp, caller_id, &on_caller](test_undroppable_event& out_evt, api_status* status) -> int {
+        if (std::this_thread::get_id() == caller_id) { ++on_caller; }
+        out_evt = std::move(*evt_sp);
+        return error_code::success;
+      });
+      events.push_back(evt_sp.get());
+      expected += id + "\n";
+    }
+    batcher->append(std::move(funcs), std::move(events), nullptr);
+    // counted before the deletion, whose final flush runs on this thread
+    BOOST_CHECK_EQUAL(on_caller.load(), transform_mode == transform_mode_enum::POOL ? 0 : 10);
+    delete batcher;
+    BOOST_REQUIRE_EQUAL(items.size(), 1);
+    BOOST_CHECK_EQUAL(items[0], expected);
+  }
+}
+
 // test that events are not dropped using the queue_dropping_disable option, even if the queue max capacity is reached
 BOOST_AUTO_TEST_CASE(queue_overflow_do_not_drop_event)
 {
@@ -318,6 +531,46 @@ BOOST_AUTO_TEST_CASE(queue_overflow_do_not_drop_event)
   BOOST_CHECK_EQUAL(expected_output, actual_output);
 }
 
+// same as queue_overflow_do_not_drop_event but backed by the lock-free ring buffer queue
+BOOST_AUTO_TEST_CASE(ring_buffer_queue_overflow_do_not_drop_event)
+{
+  std::vector<std::string> items;
+  auto s = new message_sender(items);
+  error_callback_fn error_fn(expect_no_error, nullptr);
+  utility::watchdog watchdog(nullptr);
+  utility::async_batcher_config config;
+  config.send_high_water_mark = 262143;
+  config.send_batch_interval_ms = 100;
+  config.send_queue_max_capacity = 3;
+  config.queue_mode = queue_mode_enum::BLOCK;
+  config.queue_implementation = queue_implementation_enum::RING_BUFFER;
+  config.queue_ring_buffer_slots = 4;
+  int dummy = 0;
+  auto batcher = new logger::async_batcher<test_droppable_event>(s, watchdog, dummy, &error_fn, config);
+  batcher->init(nullptr);  // Allow periodic_background_proc to start waiting
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  int n = 10;
+  for (int i = 0; i < n; ++i)
+  {
+    auto evt_sp = std::make_shared<test_droppable_event>(std::to_string(i));
+    auto evt_fn = [evt_sp](test_droppable_event& out_evt, api_status* status) -> int {
+      out_evt = std::move(*evt_sp);
+      return error_code::success;
+    };
+    batcher->append(std::move(evt_fn), evt_sp.get(), nullptr);
+  }  // triggers a final flush
+  delete batcher;
+  std::string expected_output;
+  for (int i = 0; i < n; ++i)
+  {
+    expected_output += std::to_string(i);
+    expected_output.append("\n");
+  }
+  std::string actual_output;
+  for (const auto& item : items) { actual_output.append(item); }
+  BOOST_CHECK_EQUAL(expected_output, actual_output);
+}
+
 BOOST_AUTO_TEST_CASE(queue_config_drop_rate_test)
 {
   std::vector<std::string> items;
@@ -382,3 +635,50 @@ BOOST_AUTO_TEST_CASE(get_batcher_config_counter_status_test)
   batcher_config = utility::get_batcher_config(config, OBSERVATION_SECTION);
   BOOST_ASSERT(batcher_config.event_counter_status == events_counter_status::DISABLE);
 }
+
+BOOST_AUTO_TEST_CASE(get_batcher_config_queue_implementation_test)
+{
+  utility::configuration config;
+  utility::async_batcher_config batcher_config = utility::get_batcher_config(config, INTERACTION_SECTION);
+  BOOST_CHECK(batcher_config.queue_implementation == queue_implementation_enum::LIST);
+  config.set("interaction.queue.implementation", "RING_BUFFER");
+  config.set("interaction.queue.ring_buffer.slots", "1024");
+  batcher_config = utility::get_batcher_config(config, INTERACTION_SECTION);
+  BOOST_CHECK(batcher_config.queue_implementation == queue_implementation_enum::RING_BUFFER);
+  BOOST_CHECK_EQUAL(batcher_config.queue_ring_buffer_slots, 1024);
+  batcher_config = utility::get_batcher_config(config, OBSERVATION_SECTION);
+  BOOST_CHECK(batcher_config.queue_implementation == queue_implementation_enum::LIST);
+}
+
+BOOST_AUTO_TEST_CASE(get_batcher_config_transform_mode_test)
+{
+  utility::configuration config;
+  utility::async_batcher_config batcher_config = utility::get_batcher_config(config, INTERACTION_SECTION);
+  BOOST_CHECK(batcher_config.transform_mode == transform_mode_enum::BATCHER);
+  config.set("interaction.transform.mode", "POOL");
+  config.set("interaction.transform.threads", "4");
+  batcher_config = utility::get_batcher_config(config, INTERACTION_SECTION);
+  BOOST_CHECK(batcher_config.transform_mode == transform_mode_enum::POOL);
+  BOOST_CHECK_EQUAL(batcher_config.transform_threads, 4);
+  config.set("transform.mode", "CALLER");
+  batcher_config = utility::get_batcher_config(config, OBSERVATION_SECTION);
+  BOOST_CHECK(batcher_config.transform_mode == transform_mode_enum::CALLER);
+  config.set("transform.mode", "direct");
+  batcher_config = utility::get_batcher_config(config, OBSERVATION_SECTION);
+  BOOST_CHECK(batcher_config.transform_mode == transform_mode_enum::DIRECT);
+}
+
+BOOST_AUTO_TEST_CASE(get_batcher_config_batch_compression_test)
+{
+  utility::configuration config;
+  utility::async_batcher_config batcher_config = utility::get_batcher_config(config, INTERACTION_SECTION);
+  BOOST_CHECK(!batcher_config.batch_compression);
+  BOOST_CHECK_EQUAL(batcher_config.batch_compression_level, value::DEFAULT_ZSTD_COMPRESSION_LEVEL);
+  config.set("interaction.send.batch_compression", "true");
+  config.set("zstd.compression_level", "5");
+  batcher_config = utility::get_batcher_config(config, INTERACTION_SECTION);
+  BOOST_CHECK(batcher_config.batch_compression);
+  BOOST_CHECK_EQUAL(batcher_config.batch_compression_level, 5);
+  batcher_config = utility::get_batcher_config(config, OBSERVATION_SECTION);
+  BOOST_CHECK(!batcher_config.batch_compression);
+}
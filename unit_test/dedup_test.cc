@@ -5,11 +5,28 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include "constants.h"
 #include "dedup_internals.h"
+#include "generated/v2/DedupInfo_generated.h"
+#include "logger/event_logger.h"
+#include "logger/logger_extensions.h"
+#include "serialization/fb_serializer.h"
+#include "serialization/payload_serializer.h"
+#include "utility/watchdog.h"
+#include "zdict.h"
+#include "zstd.h"
+
+#include <atomic>
+#include <map>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
 
 namespace r = reinforcement_learning;
 namespace err = reinforcement_learning::error_code;
 namespace fb = flatbuffers;
+namespace v2 = reinforcement_learning::messages::flatbuff::v2;
 
 fb::DetachedBuffer str_to_buff(const char* str)
 {
@@ -81,6 +98,47 @@ BOOST_AUTO_TEST_CASE(dedup_bad_json)
   BOOST_CHECK_EQUAL(err::json_parse_error, dict.transform_payload_and_add_objects(payload, p_out, a_out, nullptr));
 }
 
+BOOST_AUTO_TEST_CASE(dedup_bad_json_after_actions)
+{
+  r::dedup_dict dict;
+  const char* payload = R"({"_multi": [ { "b_": "1" }, { "b_": "2" } ], invalid })";
+  std::string p_out;
+  r::generic_event::object_list_t a_out;
+
+  // the actions seen before the error are not kept in the dictionary
+  BOOST_CHECK_EQUAL(err::json_parse_error, dict.transform_payload_and_add_objects(payload, p_out, a_out, nullptr));
+  BOOST_CHECK_EQUAL(0, a_out.size());
+  BOOST_CHECK_EQUAL(0, dict.size());
+}
+
+BOOST_AUTO_TEST_CASE(dedup_many_actions)
+{
+  r::dedup_dict dict;
+  std::string payload = R"({"s_": "1", "_multi": [)";
+  std::string expected = payload;
+  for (int i = 0; i < 500; ++i)
+  {
+    const auto action = R"({ "b_": ")" + std::to_string(i) + R"(" })";
+    if (i > 0)
+    {
+      payload += ", ";
+      expected += ", ";
+    }
+    payload += action;
+    const auto id = dict.add_object(action.c_str(), action.size());
+    expected += R"({"__aid":)" + std::to_string(id) + "}";
+  }
+  payload += "]}";
+  expected += "]}";
+
+  // the output buffer is reused
+  std::string p_out = "previous content";
+  r::generic_event::object_list_t a_out;
+  BOOST_CHECK_EQUAL(err::success, dict.transform_payload_and_add_objects(payload, p_out, a_out, nullptr));
+  BOOST_CHECK_EQUAL(500, a_out.size());
+  BOOST_CHECK_EQUAL(expected, p_out);
+}
+
 BOOST_AUTO_TEST_CASE(dedup_simple_json)
 {
   r::dedup_dict dict;
@@ -137,6 +195,49 @@ BOOST_AUTO_TEST_CASE(compression_transformer)
   BOOST_CHECK_EQUAL(input, (char*)in.data());
 }
 
+BOOST_AUTO_TEST_CASE(compression_transformer_with_dictionary)
+{
+  // train a small dictionary on payloads shaped like the ones it will compress
+  std::string samples;
+  std::vector<size_t> sample_sizes;
+  for (int i = 0; i < 1000; ++i)
+  {
+    const auto sample = R"({"GUser":{"id":"user)" + std::to_string(i % 37) + R"(","major":"eng","hobby":"hiking"},)" +
+        R"("_multi":[{"__aid":)" + std::to_string(i * 7919) + R"(},{"TAction":{"topic":"sports","a)" +
+        std::to_string(i % 11) + R"(":"f"}}]})";
+    samples += sample;
+    sample_sizes.push_back(sample.size());
+  }
+  std::vector<char> dictionary(4096);
+  const auto dictionary_size = ZDICT_trainFromBuffer(dictionary.data(), dictionary.size(), samples.data(),
+      sample_sizes.data(), static_cast<unsigned>(sample_sizes.size()));
+  BOOST_REQUIRE(!ZDICT_isError(dictionary_size));
+
+  r::zstd_compressor compressor(1);
+  BOOST_CHECK_EQUAL(err::success, compressor.set_dictionary(dictionary.data(), dictionary_size, nullptr));
+  BOOST_CHECK_NE(0u, compressor.dictionary_id());
+
+  const char* input = R"({"GUser":{"id":"user5","major":"eng","hobby":"hiking"},"_multi":[{"__aid":42}]})";
+  auto in = str_to_buff(input);
+  BOOST_CHECK_EQUAL(err::success, compressor.compress(in, nullptr));
+  // readers find the dictionary from the id in the frame header
+  BOOST_CHECK_EQUAL(compressor.dictionary_id(), ZSTD_getDictID_fromFrame(in.data(), in.size()));
+
+  BOOST_CHECK_EQUAL(err::success, compressor.decompress(in, nullptr));
+  BOOST_CHECK_EQUAL(input, (char*)in.data());
+}
+
+BOOST_AUTO_TEST_CASE(compression_transformer_rejects_raw_dictionary)
+{
+  // raw content dictionaries carry no id, so the reader could not tell which one to use
+  const std::string raw = R"({"GUser":{"id":"user","major":"eng"},"_multi":[{"TAction":{"topic":"sports"}}]})";
+  r::zstd_compressor compressor(1);
+  r::api_status status;
+  BOOST_CHECK_EQUAL(err::compression_error, compressor.set_dictionary(raw.data(), raw.size(), &status));
+  BOOST_CHECK_EQUAL(0u, compressor.dictionary_id());
+  BOOST_CHECK_EQUAL(err::file_open_error, compressor.load_dictionary("no_such_dictionary.zdict", &status));
+}
+
 BOOST_AUTO_TEST_CASE(action_dict_builder)
 {
   r::utility::configuration c;
@@ -240,6 +341,78 @@ BOOST_AUTO_TEST_CASE(dedup_state_expected_use)
   BOOST_CHECK_EQUAL(state.get_dict().get_object(obj_list[1]).size(), 0);
 }
 
+BOOST_AUTO_TEST_CASE(dedup_state_persistent)
+{
+  r::utility::configuration c;
+  c.set(r::name::DEDUP_PERSISTENT, "true");
+  c.set(r::name::DEDUP_SNAPSHOT_INTERVAL, "3");
+  c.set(r::name::DEDUP_EVICTION_BATCHES, "2");
+  r::dedup_state state(c, false, true, nullptr);
+  BOOST_CHECK(state.is_persistent());
+
+  auto& dict = state.get_dict();
+  const auto a1 = dict.add_object("a1", 2);
+  const auto a2 = dict.add_object("a2", 2);
+  const auto a3 = dict.add_object("a3", 2);
+  // a3 is only used by the third batch
+  dict.add_object("a1", 2);
+  dict.add_object("a1", 2);
+  dict.add_object("a1", 2);
+
+  using ids_t = std::set<r::generic_event::object_id_t>;
+  auto ids = [](const fb::Vector<uint64_t>* v) { return ids_t(v->begin(), v->end()); };
+  r::generic_event::payload_buffer_t payload;
+
+  // 1st batch - the reader gets everything
+  BOOST_CHECK_EQUAL(err::success, state.build_persistent_payload({{a1, 1}, {a2, 1}}, payload, nullptr));
+  auto info = v2::GetDedupInfo(payload.data());
+  BOOST_CHECK_EQUAL(v2::DedupMode_Snapshot, info->mode());
+  BOOST_CHECK_EQUAL(1, info->sequence());
+  // every batch names the dictionary it updates, so that a reader keeps one per client
+  const auto client_id = info->client_id();
+  BOOST_CHECK_NE(0, client_id);
+  BOOST_CHECK(ids_t({a1, a2}) == ids(info->ids()));
+  BOOST_CHECK_EQUAL(2, info->values()->size());
+  BOOST_CHECK(state.is_sent(a1));
+  BOOST_CHECK(state.is_sent(a2));
+
+  // 2nd batch - nothing new, the objects are still held for the reader
+  BOOST_CHECK_EQUAL(err::success, state.build_persistent_payload({{a1, 2}}, payload, nullptr));
+  info = v2::GetDedupInfo(payload.data());
+  BOOST_CHECK_EQUAL(v2::DedupMode_Delta, info->mode());
+  BOOST_CHECK_EQUAL(2, info->sequence());
+  BOOST_CHECK_EQUAL(client_id, info->client_id());
+  BOOST_CHECK_EQUAL(0, info->ids()->size());
+  BOOST_CHECK_EQUAL(0, info->evicted_ids()->size());
+  BOOST_CHECK_EQUAL(3, dict.size());
+
+  // 3rd batch - a3 is new and a2 went unused for long enough to be dropped
+  BOOST_CHECK_EQUAL(err::success, state.build_persistent_payload({{a1, 1}, {a3, 1}}, payload, nullptr));
+  info = v2::GetDedupInfo(payload.data());
+  BOOST_CHECK_EQUAL(v2::DedupMode_Delta, info->mode());
+  BOOST_CHECK(ids_t({a3}) == ids(info->ids()));
+  BOOST_CHECK_EQUAL("a3", info->values()->Get(0)->str());
+  BOOST_CHECK(ids_t({a2}) == ids(info->evicted_ids()));
+  BOOST_CHECK(!state.is_sent(a2));
+  BOOST_CHECK_EQUAL(0, dict.get_object(a2).size());
+
+  // 4th batch - periodic snapshot of what the reader should hold
+  BOOST_CHECK_EQUAL(err::success, state.build_persistent_payload({}, payload, nullptr));
+  info = v2::GetDedupInfo(payload.data());
+  BOOST_CHECK_EQUAL(v2::DedupMode_Snapshot, info->mode());
+  BOOST_CHECK_EQUAL(4, info->sequence());
+  BOOST_CHECK(ids_t({a1, a3}) == ids(info->ids()));
+  BOOST_CHECK_EQUAL(2, dict.size());
+
+  // objects missing from the dictionary are reported, and the batch changes nothing
+  BOOST_CHECK_EQUAL(err::compression_error, state.build_persistent_payload({{a1, 1}, {a2, 1}}, payload, nullptr));
+  BOOST_CHECK_EQUAL(2, dict.get_object(a1).size());
+  BOOST_CHECK_EQUAL(2, dict.size());
+  BOOST_CHECK_EQUAL(err::success, state.build_persistent_payload({}, payload, nullptr));
+  info = v2::GetDedupInfo(payload.data());
+  BOOST_CHECK_EQUAL(5, info->sequence());
+}
+
 BOOST_AUTO_TEST_CASE(dedup_state_and_bad_state)
 {
   r::utility::configuration c;
@@ -332,4 +505,209 @@ BOOST_AUTO_TEST_CASE(dedup_disable_compression)
   BOOST_CHECK_EQUAL((int)r::event_content_type::IDENTITY, (int)content_type);
   BOOST_CHECK_EQUAL(old_len, in.size());
   BOOST_CHECK_EQUAL(ptr1, in.data());
-}
\ No newline at end of file
+}
+
+BOOST_AUTO_TEST_CASE(dedup_concurrent_add_remove_object)
+{
+  r::dedup_dict dict;
+  const int threads_count = 8;
+  const int objects_count = 500;
+  const std::string shared = "{shared}";
+
+  // failures are counted on the worker threads and checked once they are joined
+  std::atomic<int> wrong_objects{0};
+  std::atomic<int> failed_removes{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < threads_count; ++t)
+  {
+    threads.emplace_back([&dict, &shared, &wrong_objects, &failed_removes, t] {
+      for (int i = 0; i < objects_count; ++i)
+      {
+        const auto own = std::to_string(t) + "-" + std::to_string(i);
+        const auto own_id = dict.add_object(own.c_str(), own.size());
+        dict.add_object(shared.c_str(), shared.size());
+        if (own != dict.get_object(own_id)) { ++wrong_objects; }
+        if (!dict.remove_object(own_id)) { ++failed_removes; }
+      }
+    });
+  }
+  for (auto& t : threads) { t.join(); }
+
+  BOOST_CHECK_EQUAL(0, wrong_objects.load());
+  BOOST_CHECK_EQUAL(0, failed_removes.load());
+
+  // only the shared object is left, with one reference per add
+  BOOST_CHECK_EQUAL(1, dict.size());
+  auto id = dict.add_object(shared.c_str(), shared.size());
+  BOOST_CHECK_EQUAL(true, dict.remove_object(id, threads_count * objects_count + 1));
+  BOOST_CHECK_EQUAL(0, dict.size());
+}
+
+BOOST_AUTO_TEST_CASE(dedup_state_concurrent_transform)
+{
+  r::utility::configuration c;
+  r::dedup_state state(c, true, true, nullptr);
+  const int threads_count = 8;
+  std::string payload = R"({"s_": "1", "_multi": [ { "b_": "1" }, { "b_": "2" } ]})";
+
+  std::vector<r::generic_event::object_list_t> obj_lists(threads_count);
+  std::vector<int> results(threads_count, -1);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < threads_count; ++t)
+  {
+    threads.emplace_back([&state, &payload, &obj_lists, &results, t] {
+      std::string edited_payload;
+      results[t] = state.transform_payload_and_add_objects(payload.c_str(), edited_payload, obj_lists[t], nullptr);
+    });
+  }
+  for (auto& t : threads) { t.join(); }
+
+  for (const auto result : results) { BOOST_CHECK_EQUAL(err::success, result); }
+
+  for (const auto& obj_list : obj_lists) { BOOST_CHECK(obj_list == obj_lists[0]); }
+  BOOST_CHECK_EQUAL(2, state.get_dict().size());
+
+  // all the references are given back by the dropped events
+  for (const auto& obj_list : obj_lists) { state.remove_objects(obj_list); }
+  BOOST_CHECK_EQUAL(0, state.get_dict().size());
+}
+
+class recording_sender : public r::logger::i_message_sender
+{
+public:
+  explicit recording_sender(std::vector<std::vector<uint8_t>>& batches) : _batches(batches) {}
+
+  int init(r::api_status* status) override { return err::success; }
+
+  int send(const uint16_t msg_type, const buffer& db, r::api_status* status) override
+  {
+    _batches.emplace_back(db->body_begin(), db->body_begin() + db->body_filled_size());
+    return err::success;
+  }
+
+private:
+  std::vector<std::vector<uint8_t>>& _batches;
+};
+
+// logs a CB event for each context through the interaction extensions, the batches are sent when the logger is
+// destroyed
+std::vector<std::vector<uint8_t>> log_cb_events(
+    bool serialize_on_caller, bool use_dedup, bool use_compression, const std::vector<std::string>& contexts)
+{
+  r::utility::configuration c;
+  c.set(r::name::PROTOCOL_VERSION, "2");
+  c.set(r::name::INTERACTION_USE_DEDUP, use_dedup ? "true" : "false");
+  c.set(r::name::INTERACTION_USE_COMPRESSION, use_compression ? "true" : "false");
+  c.set(r::name::INTERACTION_TRANSFORM_MODE,
+      serialize_on_caller ? r::value::TRANSFORM_MODE_DIRECT : r::value::TRANSFORM_MODE_BATCHER);
+
+  std::vector<std::vector<uint8_t>> batches;
+  std::unique_ptr<r::logger::i_logger_extensions> ext(r::logger::i_logger_extensions::get_extensions(c, nullptr));
+  BOOST_REQUIRE_EQUAL(err::success, ext->init(nullptr));
+  r::utility::watchdog watchdog(nullptr);
+  {
+    r::logger::generic_event_logger logger(nullptr,
+        ext->create_batcher(new recording_sender(batches), watchdog, nullptr, r::INTERACTION_SECTION), "app_id",
+        serialize_on_caller);
+    BOOST_REQUIRE_EQUAL(err::success, logger.init(nullptr));
+
+    r::logger::cb_serializer serializer;
+    const std::vector<uint64_t> action_ids = {1, 2};
+    const std::vector<float> probabilities = {0.6f, 0.4f};
+    for (size_t i = 0; i < contexts.size(); ++i)
+    {
+      const auto event_id = "event_" + std::to_string(i);
+      BOOST_CHECK_EQUAL(err::success,
+          logger.log(event_id.c_str(), contexts[i], serializer.type, ext.get(), serializer, nullptr,
+              r::action_flags::DEFAULT, v2::LearningModeType_Online, action_ids, probabilities,
+              std::string("model_id")));
+    }
+  }
+  return batches;
+}
+
+struct logged_events
+{
+  std::map<r::generic_event::object_id_t, std::string> objects;
+  std::vector<std::string> contexts;
+  size_t compressed_contexts = 0;
+};
+
+fb::DetachedBuffer bytes_to_buff(const fb::Vector<uint8_t>& bytes)
+{
+  uint8_t* copy = fb::DefaultAllocator().allocate(bytes.size());
+  memcpy(copy, bytes.data(), bytes.size());
+  return fb::DetachedBuffer(nullptr, false, copy, 0, copy, bytes.size());
+}
+
+// objects of the dedup events and contexts of the CB events, decompressed
+logged_events read_events(const std::vector<std::vector<uint8_t>>& batches)
+{
+  logged_events logged;
+  r::zstd_compressor compressor(r::value::DEFAULT_ZSTD_COMPRESSION_LEVEL);
+  for (const auto& batch : batches)
+  {
+    fb::Verifier verifier(batch.data(), batch.size());
+    const auto* event_batch = v2::GetEventBatch(batch.data());
+    BOOST_REQUIRE(event_batch->Verify(verifier));
+    for (const auto* serialized : *event_batch->events())
+    {
+      const auto* evt = fb::GetRoot<v2::Event>(serialized->payload()->data());
+      auto payload = bytes_to_buff(*evt->payload());
+      const bool compressed = evt->meta()->encoding() == v2::EventEncoding_Zstd;
+      if (compressed) { BOOST_REQUIRE_EQUAL(err::success, compressor.decompress(payload, nullptr)); }
+
+      if (evt->meta()->payload_type() == v2::PayloadType_DedupInfo)
+      {
+        const auto* info = v2::GetDedupInfo(payload.data());
+        for (size_t i = 0; i < info->ids()->size(); ++i)
+        { logged.objects[info->ids()->Get(i)] = info->values()->Get(i)->str(); }
+      }
+      else
+      {
+        BOOST_REQUIRE_EQUAL(v2::PayloadType_CB, evt->meta()->payload_type());
+        const auto* context = v2::GetCbEvent(payload.data())->context();
+        logged.contexts.emplace_back(context->begin(), context->end());
+        if (compressed) { ++logged.compressed_contexts; }
+      }
+    }
+  }
+  return logged;
+}
+
+// events serialized by the thread that logs them (transform mode DIRECT) carry the same objects and compressed
+// payloads as the events transformed by the batcher
+BOOST_AUTO_TEST_CASE(dedup_generic_event_logger_serialize_on_caller)
+{
+  const std::vector<std::string> contexts = {R"({"s_": "1", "_multi": [ { "b_": "1" }, { "b_": "2" } ]})",
+      R"({"s_": "2", "_multi": [ { "b_": "2" }, { "b_": "3" } ]})"};
+
+  struct extension_config
+  {
+    bool use_dedup;
+    bool use_compression;
+  };
+  for (const auto& ext : {extension_config{false, false}, extension_config{false, true}, extension_config{true, true}})
+  {
+    const auto batched = read_events(log_cb_events(false, ext.use_dedup, ext.use_compression, contexts));
+    const auto direct = read_events(log_cb_events(true, ext.use_dedup, ext.use_compression, contexts));
+
+    BOOST_REQUIRE_EQUAL(contexts.size(), direct.contexts.size());
+    BOOST_CHECK(batched.contexts == direct.contexts);
+    BOOST_CHECK(batched.objects == direct.objects);
+    BOOST_CHECK_EQUAL(batched.compressed_contexts, direct.compressed_contexts);
+    BOOST_CHECK_EQUAL(ext.use_compression ? contexts.size() : 0, direct.compressed_contexts);
+
+    if (ext.use_dedup)
+    {
+      // the actions are sent once in the dictionary and replaced by their ids in the contexts
+      BOOST_CHECK_EQUAL(3, direct.objects.size());
+      for (const auto& context : direct.contexts) { BOOST_CHECK_EQUAL(std::string::npos, context.find("b_")); }
+    }
+    else
+    {
+      BOOST_CHECK_EQUAL(0, direct.objects.size());
+      BOOST_CHECK(contexts == direct.contexts);
+    }
+  }
+}
@@ -0,0 +1,86 @@
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#  define BOOST_TEST_MODULE Main
+#endif
+
+#include <boost/test/unit_test.hpp>
+
+#include "constants.h"
+#include "utility/event_id_generator.h"
+
+#include <cctype>
+#include <chrono>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace reinforcement_learning;
+using namespace reinforcement_learning::utility;
+
+namespace
+{
+void check_format(const std::string& id, char version)
+{
+  BOOST_REQUIRE_EQUAL(id.size(), EVENT_ID_LENGTH);
+  for (size_t i = 0; i < id.size(); ++i)
+  {
+    if (i == 8 || i == 13 || i == 18 || i == 23) { BOOST_CHECK_EQUAL(id[i], '-'); }
+    else { BOOST_CHECK(std::isxdigit(id[i]) && !std::isupper(id[i])); }
+  }
+  BOOST_CHECK_EQUAL(id[14], version);
+  // RFC 4122 variant
+  BOOST_CHECK(id[19] == '8' || id[19] == '9' || id[19] == 'a' || id[19] == 'b');
+}
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(event_id_generator_format)
+{
+  check_format(event_id_generator().generate(), '4');
+  check_format(event_id_generator(event_id_kind::TIME_ORDERED).generate(), '7');
+
+  char id[EVENT_ID_LENGTH + 1];
+  event_id_generator().generate(id);
+  BOOST_CHECK_EQUAL(std::string(id).size(), EVENT_ID_LENGTH);
+}
+
+BOOST_AUTO_TEST_CASE(event_id_generator_kind_from_config)
+{
+  BOOST_CHECK(to_event_id_kind(value::EVENT_ID_RANDOM) == event_id_kind::RANDOM);
+  BOOST_CHECK(to_event_id_kind("time_ordered") == event_id_kind::TIME_ORDERED);
+  BOOST_CHECK(to_event_id_kind("unknown") == event_id_kind::RANDOM);
+}
+
+BOOST_AUTO_TEST_CASE(event_id_generator_unique_across_threads)
+{
+  const size_t num_threads = 4;
+  const size_t ids_per_thread = 10000;
+  std::vector<std::vector<std::string>> ids(num_threads);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < num_threads; ++t)
+  {
+    threads.emplace_back(
+        [&ids, t, ids_per_thread]()
+        {
+          event_id_generator generator;
+          for (size_t i = 0; i < ids_per_thread; ++i) { ids[t].push_back(generator.generate()); }
+        });
+  }
+  for (auto& thread : threads) { thread.join(); }
+
+  std::set<std::string> unique_ids;
+  for (const auto& thread_ids : ids) { unique_ids.insert(thread_ids.begin(), thread_ids.end()); }
+  BOOST_CHECK_EQUAL(unique_ids.size(), num_threads * ids_per_thread);
+}
+
+BOOST_AUTO_TEST_CASE(event_id_generator_time_ordered)
+{
+  event_id_generator generator(event_id_kind::TIME_ORDERED);
+  const auto first = generator.generate();
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  const auto second = generator.generate();
+
+  // the leading hex digits are the time in milliseconds, so later ids sort after
+  BOOST_CHECK(first < second);
+  BOOST_CHECK(first.substr(0, 13) != second.substr(0, 13));
+}
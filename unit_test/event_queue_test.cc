@@ -4,6 +4,7 @@
 #endif
 
 #include "logger/event_queue.h"
+#include "logger/ring_buffer_event_queue.h"
 #include <boost/test/unit_test.hpp>
 
 #include "data_buffer.h"
@@ -298,4 +299,266 @@ BOOST_AUTO_TEST_CASE(queue_capacity_test)
   Func f;
   queue.pop(&f);
   BOOST_CHECK_EQUAL(queue.capacity(), 0);
-}
\ No newline at end of file
+}
+
+BOOST_AUTO_TEST_CASE(ring_buffer_push_pop_test)
+{
+  ring_buffer_event_queue<test_event> queue(30, 4, events_counter_status::ENABLE);
+  BOOST_CHECK_EQUAL(queue.slots_count(), 4);
+
+  Func f;
+  test_event val;
+  // go around the ring a few times
+  for (int i = 0; i < 10; ++i)
+  {
+    auto evt_sp = std::make_shared<test_event>(std::to_string(i + 1));
+    BOOST_CHECK(queue.push(std::bind(passthru, _1, _2, evt_sp), 10, evt_sp.get()));
+    BOOST_CHECK_EQUAL(queue.size(), 1);
+    BOOST_CHECK_EQUAL(queue.capacity(), 10);
+
+    BOOST_CHECK(queue.pop(&f));
+    f(val, nullptr);
+    BOOST_CHECK_EQUAL(val.get_event_id(), std::to_string(i + 1));
+    BOOST_CHECK_EQUAL(val.get_event_index(), i + 1);
+    BOOST_CHECK_EQUAL(queue.size(), 0);
+    BOOST_CHECK_EQUAL(queue.capacity(), 0);
+  }
+  BOOST_CHECK(!queue.pop(&f));
+}
+
+BOOST_AUTO_TEST_CASE(ring_buffer_prune_and_subsample_test)
+{
+  ring_buffer_event_queue<test_event> queue(30, 16, events_counter_status::ENABLE, 0.5);
+  std::vector<std::string> vs = {"no_drop_1", "drop_2", "no_drop_3", "no_drop_4", "no_drop_5"};
+  for (const auto& id : vs)
+  {
+    auto evt_sp = std::make_shared<test_event>(id);
+    queue.push(std::bind(passthru, _1, _2, evt_sp), 10, evt_sp.get());
+  }
+  // drop_2 is subsampled out but still consumes an event index
+  BOOST_CHECK_EQUAL(queue.size(), 4);
+  BOOST_CHECK_EQUAL(queue.capacity(), 40);
+
+  // nothing in the queue is droppable anymore
+  queue.prune(1.0);
+  BOOST_CHECK_EQUAL(queue.size(), 4);
+
+  Func f;
+  test_event val;
+  std::vector<uint64_t> expected_indexes = {1, 3, 4, 5};
+  for (auto expected_index : expected_indexes)
+  {
+    BOOST_CHECK(queue.pop(&f));
+    f(val, nullptr);
+    BOOST_CHECK_EQUAL(val.get_event_index(), expected_index);
+  }
+  BOOST_CHECK(!queue.pop(&f));
+  BOOST_CHECK_EQUAL(queue.capacity(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(ring_buffer_prune_test)
+{
+  ring_buffer_event_queue<test_event> queue(30, 16, events_counter_status::ENABLE);
+  std::vector<std::string> vs = {"no_drop_1", "drop_2", "no_drop_3", "drop_4", "no_drop_5"};
+  for (const auto& id : vs)
+  {
+    auto evt_sp = std::make_shared<test_event>(id);
+    queue.push(std::bind(passthru, _1, _2, evt_sp), 10, evt_sp.get());
+  }
+
+  BOOST_CHECK_EQUAL(queue.size(), 5);
+  BOOST_CHECK_EQUAL(queue.capacity(), 50);
+  queue.prune(1.0);  // drop should work since current capacity is more than limit (50 > 30)
+  BOOST_CHECK_EQUAL(queue.size(), 3);
+  BOOST_CHECK_EQUAL(queue.capacity(), 30);
+
+  Func f;
+  test_event val;
+  for (int i : {1, 3, 5})
+  {
+    BOOST_CHECK(queue.pop(&f));
+    f(val, nullptr);
+    BOOST_CHECK_EQUAL(val.get_event_id(), "no_drop_" + std::to_string(i));
+    BOOST_CHECK_EQUAL(val.get_event_index(), i);
+  }
+  BOOST_CHECK(!queue.pop(&f));
+}
+
+BOOST_AUTO_TEST_CASE(ring_buffer_push_pop_threads)
+{
+  // fewer slots than events, so producers have to wait for the consumer
+  ring_buffer_event_queue<test_event> queue(1024 * 1024, 8, events_counter_status::ENABLE);
+  std::vector<thread> _threads;
+
+  const int n_threads = 4;
+  const int n = 500;
+  for (int t = 0; t < n_threads; ++t)
+  {
+    _threads.push_back(thread([&queue, t, n] {
+      for (int i = 0; i < n; ++i)
+      {
+        auto evt_sp = std::make_shared<test_event>(std::to_string(t));
+        queue.push(std::bind(passthru, _1, _2, evt_sp), 10, evt_sp.get());
+      }
+    }));
+  }
+
+  Func f;
+  test_event item;
+  uint64_t last_index = 0;
+  int popped = 0;
+  while (popped < n_threads * n)
+  {
+    if (queue.pop(&f))
+    {
+      f(item, nullptr);
+      // event indexes follow the queue order
+      BOOST_REQUIRE_EQUAL(item.get_event_index(), last_index + 1);
+      last_index = item.get_event_index();
+      ++popped;
+    }
+  }
+
+  for (auto& t : _threads) { t.join(); }
+  BOOST_CHECK_EQUAL(queue.size(), 0);
+  BOOST_CHECK_EQUAL(queue.capacity(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(ring_buffer_drop_when_full_test)
+{
+  ring_buffer_event_queue<test_event> queue(1024, 4, events_counter_status::ENABLE, 1.0f, queue_mode_enum::DROP);
+
+  // the producer never waits for the consumer, events that find no free slot are dropped
+  for (int i = 0; i < 4; ++i) { BOOST_CHECK(queue.push(test_event(std::to_string(i + 1)), 10)); }
+  BOOST_CHECK(!queue.push(test_event("5"), 10));
+  auto evt_sp = std::make_shared<test_event>("6");
+  BOOST_CHECK(!queue.push(std::bind(passthru, _1, _2, evt_sp), 10, evt_sp.get()));
+  BOOST_CHECK_EQUAL(queue.size(), 4);
+  BOOST_CHECK_EQUAL(queue.capacity(), 40);
+
+  Func f;
+  test_event val;
+  BOOST_CHECK(queue.pop(&val, &f));
+  BOOST_CHECK_EQUAL(val.get_event_id(), "1");
+  BOOST_CHECK(queue.push(test_event("7"), 10));
+  BOOST_CHECK_EQUAL(queue.size(), 4);
+
+  // dropped events do not take an event index
+  for (const auto* expected : {"2", "3", "4", "7"})
+  {
+    BOOST_CHECK(queue.pop(&val, &f));
+    BOOST_CHECK_EQUAL(val.get_event_id(), expected);
+  }
+  BOOST_CHECK_EQUAL(val.get_event_index(), 5);
+  BOOST_CHECK(!queue.pop(&val, &f));
+}
+
+BOOST_AUTO_TEST_CASE(ring_buffer_slots_count_test)
+{
+  BOOST_CHECK_EQUAL(ring_buffer_event_queue<test_event>(30, 0).slots_count(), 2);
+  BOOST_CHECK_EQUAL(ring_buffer_event_queue<test_event>(30, 5).slots_count(), 8);
+  BOOST_CHECK_EQUAL(ring_buffer_event_queue<test_event>(30, 64).slots_count(), 64);
+}
+
+BOOST_AUTO_TEST_CASE(ring_buffer_push_by_value_test)
+{
+  ring_buffer_event_queue<test_event> queue(30, 4, events_counter_status::ENABLE);
+
+  queue.push(test_event("1"), 10);
+  auto evt_sp = std::make_shared<test_event>("2");
+  queue.push(std::bind(passthru, _1, _2, evt_sp), 10, evt_sp.get());
+  queue.push(test_event("3"), 10);
+  BOOST_CHECK_EQUAL(queue.size(), 3);
+  BOOST_CHECK_EQUAL(queue.capacity(), 30);
+
+  Func f;
+  test_event val;
+  // values are moved out directly and leave the function empty
+  BOOST_CHECK(queue.pop(&val, &f));
+  BOOST_CHECK(!f);
+  BOOST_CHECK_EQUAL(val.get_event_id(), "1");
+  BOOST_CHECK_EQUAL(val.get_event_index(), 1);
+
+  BOOST_CHECK(queue.pop(&val, &f));
+  BOOST_REQUIRE(f);
+  f(val, nullptr);
+  BOOST_CHECK_EQUAL(val.get_event_id(), "2");
+  BOOST_CHECK_EQUAL(val.get_event_index(), 2);
+
+  // values popped through the function-only overload are wrapped
+  BOOST_CHECK(queue.pop(&f));
+  f(val, nullptr);
+  BOOST_CHECK_EQUAL(val.get_event_id(), "3");
+  BOOST_CHECK_EQUAL(val.get_event_index(), 3);
+  BOOST_CHECK_EQUAL(queue.size(), 0);
+  BOOST_CHECK_EQUAL(queue.capacity(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(push_batch_test)
+{
+  event_queue<test_event> list_queue(30, events_counter_status::ENABLE);
+  ring_buffer_event_queue<test_event> ring_queue(30, 4, events_counter_status::ENABLE);
+  std::vector<i_event_queue<test_event>*> queues = {&list_queue, &ring_queue};
+
+  for (auto* queue : queues)
+  {
+    queue->push(test_event("1"), 10);
+    std::vector<test_event> batch;
+    batch.emplace_back("2");
+    batch.emplace_back("3");
+    queue->push(std::move(batch), {5, 15});
+    BOOST_CHECK_EQUAL(queue->size(), 3);
+    BOOST_CHECK_EQUAL(queue->capacity(), 30);
+
+    // the batch keeps its order and gets the next event indexes
+    Func f;
+    test_event val;
+    for (const auto* expected : {"1", "2", "3"})
+    {
+      f = nullptr;
+      BOOST_REQUIRE(queue->pop(&val, &f));
+      if (f) { f(val, nullptr); }
+      BOOST_CHECK_EQUAL(val.get_event_id(), expected);
+    }
+    BOOST_CHECK_EQUAL(val.get_event_index(), 3);
+    BOOST_CHECK_EQUAL(queue->size(), 0);
+    BOOST_CHECK_EQUAL(queue->capacity(), 0);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(push_func_batch_test)
+{
+  event_queue<test_event> list_queue(30, events_counter_status::ENABLE);
+  ring_buffer_event_queue<test_event> ring_queue(30, 4, events_counter_status::ENABLE);
+  std::vector<i_event_queue<test_event>*> queues = {&list_queue, &ring_queue};
+
+  for (auto* queue : queues)
+  {
+    std::vector<std::shared_ptr<test_event>> evts = {
+        std::make_shared<test_event>("1"), std::make_shared<test_event>("2"), std::make_shared<test_event>("3")};
+    std::vector<Func> funcs;
+    std::vector<test_event*> events;
+    for (const auto& evt_sp : evts)
+    {
+      funcs.push_back(std::bind(passthru, _1, _2, evt_sp));
+      events.push_back(evt_sp.get());
+    }
+    queue->push(std::move(funcs), {10, 5, 15}, events);
+    BOOST_CHECK_EQUAL(queue->size(), 3);
+    BOOST_CHECK_EQUAL(queue->capacity(), 30);
+
+    Func f;
+    test_event val;
+    for (const auto* expected : {"1", "2", "3"})
+    {
+      f = nullptr;
+      BOOST_REQUIRE(queue->pop(&val, &f));
+      BOOST_REQUIRE(f);
+      f(val, nullptr);
+      BOOST_CHECK_EQUAL(val.get_event_id(), expected);
+    }
+    BOOST_CHECK_EQUAL(val.get_event_index(), 3);
+    BOOST_CHECK_EQUAL(queue->size(), 0);
+    BOOST_CHECK_EQUAL(queue->capacity(), 0);
+  }
+}
@@ -236,3 +236,53 @@ BOOST_AUTO_TEST_CASE(fb_serializer_generic_event_metadata)
     BOOST_CHECK_EQUAL(metadata.app_id()->c_str(), "app_id");
   }
 }
+
+// an event serialized by the thread that logged it is copied into the batch as is, with its current pass probability
+BOOST_AUTO_TEST_CASE(fb_serializer_generic_event_serialized_by_caller)
+{
+  data_buffer db;
+  fb_collection_serializer<generic_event> collection_serializer(db, value::CONTENT_ENCODING_IDENTITY);
+  const timestamp ts;
+  cb_serializer serializer;
+
+  const std::vector<uint64_t> action_ids = {2, 1};
+  const std::vector<float> probabilities = {0.2f, 0.8f};
+  generic_event batched("event_id", ts, v2::PayloadType_CB,
+      serializer.event("my_context", action_flags::DEFAULT, v2::LearningModeType_Online, action_ids, probabilities,
+          "model_id"),
+      event_content_type::IDENTITY, "app_id");
+  generic_event direct("event_id", ts, v2::PayloadType_CB,
+      serializer.event("my_context", action_flags::DEFAULT, v2::LearningModeType_Online, action_ids, probabilities,
+          "model_id"),
+      event_content_type::IDENTITY, "app_id");
+
+  BOOST_CHECK_EQUAL(error_code::success, fb_event_serializer<generic_event>::serialize_event(direct, nullptr));
+  BOOST_CHECK(direct.is_serialized());
+  BOOST_CHECK_EQUAL(0, direct.get_payload().size());
+
+  // the pass probability changes after the event was serialized
+  batched.try_drop(0.5f, 0);
+  direct.try_drop(0.5f, 0);
+
+  collection_serializer.add(batched);
+  collection_serializer.add(direct);
+  BOOST_CHECK_EQUAL(error_code::success, collection_serializer.finalize(nullptr));
+
+  flatbuffers::Verifier v(db.body_begin(), db.body_filled_size());
+  const v2::EventBatch* event_batch = v2::GetEventBatch(db.body_begin());
+  BOOST_REQUIRE(event_batch->Verify(v));
+
+  const auto& events = *(event_batch->events());
+  BOOST_REQUIRE_EQUAL(2, events.size());
+  const auto* expected = flatbuffers::GetRoot<v2::Event>(events.Get(0)->payload()->data());
+  const auto* event = flatbuffers::GetRoot<v2::Event>(events.Get(1)->payload()->data());
+
+  BOOST_CHECK_EQUAL(expected->meta()->id()->str(), event->meta()->id()->str());
+  BOOST_CHECK_EQUAL(expected->meta()->app_id()->str(), event->meta()->app_id()->str());
+  BOOST_CHECK_EQUAL(expected->meta()->payload_type(), event->meta()->payload_type());
+  BOOST_CHECK_EQUAL(expected->meta()->encoding(), event->meta()->encoding());
+  BOOST_CHECK_CLOSE(0.5f, event->meta()->pass_probability(), 0.0001f);
+  BOOST_CHECK_CLOSE(expected->meta()->pass_probability(), event->meta()->pass_probability(), 0.0001f);
+  BOOST_CHECK_EQUAL_COLLECTIONS(expected->payload()->begin(), expected->payload()->end(), event->payload()->begin(),
+      event->payload()->end());
+}
@@ -9,6 +9,8 @@
 #include "utility/context_helper.h"
 
 #include <map>
+#include <string>
+#include <vector>
 
 using namespace reinforcement_learning;
 namespace rlutil = reinforcement_learning::utility;
@@ -57,55 +59,6 @@ BOOST_AUTO_TEST_CASE(json_malformed)
   BOOST_CHECK_EQUAL(scode, error_code::json_parse_error);
 }
 
-BOOST_AUTO_TEST_CASE(event_ids_json_malformed)
-{
-  const auto context = R"({"UserAgeq09898u)(**&^(*&^*^* })";
-
-  std::map<size_t, std::string> found;
-  const auto scode = rlutil::get_event_ids(context, found, nullptr, nullptr);
-  BOOST_CHECK_EQUAL(scode, error_code::json_parse_error);
-}
-
-BOOST_AUTO_TEST_CASE(event_ids_json_no_slots)
-{
-  const auto context = R"({
-    "UserAge":15,
-    "_multi":[
-      {"_text":"elections maine", "Source":"TV"},
-      {"Source":"www", "topic":4, "_label":"2:3:.3"}
-    ],
-    "_slots": [
-    ]
-  })";
-  std::map<size_t, std::string> found;
-  const auto scode = rlutil::get_event_ids(context, found, nullptr, nullptr);
-  BOOST_CHECK_EQUAL(scode, error_code::success);
-  BOOST_CHECK_EQUAL(found.size(), 0);
-}
-
-BOOST_AUTO_TEST_CASE(event_ids_json_basic)
-{
-  const auto context = R"({
-    "UserAge":15,
-    "_multi":[
-      {"_text":"elections maine", "Source":"TV"},
-      {"Source":"www", "topic":4, "_label":"2:3:.3"}
-    ],
-    "_slots": [
-      {"a":4},
-      {"_id":"test"}
-    ]
-  })";
-  std::map<size_t, std::string> found;
-  const auto scode = rlutil::get_event_ids(context, found, nullptr, nullptr);
-  BOOST_CHECK_EQUAL(scode, error_code::success);
-
-  BOOST_CHECK_EQUAL(found.size(), 1);
-  BOOST_CHECK_EQUAL(found.count(0), 0);
-  BOOST_CHECK_EQUAL(found.count(1), 1);
-  BOOST_CHECK_EQUAL(found[1], "test");
-}
-
 BOOST_AUTO_TEST_CASE(slot_count)
 {
   const auto context = R"({
@@ -201,7 +154,7 @@ BOOST_AUTO_TEST_CASE(get_context_info_test)
   BOOST_CHECK_EQUAL("{}", get_slot_str(context, info, 2));
 }
 
-BOOST_AUTO_TEST_CASE(get_slot_ids_test)
+BOOST_AUTO_TEST_CASE(context_info_slot_ids_test)
 {
   auto const context = R"({
     "UserAge":15,
@@ -217,17 +170,14 @@ BOOST_AUTO_TEST_CASE(get_slot_ids_test)
   rlutil::ContextInfo info;
   auto scode = rlutil::get_context_info(context, info);
   BOOST_CHECK_EQUAL(scode, error_code::success);
-  std::map<size_t, std::string> slot_ids;
-
-  scode = rlutil::get_slot_ids(context, info.slots, slot_ids);
-  BOOST_CHECK_EQUAL(scode, error_code::success);
+  auto& slot_ids = info.slot_ids;
 
   BOOST_CHECK_EQUAL(slot_ids.size(), 2);
   BOOST_CHECK_EQUAL(slot_ids[0], "provided_slot_id_1");
   BOOST_CHECK_EQUAL(slot_ids[1], "provided_slot_id_2");
 }
 
-BOOST_AUTO_TEST_CASE(get_slot_ids_no_slot_ids_test)
+BOOST_AUTO_TEST_CASE(context_info_slot_ids_no_slot_ids_test)
 {
   auto const context = R"({
     "UserAge":15,
@@ -243,15 +193,12 @@ BOOST_AUTO_TEST_CASE(get_slot_ids_no_slot_ids_test)
   rlutil::ContextInfo info;
   auto scode = rlutil::get_context_info(context, info);
   BOOST_CHECK_EQUAL(scode, error_code::success);
-  std::map<size_t, std::string> slot_ids;
-
-  scode = rlutil::get_slot_ids(context, info.slots, slot_ids);
-  BOOST_CHECK_EQUAL(scode, error_code::success);
+  auto& slot_ids = info.slot_ids;
 
   BOOST_CHECK_EQUAL(slot_ids.size(), 0);
 }
 
-BOOST_AUTO_TEST_CASE(get_slot_ids_some_slots_missing)
+BOOST_AUTO_TEST_CASE(context_info_slot_ids_some_slots_missing)
 {
   auto const context = R"({
     "UserAge":15,
@@ -268,13 +215,122 @@ BOOST_AUTO_TEST_CASE(get_slot_ids_some_slots_missing)
   rlutil::ContextInfo info;
   auto scode = rlutil::get_context_info(context, info);
   BOOST_CHECK_EQUAL(scode, error_code::success);
-  std::map<size_t, std::string> slot_ids;
-
-  scode = rlutil::get_slot_ids(context, info.slots, slot_ids);
-  BOOST_CHECK_EQUAL(scode, error_code::success);
+  auto& slot_ids = info.slot_ids;
 
   BOOST_CHECK_EQUAL(slot_ids.size(), 2);
   BOOST_CHECK_EQUAL(slot_ids[0], "provided_id_0");
-  BOOST_CHECK_EQUAL(slot_ids[1], "");
+  BOOST_CHECK_EQUAL(slot_ids.count(1), 0);
   BOOST_CHECK_EQUAL(slot_ids[2], "provided_id_2");
 }
+
+BOOST_AUTO_TEST_CASE(get_context_info_slot_ids_test)
+{
+  const auto context = std::string(R"({
+    "_id":"event",
+    "_multi":[
+      {"_id":"action", "Source":"TV"},
+      {"Source":"www"}
+    ],
+    "_slots": [
+      {"a":4, "_id":"provided_id_0", "_id":"duplicate"},
+      {"nested":{"_id":"not_a_slot_id"}},
+      {"_id":2},
+      {"b":[{"_id":"in_array"}], "_id":"provided_id_3"}
+    ]
+  })");
+
+  // only the string _id at the top level of a slot is its id, the first one wins
+  rlutil::ContextInfo info;
+  BOOST_CHECK_EQUAL(error_code::success, rlutil::get_context_info(context, info));
+  BOOST_CHECK_EQUAL(4, info.slots.size());
+  BOOST_CHECK_EQUAL(2, info.slot_ids.size());
+  BOOST_CHECK_EQUAL("provided_id_0", info.slot_ids[0]);
+  BOOST_CHECK_EQUAL("provided_id_3", info.slot_ids[3]);
+
+  // the context does not need to be null terminated, and previous results are cleared
+  const std::string padded = context + "garbage";
+  BOOST_CHECK_EQUAL(error_code::success, rlutil::get_context_info(string_view(padded.data(), context.size()), info));
+  BOOST_CHECK_EQUAL(2, info.actions.size());
+  BOOST_CHECK_EQUAL(4, info.slots.size());
+  BOOST_CHECK_EQUAL(2, info.slot_ids.size());
+}
+
+BOOST_AUTO_TEST_CASE(for_each_action_test)
+{
+  const auto context = std::string(R"({
+    "UserAge":15,
+    "_multi":[
+      {"_text":"elections maine", "Source":"TV"},
+      {"Source":"www", "nested":{"_multi":[{"a":1}]}},
+      { }
+    ],
+    "_slots": [ {"a":4} ]
+  })");
+
+  std::vector<std::string> actions;
+  const auto scode = rlutil::for_each_action(
+      context, [&](size_t start, size_t length) { actions.push_back(context.substr(start, length)); });
+  BOOST_CHECK_EQUAL(scode, error_code::success);
+  BOOST_REQUIRE_EQUAL(3, actions.size());
+  BOOST_CHECK_EQUAL("{\"_text\":\"elections maine\", \"Source\":\"TV\"}", actions[0]);
+  BOOST_CHECK_EQUAL("{\"Source\":\"www\", \"nested\":{\"_multi\":[{\"a\":1}]}}", actions[1]);
+  BOOST_CHECK_EQUAL("{ }", actions[2]);
+
+  // the context does not need to be null terminated
+  actions.clear();
+  const std::string padded = context + "garbage";
+  BOOST_CHECK_EQUAL(error_code::success,
+      rlutil::for_each_action(string_view(padded.data(), context.size()),
+          [&](size_t start, size_t length) { actions.push_back(padded.substr(start, length)); }));
+  BOOST_CHECK_EQUAL(3, actions.size());
+
+  BOOST_CHECK_EQUAL(error_code::json_parse_error, rlutil::for_each_action("{ invalid }", [](size_t, size_t) {}));
+}
+
+BOOST_AUTO_TEST_CASE(get_pdf_test)
+{
+  std::vector<int> action_ids;
+  std::vector<float> pdf;
+
+  const auto context = R"({"Shared":{"p":[1]}, "_multi":[{"Action":{"c":1}},{"Action":{"p":[2, 3]}}],"p":[0.4, 0.6]})";
+  BOOST_CHECK_EQUAL(error_code::success, rlutil::get_pdf(context, action_ids, pdf));
+  const std::vector<int> expected_ids = {0, 1};
+  const std::vector<float> expected_pdf = {0.4f, 0.6f};
+  BOOST_CHECK_EQUAL_COLLECTIONS(action_ids.begin(), action_ids.end(), expected_ids.begin(), expected_ids.end());
+  BOOST_CHECK_EQUAL_COLLECTIONS(pdf.begin(), pdf.end(), expected_pdf.begin(), expected_pdf.end());
+
+  // "_p" and integer probabilities
+  BOOST_CHECK_EQUAL(error_code::success, rlutil::get_pdf(R"({"_multi":[{},{}],"_p":[0, 1]})", action_ids, pdf));
+  BOOST_REQUIRE_EQUAL(2, pdf.size());
+  BOOST_CHECK_EQUAL(0.f, pdf[0]);
+  BOOST_CHECK_EQUAL(1.f, pdf[1]);
+
+  // no pdf in the context
+  BOOST_CHECK_EQUAL(error_code::success, rlutil::get_pdf(R"({"_multi":[{},{}]})", action_ids, pdf));
+  BOOST_CHECK(action_ids.empty());
+  BOOST_CHECK(pdf.empty());
+
+  BOOST_CHECK_EQUAL(error_code::json_parse_error, rlutil::get_pdf(R"({"p":[0.5, "0.5"]})", action_ids, pdf));
+  BOOST_CHECK_EQUAL(error_code::json_parse_error, rlutil::get_pdf(R"({"p":[[0.5], 0.5]})", action_ids, pdf));
+  BOOST_CHECK_EQUAL(error_code::json_parse_error, rlutil::get_pdf(R"({"p":[0.5, 0.5])", action_ids, pdf));
+  BOOST_CHECK(pdf.empty());
+}
+
+BOOST_AUTO_TEST_CASE(add_actions_test)
+{
+  const std::vector<string_view> actions = {R"({"b":{"0":1}})", R"({"b":{"0":2}})"};
+  std::string context;
+
+  BOOST_CHECK_EQUAL(error_code::success, rlutil::add_actions(R"( {"a":{"0":1}} )", actions, context));
+  BOOST_CHECK_EQUAL(R"({"a":{"0":1},"_multi":[{"b":{"0":1}},{"b":{"0":2}}]})", context);
+
+  // no shared features, the previous content is replaced
+  BOOST_CHECK_EQUAL(error_code::success, rlutil::add_actions("{ }", actions, context));
+  BOOST_CHECK_EQUAL(R"({"_multi":[{"b":{"0":1}},{"b":{"0":2}}]})", context);
+
+  BOOST_CHECK_EQUAL(error_code::success, rlutil::add_actions(R"({"a":{"0":1}})", {}, context));
+  BOOST_CHECK_EQUAL(R"({"a":{"0":1},"_multi":[]})", context);
+
+  BOOST_CHECK_EQUAL(error_code::json_parse_error, rlutil::add_actions(R"("a")", actions, context));
+  BOOST_CHECK_EQUAL(error_code::json_parse_error, rlutil::add_actions("{", actions, context));
+}
@@ -713,6 +713,332 @@ BOOST_AUTO_TEST_CASE(live_model_mocks)
   BOOST_CHECK_EQUAL(recorded.size(), 2);
 }
 
+BOOST_AUTO_TEST_CASE(live_model_ranking_request_reuse_context_buffer)
+{
+  std::vector<buffer_data_t> recorded;
+  auto mock_sender = get_mock_sender(recorded);
+  auto mock_data_transport = get_mock_data_transport();
+  auto mock_model = get_mock_model(r::model_management::model_type_t::CB);
+  When(Method((*mock_model), update)).AlwaysDo([](const m::model_data&, bool& model_ready, r::api_status*) {
+    model_ready = true;
+    return err::success;
+  });
+  const auto choose_rank_fn = [](const char*, uint64_t, r::string_view, std::vector<int>& action_ids,
+                                  std::vector<float>& action_pdf, std::string& model_version, r::api_status*) {
+    action_ids = {0, 1};
+    action_pdf = {0.5f, 0.5f};
+    model_version = "model_id";
+    return err::success;
+  };
+  When(Method((*mock_model), choose_rank)).AlwaysDo(choose_rank_fn);
+  When(Method((*mock_model), choose_rank_with_context_buffer)).AlwaysDo(choose_rank_fn);
+
+  auto sender_factory = get_mock_sender_factory(mock_sender.get(), mock_sender.get());
+  auto data_transport_factory = get_mock_data_transport_factory(mock_data_transport.get());
+  auto model_factory = get_mock_model_factory(mock_model.get());
+
+  u::configuration config;
+  cfg::create_from_json(JSON_CFG, config);
+  config.set(r::name::EH_TEST, "true");
+  config.set(r::name::MODEL_BACKGROUND_REFRESH, "false");
+
+  r::live_model model =
+      create_mock_live_model(config, data_transport_factory.get(), model_factory.get(), sender_factory.get());
+
+  r::api_status status;
+  BOOST_CHECK_EQUAL(model.init(&status), err::success);
+
+  const auto event_id = "event_id";
+  r::ranking_response response;
+
+  BOOST_CHECK_EQUAL(model.choose_rank(event_id, JSON_CONTEXT, r::action_flags::DEFAULT, response), err::success);
+  Verify(Method((*mock_model), choose_rank)).Once();
+  Verify(Method((*mock_model), choose_rank_with_context_buffer)).Never();
+
+  // the flag only changes how the model copies the context
+  BOOST_CHECK_EQUAL(
+      model.choose_rank(event_id, JSON_CONTEXT, r::action_flags::REUSE_CONTEXT_BUFFER, response), err::success);
+  Verify(Method((*mock_model), choose_rank)).Once();
+  Verify(Method((*mock_model), choose_rank_with_context_buffer)).Once();
+  BOOST_CHECK_EQUAL(response.get_model_id(), "model_id");
+}
+
+BOOST_AUTO_TEST_CASE(live_model_registered_actions)
+{
+  u::configuration config;
+  cfg::create_from_json(JSON_CFG, config);
+  config.set(r::name::EH_TEST, "true");
+
+  r::api_status status;
+  r::live_model ds = create_mock_live_model(config, nullptr, nullptr, nullptr, r::model_management::model_type_t::CB);
+  BOOST_CHECK_EQUAL(ds.init(&status), err::success);
+
+  uint64_t first = 0;
+  uint64_t second = 0;
+  uint64_t again = 0;
+  BOOST_CHECK_EQUAL(ds.register_action(R"({"TAction":{"id":1}})", first), err::success);
+  BOOST_CHECK_EQUAL(ds.register_action(R"({"TAction":{"id":2}})", second), err::success);
+  BOOST_CHECK_NE(first, second);
+  BOOST_CHECK_EQUAL(ds.register_action(R"({"TAction":{"id":1}})", again), err::success);
+  BOOST_CHECK_EQUAL(again, first);
+  BOOST_CHECK_EQUAL(ds.register_action("", again), err::invalid_argument);
+
+  // both actions hash to 2829802955, the second one must not be ranked with the features of the first
+  uint64_t collision = 0;
+  BOOST_CHECK_EQUAL(ds.register_action(R"({"TAction":{"id":68157}})", collision), err::success);
+  BOOST_CHECK_EQUAL(
+      ds.register_action(R"({"TAction":{"id":159060}})", collision, &status), err::action_id_collision);
+
+  const auto event_id = "event_id";
+  r::ranking_response response;
+  BOOST_CHECK_EQUAL(ds.choose_rank(event_id, R"({"GUser":{"id":"a"}})", {first, second}, r::action_flags::DEFAULT,
+                        response, &status),
+      err::success);
+  BOOST_CHECK_EQUAL(response.get_event_id(), event_id);
+  BOOST_CHECK_EQUAL(response.get_model_id(), "N/A");
+  BOOST_CHECK_EQUAL(response.size(), 2);
+
+  // the response is reused, it only holds the actions of the last request
+  BOOST_CHECK_EQUAL(
+      ds.choose_rank(event_id, "{}", {second}, r::action_flags::DEFAULT, response, &status), err::success);
+  BOOST_CHECK_EQUAL(response.size(), 1);
+
+  BOOST_CHECK_EQUAL(
+      ds.choose_rank(event_id, "{}", {}, r::action_flags::DEFAULT, response, &status), err::json_no_actions_found);
+  BOOST_CHECK_EQUAL(ds.choose_rank(event_id, "{}", {first, 42}, r::action_flags::DEFAULT, response, &status),
+      err::action_not_registered);
+  BOOST_CHECK_EQUAL(response.size(), 0);
+
+  BOOST_CHECK_EQUAL(ds.unregister_action(first, &status), err::success);
+  BOOST_CHECK_EQUAL(ds.unregister_action(first, &status), err::action_not_registered);
+  BOOST_CHECK_EQUAL(ds.choose_rank(event_id, "{}", {first, second}, r::action_flags::DEFAULT, response, &status),
+      err::action_not_registered);
+  BOOST_CHECK_EQUAL(
+      ds.choose_rank(event_id, "{}", {second}, r::action_flags::DEFAULT, response, &status), err::success);
+}
+
+BOOST_AUTO_TEST_CASE(live_model_registered_actions_with_model)
+{
+  std::vector<buffer_data_t> recorded;
+  auto mock_sender = get_mock_sender(recorded);
+  auto mock_data_transport = get_mock_data_transport();
+  auto mock_model = get_mock_model(r::model_management::model_type_t::CB);
+  When(Method((*mock_model), update)).AlwaysDo([](const m::model_data&, bool& model_ready, r::api_status*) {
+    model_ready = true;
+    return err::success;
+  });
+  std::vector<uint64_t> generations;
+  std::vector<std::string> shared_features;
+  std::vector<std::string> contexts;
+  When(Method((*mock_model), choose_rank_registered))
+      .AlwaysDo([&](const char*, uint64_t, r::string_view shared, const std::vector<m::registered_action>& actions,
+                    uint64_t registry_generation, r::string_view features, std::vector<int>& action_ids,
+                    std::vector<float>& action_pdf, std::string& model_version, r::api_status*) {
+        generations.push_back(registry_generation);
+        shared_features.emplace_back(shared.data(), shared.size());
+        contexts.emplace_back(features.data(), features.size());
+        action_ids.clear();
+        action_pdf.clear();
+        for (size_t i = 0; i < actions.size(); ++i)
+        {
+          action_ids.push_back(static_cast<int>(i));
+          action_pdf.push_back(1.f / actions.size());
+        }
+        model_version = "model_id";
+        return err::success;
+      });
+
+  auto sender_factory = get_mock_sender_factory(mock_sender.get(), mock_sender.get());
+  auto data_transport_factory = get_mock_data_transport_factory(mock_data_transport.get());
+  auto model_factory = get_mock_model_factory(mock_model.get());
+
+  u::configuration config;
+  cfg::create_from_json(JSON_CFG, config);
+  config.set(r::name::EH_TEST, "true");
+  config.set(r::name::MODEL_BACKGROUND_REFRESH, "false");
+
+  r::live_model model =
+      create_mock_live_model(config, data_transport_factory.get(), model_factory.get(), sender_factory.get());
+
+  r::api_status status;
+  BOOST_CHECK_EQUAL(model.init(&status), err::success);
+
+  uint64_t first = 0;
+  uint64_t second = 0;
+  BOOST_CHECK_EQUAL(model.register_action(R"({"b":{"0":1}})", first), err::success);
+  BOOST_CHECK_EQUAL(model.register_action(R"({"b":{"0":2}})", second), err::success);
+
+  const auto event_id = "event_id";
+  r::ranking_response response;
+  BOOST_CHECK_EQUAL(
+      model.choose_rank(event_id, R"({"a":{"0":1}})", {second, first}, r::action_flags::DEFAULT, response, &status),
+      err::success);
+  BOOST_CHECK_EQUAL(response.get_model_id(), "model_id");
+  BOOST_CHECK_EQUAL(response.size(), 2);
+
+  // unregistering an action starts a new generation of the registry, registering one does not
+  BOOST_CHECK_EQUAL(model.unregister_action(first), err::success);
+  BOOST_CHECK_EQUAL(model.register_action(R"({"b":{"0":1}})", first), err::success);
+  BOOST_CHECK_EQUAL(
+      model.choose_rank(event_id, R"({"a":{"0":1}})", {first}, r::action_flags::DEFAULT, response, &status),
+      err::success);
+  BOOST_CHECK_EQUAL(response.size(), 1);
+
+  BOOST_REQUIRE_EQUAL(generations.size(), 2);
+  BOOST_CHECK_NE(generations[0], generations[1]);
+  BOOST_CHECK_EQUAL(shared_features[0], R"({"a":{"0":1},"_multi":[]})");
+  BOOST_CHECK_EQUAL(contexts[0], R"({"a":{"0":1},"_multi":[{"b":{"0":2}},{"b":{"0":1}}]})");
+  BOOST_CHECK_EQUAL(contexts[1], R"({"a":{"0":1},"_multi":[{"b":{"0":1}}]})");
+  Verify(Method((*mock_model), choose_rank)).Never();
+}
+
+BOOST_AUTO_TEST_CASE(live_model_ranking_request_batch)
+{
+  u::configuration config;
+  cfg::create_from_json(JSON_CFG, config);
+  config.set(r::name::EH_TEST, "true");
+
+  r::api_status status;
+  r::live_model ds = create_mock_live_model(config, nullptr, nullptr, nullptr, r::model_management::model_type_t::CB);
+  BOOST_CHECK_EQUAL(ds.init(&status), err::success);
+
+  const std::vector<const char*> event_ids = {"event_1", "event_2", "event_3"};
+  std::vector<r::string_view> contexts(event_ids.size(), JSON_CONTEXT);
+  std::vector<r::ranking_response> responses;
+
+  // without a model every context is explored
+  BOOST_CHECK_EQUAL(ds.choose_rank_batch(event_ids, contexts, r::action_flags::DEFAULT, responses), err::success);
+  BOOST_REQUIRE_EQUAL(responses.size(), event_ids.size());
+  for (size_t i = 0; i < responses.size(); ++i)
+  {
+    BOOST_CHECK_EQUAL(responses[i].get_event_id(), event_ids[i]);
+    BOOST_CHECK_EQUAL(responses[i].get_model_id(), "N/A");
+    BOOST_CHECK_EQUAL(responses[i].size(), 2);
+  }
+
+  // invalid context
+  contexts[1] = "";
+  BOOST_CHECK_EQUAL(
+      ds.choose_rank_batch(event_ids, contexts, r::action_flags::DEFAULT, responses), err::invalid_argument);
+
+  // one context per event_id
+  contexts.pop_back();
+  BOOST_CHECK_EQUAL(
+      ds.choose_rank_batch(event_ids, contexts, r::action_flags::DEFAULT, responses), err::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(live_model_ranking_request_batch_with_model)
+{
+  std::vector<buffer_data_t> recorded;
+  auto mock_sender = get_mock_sender(recorded);
+  auto mock_data_transport = get_mock_data_transport();
+  auto mock_model = get_mock_model(r::model_management::model_type_t::CB);
+  When(Method((*mock_model), update)).AlwaysDo([](const m::model_data&, bool& model_ready, r::api_status*) {
+    model_ready = true;
+    return err::success;
+  });
+  When(Method((*mock_model), choose_rank_batch))
+      .AlwaysDo([](const std::vector<const char*>&, const std::vector<uint64_t>&,
+                    const std::vector<r::string_view>& features, std::vector<std::vector<int>>& action_ids,
+                    std::vector<std::vector<float>>& action_pdfs, std::vector<std::string>& model_versions,
+                    r::api_status*) {
+        action_ids.assign(features.size(), {0, 1});
+        action_pdfs.assign(features.size(), {0.5f, 0.5f});
+        model_versions.assign(features.size(), "model_id");
+        return err::success;
+      });
+
+  auto sender_factory = get_mock_sender_factory(mock_sender.get(), mock_sender.get());
+  auto data_transport_factory = get_mock_data_transport_factory(mock_data_transport.get());
+  auto model_factory = get_mock_model_factory(mock_model.get());
+
+  u::configuration config;
+  cfg::create_from_json(JSON_CFG, config);
+  config.set(r::name::EH_TEST, "true");
+  config.set(r::name::MODEL_BACKGROUND_REFRESH, "false");
+
+  r::live_model model =
+      create_mock_live_model(config, data_transport_factory.get(), model_factory.get(), sender_factory.get());
+
+  r::api_status status;
+  BOOST_CHECK_EQUAL(model.init(&status), err::success);
+
+  const std::vector<const char*> event_ids = {"event_1", "event_2", "event_3"};
+  const std::vector<r::string_view> contexts(event_ids.size(), JSON_CONTEXT);
+  std::vector<r::ranking_response> responses;
+
+  BOOST_CHECK_EQUAL(
+      model.choose_rank_batch(event_ids, contexts, r::action_flags::DEFAULT, responses, &status), err::success);
+  BOOST_REQUIRE_EQUAL(responses.size(), event_ids.size());
+  for (size_t i = 0; i < responses.size(); ++i)
+  {
+    BOOST_CHECK_EQUAL(responses[i].get_event_id(), event_ids[i]);
+    BOOST_CHECK_EQUAL(responses[i].get_model_id(), "model_id");
+    BOOST_CHECK_EQUAL(responses[i].size(), 2);
+  }
+
+  // the whole batch is ranked with a single model call
+  Verify(Method((*mock_model), choose_rank_batch)).Once();
+  Verify(Method((*mock_model), choose_rank)).Never();
+}
+
+BOOST_AUTO_TEST_CASE(live_model_multi_slot_decision_batch)
+{
+  u::configuration config;
+  cfg::create_from_json(JSON_CFG, config);
+  config.set(r::name::PROTOCOL_VERSION, "2");
+  config.set(r::name::EH_TEST, "true");
+  config.set(r::name::MODEL_SRC, r::value::NO_MODEL_DATA);
+  config.set(r::name::OBSERVATION_SENDER_IMPLEMENTATION, r::value::OBSERVATION_FILE_SENDER);
+  config.set(r::name::INTERACTION_SENDER_IMPLEMENTATION, r::value::INTERACTION_FILE_SENDER);
+  config.set(r::name::INTERACTION_FILE_NAME, "interaction.txt");
+  config.set(r::name::OBSERVATION_FILE_NAME, "observation.txt");
+  config.set(
+      r::name::MODEL_VW_INITIAL_COMMAND_LINE, "--ccb_explore_adf --json --quiet --epsilon 0.0 --first_only --id N/A");
+  // the batch is split between the calling thread and a worker
+  config.set(r::name::VW_BATCH_THREADS, "2");
+
+  r::api_status status;
+  r::live_model model(config);
+  BOOST_CHECK_EQUAL(model.init(&status), err::success);
+
+  const auto context =
+      R"({"GUser":{"id":"a"},"_multi":[{"TAction":{"a1":"f1"}},{"TAction":{"a2":"f2"}}],"_slots":[{"Slot":{"a1":"f1"}},{"Slot":{"a1":"f1"}}]})";
+  const std::vector<const char*> event_ids = {"event_1", "event_2", "event_3"};
+  std::vector<r::string_view> contexts(event_ids.size(), context);
+  std::vector<r::multi_slot_response_detailed> responses;
+
+  BOOST_CHECK_EQUAL(
+      model.request_multi_slot_decision_batch(event_ids, contexts, r::action_flags::DEFAULT, responses, &status),
+      err::success);
+  BOOST_REQUIRE_EQUAL(responses.size(), event_ids.size());
+  for (size_t i = 0; i < responses.size(); ++i)
+  {
+    // same decision as request_multi_slot_decision for each context
+    BOOST_CHECK_EQUAL(responses[i].get_event_id(), event_ids[i]);
+    BOOST_CHECK(strcmp(responses[i].get_model_id(), "N/A") == 0);
+    BOOST_REQUIRE_EQUAL(responses[i].size(), 2);
+    size_t expected_action = 0;
+    for (const auto& slot : responses[i])
+    {
+      size_t action_id = 0;
+      BOOST_CHECK_EQUAL(slot.get_chosen_action_id(action_id), err::success);
+      BOOST_CHECK_EQUAL(action_id, expected_action++);
+      BOOST_CHECK(strcmp(slot.get_id(), "") != 0);
+    }
+  }
+
+  // invalid context
+  contexts[1] = "";
+  BOOST_CHECK_EQUAL(model.request_multi_slot_decision_batch(event_ids, contexts, r::action_flags::DEFAULT, responses),
+      err::invalid_argument);
+
+  // one context per event_id
+  contexts.pop_back();
+  BOOST_CHECK_EQUAL(model.request_multi_slot_decision_batch(event_ids, contexts, r::action_flags::DEFAULT, responses),
+      err::invalid_argument);
+}
+
 BOOST_AUTO_TEST_CASE(live_model_background_refresh)
 {
   u::configuration config;
@@ -49,6 +49,7 @@ std::unique_ptr<fakeit::Mock<m::i_data_transport>> get_mock_data_transport()
   auto mock = std::unique_ptr<Mock<m::i_data_transport>>(new fakeit::Mock<m::i_data_transport>());
 
   When(Method((*mock), get_data)).AlwaysReturn(r::error_code::success);
+  When(Method((*mock), set_model_changed_callback)).AlwaysReturn(false);
   Fake(Dtor((*mock)));
 
   return mock;
@@ -59,6 +60,7 @@ std::unique_ptr<fakeit::Mock<m::i_data_transport>> get_mock_failing_data_transpo
   auto mock = std::unique_ptr<fakeit::Mock<m::i_data_transport>>(new fakeit::Mock<m::i_data_transport>());
 
   When(Method((*mock), get_data)).AlwaysReturn(r::error_code::exception_during_http_req);
+  When(Method((*mock), set_model_changed_callback)).AlwaysReturn(false);
   Fake(Dtor((*mock)));
 
   return mock;
@@ -101,14 +103,39 @@ std::unique_ptr<fakeit::Mock<m::i_model>> get_mock_model(m::model_type_t model_t
     return r::error_code::success;
   };
 
+  const auto choose_rank_batch_fn = [](const std::vector<const char*>&, const std::vector<uint64_t>&,
+                                        const std::vector<r::string_view>& features,
+                                        std::vector<std::vector<int>>& action_ids,
+                                        std::vector<std::vector<float>>& action_pdfs,
+                                        std::vector<std::string>& model_versions, r::api_status*) {
+    action_ids.resize(features.size());
+    action_pdfs.resize(features.size());
+    model_versions.assign(features.size(), "model_id");
+    return r::error_code::success;
+  };
+
+  const auto request_multi_slot_decision_batch_fn =
+      [](const std::vector<const char*>&, const std::vector<std::vector<std::string>>&,
+          const std::vector<r::string_view>& features, std::vector<std::vector<std::vector<uint32_t>>>& actions_ids,
+          std::vector<std::vector<std::vector<float>>>& action_pdfs, std::vector<std::string>& model_versions,
+          r::api_status*) {
+        actions_ids.resize(features.size());
+        action_pdfs.resize(features.size());
+        model_versions.assign(features.size(), "model_id");
+        return r::error_code::success;
+      };
+
   const auto get_model_type = [model_type]() { return model_type; };
 
   When(Method((*mock), update)).AlwaysReturn(r::error_code::success);
   When(Method((*mock), choose_rank)).AlwaysDo(choose_rank_fn);
+  When(Method((*mock), choose_rank_with_context_buffer)).AlwaysDo(choose_rank_fn);
   When(Method((*mock), choose_continuous_action)).AlwaysDo(choose_continuous_action_fn);
   When(Method((*mock), request_decision)).AlwaysDo(request_decision_fn);
   When(Method((*mock), request_multi_slot_decision)).AlwaysDo(request_multi_slot_decision_fn);
   When(Method((*mock), choose_rank_multistep)).AlwaysDo(choose_rank_multistep_fn);
+  When(Method((*mock), choose_rank_batch)).AlwaysDo(choose_rank_batch_fn);
+  When(Method((*mock), request_multi_slot_decision_batch)).AlwaysDo(request_multi_slot_decision_batch_fn);
   When(Method((*mock), model_type)).AlwaysDo(get_model_type);
 
   Fake(Dtor((*mock)));
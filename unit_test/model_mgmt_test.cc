@@ -13,11 +13,16 @@
 #include "err_constants.h"
 #include "factory_resolver.h"
 #include "model_mgmt/data_callback_fn.h"
+#include "model_mgmt/file_model_loader.h"
 #include "model_mgmt/model_downloader.h"
 #include "object_factory.h"
 #include "utility/periodic_background_proc.h"
 #include "utility/watchdog.h"
 
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
 #include <regex>
 #include <unordered_map>
 
@@ -163,6 +168,144 @@ BOOST_AUTO_TEST_CASE(mock_azure_storage_model_api_data)
 #  endif  // USE_AZURE_FACTORIES
 #endif    //_WIN32 (http_server http protocol issues in linux)
 
+#ifdef USE_AZURE_FACTORIES
+BOOST_AUTO_TEST_CASE(mock_azure_storage_conditional_get)
+{
+  const auto last_modified = ::utility::datetime::utc_now().to_string();
+  int gets = 0;
+  int heads = 0;
+  auto http_client = new mock_http_client("http://test.com");
+  http_client->set_responder(methods::HEAD, [&heads](const http_request& message, http_response& resp) {
+    ++heads;
+    resp.set_status_code(status_codes::OK);
+  });
+  http_client->set_responder(
+      methods::GET, [&gets, &last_modified](const http_request& message, http_response& resp) {
+        ++gets;
+        const auto etag = message.headers().find(header_names::if_none_match);
+        if (etag != message.headers().end() && etag->second == U("\"v1\""))
+        {
+          resp.set_status_code(status_codes::NotModified);
+          return;
+        }
+        resp.set_status_code(status_codes::OK);
+        resp.headers().add(U("Last-Modified"), last_modified);
+        resp.headers().add(header_names::etag, U("\"v1\""));
+        resp.set_body(U("Http GET response"));
+      });
+  std::unique_ptr<m::i_data_transport> data_transport(new m::restapi_data_transport(http_client, nullptr));
+
+  r::api_status status;
+  m::model_data md;
+  BOOST_CHECK_EQUAL(data_transport->get_data(md, &status), r::error_code::success);
+  BOOST_CHECK_EQUAL(md.refresh_count(), 1);
+  const auto* buffer = md.data();
+  const auto data_sz = md.data_sz();
+
+  // the unchanged model is not downloaded again and the previous data is left untouched
+  BOOST_CHECK_EQUAL(data_transport->get_data(md, &status), r::error_code::success);
+  BOOST_CHECK_EQUAL(md.refresh_count(), 1);
+  BOOST_CHECK(md.data() == buffer);
+  BOOST_CHECK_EQUAL(md.data_sz(), data_sz);
+
+  // one round trip per refresh
+  BOOST_CHECK_EQUAL(gets, 2);
+  BOOST_CHECK_EQUAL(heads, 0);
+}
+#endif  // USE_AZURE_FACTORIES
+
+namespace
+{
+void write_model_file(const std::string& file_name, const std::string& content)
+{
+  // models are written next to the watched file and renamed over it
+  const auto tmp_name = file_name + ".tmp";
+  {
+    std::ofstream out(tmp_name, std::ios::binary | std::ios::trunc);
+    out << content;
+  }
+  std::rename(tmp_name.c_str(), file_name.c_str());
+}
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(file_model_loader_mmap)
+{
+  const std::string file_name = "file_model_loader_mmap.model";
+  write_model_file(file_name, "model v1");
+
+  m::file_model_loader loader(file_name, true, nullptr, true);
+  BOOST_CHECK_EQUAL(loader.init(), r::error_code::success);
+
+  m::model_data md;
+  BOOST_CHECK_EQUAL(loader.get_data(md), r::error_code::success);
+  BOOST_CHECK_EQUAL(md.refresh_count(), 1);
+  BOOST_CHECK_EQUAL(std::string(md.data(), md.data_sz()), "model v1");
+
+  // copies share the mapping
+  const m::model_data copy(md);
+  BOOST_CHECK(copy.data() == md.data());
+
+  BOOST_CHECK_EQUAL(loader.get_data(md), r::error_code::success);
+  BOOST_CHECK_EQUAL(md.refresh_count(), 1);
+
+  // same size, possibly the same timestamp, but a different file
+  write_model_file(file_name, "model v2");
+  BOOST_CHECK_EQUAL(loader.get_data(md), r::error_code::success);
+  BOOST_CHECK_EQUAL(md.refresh_count(), 2);
+  BOOST_CHECK_EQUAL(std::string(md.data(), md.data_sz()), "model v2");
+  BOOST_CHECK_EQUAL(std::string(copy.data(), copy.data_sz()), "model v1");
+
+  std::remove(file_name.c_str());
+}
+
+#ifdef __linux__
+BOOST_AUTO_TEST_CASE(file_model_loader_watch)
+{
+  const std::string file_name = "file_model_loader_watch.model";
+  write_model_file(file_name, "model v1");
+
+  m::file_model_loader loader(file_name, true, nullptr, false, true);
+  BOOST_CHECK_EQUAL(loader.init(), r::error_code::success);
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  int changes = 0;
+  BOOST_CHECK(loader.set_model_changed_callback([&]() {
+    std::lock_guard<std::mutex> lock(mutex);
+    ++changes;
+    cv.notify_one();
+  }));
+
+  write_model_file(file_name, "model v2");
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    BOOST_CHECK(cv.wait_for(lock, std::chrono::seconds(5), [&changes] { return changes > 0; }));
+  }
+  loader.set_model_changed_callback(nullptr);
+
+  std::remove(file_name.c_str());
+}
+#endif
+
+BOOST_AUTO_TEST_CASE(model_data_alloc_reuses_buffer)
+{
+  m::model_data md;
+  auto* buffer = md.alloc(100);
+  BOOST_CHECK_EQUAL(md.capacity(), 100);
+
+  // smaller models are written in place
+  BOOST_CHECK(md.alloc(50) == buffer);
+  BOOST_CHECK_EQUAL(md.data_sz(), 50);
+  BOOST_CHECK_EQUAL(md.capacity(), 100);
+
+  md.alloc(200);
+  BOOST_CHECK_EQUAL(md.data_sz(), 200);
+  BOOST_CHECK_EQUAL(md.capacity(), 200);
+
+  md.free();
+  BOOST_CHECK_EQUAL(md.capacity(), 0);
+}
+
 void register_local_file_factory();
 const char* const DUMMY_DATA_TRANSPORT = "DUMMY_DATA_TRANSPORT";
 const char* const CFG_PARAM = "model.local.file";
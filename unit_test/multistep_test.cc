@@ -22,4 +22,71 @@ BOOST_AUTO_TEST_CASE(multistep_depth_is_added)
 
   const std::string second = history.get_context("0", context.c_str());
   BOOST_CHECK_EQUAL(R"({"episode":{"depth":"2"},"f":1})", second.c_str());
+
+  // no trailing comma when the context has no features
+  BOOST_CHECK_EQUAL(R"({"episode":{"depth":"2"}})", history.get_context("0", "{}"));
+  BOOST_CHECK_EQUAL(R"({"episode":{"depth":"2"}})", history.get_context("0", "{ }"));
+}
+
+BOOST_AUTO_TEST_CASE(multistep_context_buffer_is_reused)
+{
+  episode_history history;
+  ranking_response resp;
+  std::string buffer;
+
+  history.get_context(nullptr, R"({"f":1})", buffer);
+  BOOST_CHECK_EQUAL(R"({"episode":{"depth":"1"},"f":1})", buffer);
+  for (int i = 0; i < 12; ++i)
+  {
+    history.update(std::to_string(i).c_str(), i == 0 ? nullptr : std::to_string(i - 1).c_str(), "{}", resp);
+  }
+
+  history.get_context("11", R"({"g":2})", buffer);
+  BOOST_CHECK_EQUAL(R"({"episode":{"depth":"13"},"g":2})", buffer);
+  BOOST_CHECK_EQUAL(history.get_context("11", R"({"g":2})"), buffer);
+}
+
+BOOST_AUTO_TEST_CASE(multistep_long_episode)
+{
+  episode_history history;
+  ranking_response resp;
+
+  for (int i = 0; i < 10000; ++i)
+  {
+    history.update(std::to_string(i).c_str(), i == 0 ? nullptr : std::to_string(i - 1).c_str(), "{}", resp);
+  }
+  BOOST_CHECK_EQUAL(10000, history.size());
+  BOOST_CHECK_EQUAL(R"({"episode":{"depth":"10001"}})", history.get_context("9999", "{}"));
+  BOOST_CHECK_EQUAL(R"({"episode":{"depth":"5001"}})", history.get_context("4999", "{}"));
+  BOOST_CHECK_EQUAL(R"({"episode":{"depth":"1"}})", history.get_context("unknown", "{}"));
+}
+
+BOOST_AUTO_TEST_CASE(multistep_bounded_history)
+{
+  episode_state episode("episode", 100);
+  ranking_response resp;
+
+  for (int i = 0; i < 1000; ++i)
+  {
+    episode.update(std::to_string(i).c_str(), i == 0 ? nullptr : std::to_string(i - 1).c_str(), "{}", resp);
+  }
+  BOOST_CHECK_EQUAL(100, episode.size());
+  BOOST_CHECK_EQUAL(100, episode.get_history().size());
+  BOOST_CHECK_EQUAL(1000, episode.get_history().update_count());
+
+  // the depth keeps growing past the bound, only the oldest events are forgotten
+  BOOST_CHECK_EQUAL(R"({"episode":{"depth":"1001"}})", episode.get_history().get_context("999", "{}"));
+  BOOST_CHECK_EQUAL(R"({"episode":{"depth":"902"}})", episode.get_history().get_context("900", "{}"));
+  BOOST_CHECK_EQUAL(R"({"episode":{"depth":"1"}})", episode.get_history().get_context("899", "{}"));
+
+  // an id updated again is only dropped once its last update is old enough
+  episode_history history(2);
+  history.update("a", nullptr, "{}", resp);
+  history.update("a", "a", "{}", resp);
+  history.update("b", "a", "{}", resp);
+  BOOST_CHECK_EQUAL(2, history.size());
+  BOOST_CHECK_EQUAL(R"({"episode":{"depth":"3"}})", history.get_context("a", "{}"));
+  BOOST_CHECK_EQUAL(R"({"episode":{"depth":"4"}})", history.get_context("b", "{}"));
+  history.update("c", "b", "{}", resp);
+  BOOST_CHECK_EQUAL(R"({"episode":{"depth":"1"}})", history.get_context("a", "{}"));
 }
@@ -8,7 +8,10 @@
 #include "trace_logger.h"
 #include "utility/versioned_object_pool.h"
 
+#include <atomic>
+#include <functional>
 #include <string>
+#include <thread>
 
 using namespace reinforcement_learning;
 using namespace reinforcement_learning::utility;
@@ -190,4 +193,164 @@ BOOST_AUTO_TEST_CASE(object_pool_logging)
   pool.update_factory(new_factory);
   BOOST_TEST(logger.get_message().find("2") != std::string::npos);
   logger.reset();
-}
\ No newline at end of file
+}
+
+class counting_object
+{
+public:
+  static std::atomic<int> alive;
+  counting_object() { ++alive; }
+  ~counting_object() { --alive; }
+};
+std::atomic<int> counting_object::alive{0};
+
+BOOST_AUTO_TEST_CASE(object_pool_old_generation_drains)
+{
+  std::unique_ptr<counting_object, std::function<void(counting_object*)>> outliving;
+  {
+    versioned_object_pool<counting_object> pool([] { return new counting_object(); }, 2);
+    BOOST_CHECK_EQUAL(counting_object::alive, 2);
+
+    auto in_use = pool.get_or_create();
+    pool.update_factory([] { return new counting_object(); });
+    BOOST_CHECK_EQUAL(pool.version(), 1);
+    // the idle object of the old generation is freed, the one in use is kept alive
+    BOOST_CHECK_EQUAL(counting_object::alive, 3);
+
+    // returning an object of the old generation deletes it instead of pooling it
+    in_use.reset();
+    BOOST_CHECK_EQUAL(counting_object::alive, 2);
+
+    outliving = pool.get_or_create();
+  }
+  // an object may outlive the pool
+  BOOST_CHECK_EQUAL(counting_object::alive, 1);
+  outliving.reset();
+  BOOST_CHECK_EQUAL(counting_object::alive, 0);
+}
+
+BOOST_AUTO_TEST_CASE(object_pool_parallel_build)
+{
+  std::atomic<int> created{0};
+  auto factory = [&created] {
+    ++created;
+    return new my_object(0);
+  };
+  versioned_object_pool<my_object> pool(factory, 8, nullptr, 4);
+  BOOST_CHECK_EQUAL(created, 8);
+
+  // readers keep being served while a new generation is built
+  std::atomic<bool> done{false};
+  std::atomic<int> failures{0};
+  std::thread reader([&pool, &done, &failures] {
+    while (!done)
+    {
+      if (pool.get_or_create() == nullptr) { ++failures; }
+    }
+  });
+  pool.update_factory(factory);
+  done = true;
+  reader.join();
+  BOOST_CHECK_EQUAL(failures, 0);
+  BOOST_CHECK_EQUAL(pool.version(), 1);
+  BOOST_CHECK_GE(created, 16);
+}
+
+BOOST_AUTO_TEST_CASE(object_pool_pinned_per_thread)
+{
+  versioned_object_pool<my_object> pool(my_object_factory{});
+
+  my_object* pinned = nullptr;
+  {
+    auto obj = pool.get_pinned();
+    pinned = obj.get();
+    // a nested call on the same thread does not get the pinned object
+    auto nested = pool.get_pinned();
+    BOOST_CHECK_NE(nested.get(), pinned);
+  }
+  {
+    auto obj = pool.get_pinned();
+    BOOST_CHECK_EQUAL(obj.get(), pinned);
+  }
+
+  // another thread gets its own object
+  my_object* other = nullptr;
+  std::thread([&pool, &other] { other = pool.get_pinned().get(); }).join();
+  BOOST_CHECK_NE(other, pinned);
+
+  // the pinned object is replaced by one of the new generation
+  pool.update_factory(my_object_factory{});
+  {
+    auto obj = pool.get_pinned();
+    BOOST_CHECK_NE(obj.get(), nullptr);
+  }
+
+  auto stats = pool.stats();
+  BOOST_CHECK_EQUAL(stats.pinned_hits, 1);
+  BOOST_CHECK_EQUAL(stats.pinned_refreshes, 1);
+  // first pin, nested fallback, other thread and refresh
+  BOOST_CHECK_EQUAL(stats.acquired, 4);
+  // the other thread reuses the object returned by the nested call, the new generation is pre-populated
+  BOOST_CHECK_EQUAL(stats.created, 2);
+}
+
+BOOST_AUTO_TEST_CASE(object_pool_pinned_released_on_thread_exit)
+{
+  BOOST_CHECK_EQUAL(counting_object::alive, 0);
+  {
+    versioned_object_pool<counting_object> pool([] { return new counting_object(); });
+    std::thread([&pool] { pool.get_pinned(); }).join();
+    // the object pinned by the exited thread went back to the pool
+    BOOST_CHECK_EQUAL(counting_object::alive, 1);
+    auto obj = pool.get_or_create();
+    BOOST_CHECK_EQUAL(pool.stats().created, 1);
+  }
+  BOOST_CHECK_EQUAL(counting_object::alive, 0);
+}
+
+BOOST_AUTO_TEST_CASE(object_pool_pinned_released_after_pool_destroyed)
+{
+  BOOST_CHECK_EQUAL(counting_object::alive, 0);
+  int alive_after_destroy = 0;
+  int alive_after_next_pin = 0;
+  object_pool_stats stats;
+  // on its own thread, so that nothing stays pinned to the test thread
+  std::thread([&] {
+    {
+      versioned_object_pool<counting_object> pool([] { return new counting_object(); });
+      pool.get_pinned();
+    }
+    // still pinned by this thread, which has not called get_pinned() since
+    alive_after_destroy = counting_object::alive;
+
+    // another pool, possibly at the same address, neither reuses nor keeps the object of the destroyed one
+    versioned_object_pool<counting_object> pool([] { return new counting_object(); });
+    pool.get_pinned();
+    alive_after_next_pin = counting_object::alive;
+    stats = pool.stats();
+  }).join();
+
+  BOOST_CHECK_EQUAL(alive_after_destroy, 1);
+  BOOST_CHECK_EQUAL(alive_after_next_pin, 1);
+  BOOST_CHECK_EQUAL(stats.created, 1);
+  BOOST_CHECK_EQUAL(stats.pinned_refreshes, 0);
+  BOOST_CHECK_EQUAL(counting_object::alive, 0);
+}
+
+BOOST_AUTO_TEST_CASE(object_pool_update_with_seed)
+{
+  std::atomic<int> created{0};
+  auto factory = [&created] {
+    ++created;
+    return new my_object(0);
+  };
+  versioned_object_pool<my_object> pool(factory, 4);
+  BOOST_CHECK_EQUAL(created, 4);
+
+  // the seed takes the place of one of the objects of the new generation
+  std::unique_ptr<my_object> seed(new my_object(42));
+  pool.update_factory(factory, std::move(seed));
+  BOOST_CHECK_EQUAL(created, 7);
+  auto obj = pool.get_or_create();
+  BOOST_CHECK_EQUAL(obj->_id, 42);
+}
@@ -61,6 +61,43 @@ BOOST_AUTO_TEST_CASE(cb_payload_serializer_test)
   BOOST_CHECK_EQUAL(true, event->deferred_action());
 }
 
+BOOST_AUTO_TEST_CASE(cb_payload_serializer_from_ranking_test)
+{
+  cb_serializer serializer;
+  ranking_response rr("event_id");
+  rr.set_model_id("model_id");
+  rr.push_back(1, 0.2f);
+  rr.push_back(0, 0.8f);
+
+  std::vector<uint64_t> action_ids;
+  std::vector<float> probs;
+  std::vector<action_prob> ranking;
+  for (auto const& r : rr)
+  {
+    action_ids.push_back(r.action_id + 1);
+    probs.push_back(r.probability);
+    ranking.push_back(r);
+  }
+
+  const auto expected = serializer.event(
+      "my_context", action_flags::DEFERRED, v2::LearningModeType_Apprentice, action_ids, probs, rr.get_model_id());
+  const auto buffer = serializer.event(
+      "my_context", action_flags::DEFERRED, v2::LearningModeType_Apprentice, ranking, rr.get_model_id());
+
+  // both overloads build the same bytes
+  BOOST_CHECK_EQUAL_COLLECTIONS(buffer.data(), buffer.data() + buffer.size(), expected.data(),
+      expected.data() + expected.size());
+
+  const auto event = v2::GetCbEvent(buffer.data());
+  const auto& actions = *event->action_ids();
+  BOOST_CHECK_EQUAL(2, actions[0]);
+  BOOST_CHECK_EQUAL(1, actions[1]);
+  const auto& probabilities = *event->probabilities();
+  BOOST_CHECK_CLOSE(0.2, probabilities[0], tolerance);
+  BOOST_CHECK_CLOSE(0.8, probabilities[1], tolerance);
+  BOOST_CHECK_EQUAL("model_id", event->model_id()->c_str());
+}
+
 BOOST_AUTO_TEST_CASE(ca_payload_serializer_test)
 {
   ca_serializer serializer;
@@ -45,3 +45,21 @@ BOOST_AUTO_TEST_CASE(simple_preamble_usage)
   BOOST_CHECK_EQUAL(pre.msg_size, send_msg_sz);
   BOOST_CHECK_EQUAL(pre.msg_type, send_msg_type);
 }
+
+BOOST_AUTO_TEST_CASE(preamble_content_encoding)
+{
+  std::shared_ptr<data_buffer> db(new data_buffer());
+  dummy_sender* raw_data = new dummy_sender();
+  preamble_message_sender f_sender(raw_data);
+  db->set_body_endoffset(db->preamble_size() + db->body_capacity());
+  db->set_content_encoding(preamble_content_encoding::ZSTD);
+
+  f_sender.send(message_type::fb_generic_event_collection, db);
+  preamble pre;
+  pre.read_from_bytes(raw_data->v_data->preamble_begin(), raw_data->v_data->preamble_size());
+  BOOST_CHECK(pre.content_encoding == preamble_content_encoding::ZSTD);
+
+  // pooled buffers are reset before being reused
+  db->reset();
+  BOOST_CHECK(db->content_encoding() == preamble_content_encoding::IDENTITY);
+}
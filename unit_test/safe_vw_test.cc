@@ -6,9 +6,17 @@
 #include "vw_model/safe_vw.h"
 #include <boost/test/unit_test.hpp>
 
+#include "configuration.h"
+#include "constants.h"
 #include "data.h"
+#include "err_constants.h"
 #include "model_mgmt.h"
 #include "utility/versioned_object_pool.h"
+#include "vw_model/pdf_model.h"
+#include "vw_model/vw_model.h"
+
+#include <atomic>
+#include <thread>
 
 using namespace reinforcement_learning;
 using namespace reinforcement_learning::utility;
@@ -33,6 +41,78 @@ BOOST_AUTO_TEST_CASE(safe_vw_1)
   BOOST_CHECK_EQUAL_COLLECTIONS(ranking.begin(), ranking.end(), ranking_expected.begin(), ranking_expected.end());
 }
 
+BOOST_AUTO_TEST_CASE(safe_vw_rank_with_context_buffer)
+{
+  safe_vw vw((const char*)cb_data_5_model, cb_data_5_model_len);
+  const std::string json = R"({"a":{"0":1,"5":2},"_multi":[{"b":{"0":1}},{"b":{"0":2}},{"b":{"0":3}}]})";
+  const std::string short_json = R"({"a":{"0":1},"_multi":[{"b":{"0":1}},{"b":{"0":2}}]})";
+  std::vector<float> ranking_expected = {.8f, .1f, .1f};
+
+  std::vector<int> actions;
+  std::vector<float> ranking;
+  vw.rank_with_context_buffer(json, actions, ranking);
+  BOOST_CHECK_EQUAL_COLLECTIONS(ranking.begin(), ranking.end(), ranking_expected.begin(), ranking_expected.end());
+
+  // a shorter context must not pick up leftovers of the previous one
+  std::vector<int> short_actions;
+  std::vector<float> short_ranking;
+  vw.rank(short_json, short_actions, short_ranking);
+  vw.rank_with_context_buffer(short_json, actions, ranking);
+  BOOST_CHECK_EQUAL_COLLECTIONS(ranking.begin(), ranking.end(), short_ranking.begin(), short_ranking.end());
+
+  vw.rank_with_context_buffer(json, actions, ranking);
+  BOOST_CHECK_EQUAL_COLLECTIONS(ranking.begin(), ranking.end(), ranking_expected.begin(), ranking_expected.end());
+
+  // caller owned buffer parsed in place
+  std::vector<char> buffer(json.begin(), json.end());
+  buffer.push_back('\0');
+  vw.rank(buffer.data(), json.size(), actions, ranking);
+  BOOST_CHECK_EQUAL_COLLECTIONS(ranking.begin(), ranking.end(), ranking_expected.begin(), ranking_expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(safe_vw_rank_registered)
+{
+  safe_vw vw((const char*)cb_data_5_model, cb_data_5_model_len);
+  const std::string b1 = R"({"b":{"0":1}})";
+  const std::string b2 = R"({"b":{"0":2}})";
+  const std::string b3 = R"({"b":{"0":3}})";
+  const std::vector<model_management::registered_action> registered = {{1, b1}, {2, b2}, {3, b3}};
+  std::vector<float> ranking_expected = {.8f, .1f, .1f};
+
+  std::vector<int> actions;
+  std::vector<float> ranking;
+  vw.rank_registered(R"({"a":{"0":1,"5":2},"_multi":[]})", registered, 0, actions, ranking);
+  BOOST_CHECK_EQUAL_COLLECTIONS(ranking.begin(), ranking.end(), ranking_expected.begin(), ranking_expected.end());
+
+  // the parsed actions are reused and can be requested in any order
+  std::vector<int> expected_actions;
+  std::vector<float> expected_ranking;
+  vw.rank(R"({"a":{"0":1},"_multi":[{"b":{"0":3}},{"b":{"0":1}}]})", expected_actions, expected_ranking);
+  vw.rank_registered(R"({"a":{"0":1},"_multi":[]})", {registered[2], registered[0]}, 0, actions, ranking);
+  BOOST_CHECK_EQUAL_COLLECTIONS(actions.begin(), actions.end(), expected_actions.begin(), expected_actions.end());
+  BOOST_CHECK_EQUAL_COLLECTIONS(ranking.begin(), ranking.end(), expected_ranking.begin(), expected_ranking.end());
+}
+
+BOOST_AUTO_TEST_CASE(safe_vw_rank_registered_new_generation)
+{
+  safe_vw vw((const char*)cb_data_5_model, cb_data_5_model_len);
+  const std::string b1 = R"({"b":{"0":1}})";
+  const std::string b2 = R"({"b":{"0":2}})";
+  const std::string b3 = R"({"b":{"0":3}})";
+
+  std::vector<int> actions;
+  std::vector<float> ranking;
+  vw.rank_registered(R"({"a":{"0":1},"_multi":[]})", {{1, b1}, {2, b2}}, 0, actions, ranking);
+
+  // id 1 was unregistered and now stands for other features, the cached action must not be used
+  std::vector<int> expected_actions;
+  std::vector<float> expected_ranking;
+  vw.rank(R"({"a":{"0":1},"_multi":[{"b":{"0":3}},{"b":{"0":2}}]})", expected_actions, expected_ranking);
+  vw.rank_registered(R"({"a":{"0":1},"_multi":[]})", {{1, b3}, {2, b2}}, 1, actions, ranking);
+  BOOST_CHECK_EQUAL_COLLECTIONS(actions.begin(), actions.end(), expected_actions.begin(), expected_actions.end());
+  BOOST_CHECK_EQUAL_COLLECTIONS(ranking.begin(), ranking.end(), expected_ranking.begin(), expected_ranking.end());
+}
+
 BOOST_AUTO_TEST_CASE(safe_vw_audit_logs)
 {
   safe_vw vw((const char*)cb_data_5_model, cb_data_5_model_len, "--json --quiet");
@@ -159,3 +239,108 @@ BOOST_AUTO_TEST_CASE(factory_with_empty_model)
     BOOST_CHECK_EQUAL_COLLECTIONS(ranking.begin(), ranking.end(), ranking_expected.begin(), ranking_expected.end());
   }
 }
+
+BOOST_AUTO_TEST_CASE(factory_with_shared_weights)
+{
+  const auto json = R"({"a":{"0":1,"5":2},"_multi":[{"b":{"0":1}},{"b":{"0":2}},{"b":{"0":3}}]})";
+  std::vector<float> ranking_expected = {.8f, .1f, .1f};
+
+  auto master = std::make_shared<safe_vw>((const char*)cb_data_5_model, cb_data_5_model_len);
+  versioned_object_pool<safe_vw> pool(safe_vw_factory(master), 2);
+
+  {
+    // Both objects read the weights of the master
+    auto vw1 = pool.get_or_create();
+    auto vw2 = pool.get_or_create();
+    BOOST_CHECK_NE(vw1.get(), vw2.get());
+    BOOST_CHECK_EQUAL(std::string(master->id()), std::string(vw1->id()));
+
+    std::vector<int> actions;
+    std::vector<float> ranking;
+    vw1->rank(json, actions, ranking);
+    BOOST_CHECK_EQUAL_COLLECTIONS(ranking.begin(), ranking.end(), ranking_expected.begin(), ranking_expected.end());
+
+    vw2->rank(json, actions, ranking);
+    BOOST_CHECK_EQUAL_COLLECTIONS(ranking.begin(), ranking.end(), ranking_expected.begin(), ranking_expected.end());
+  }
+
+  // The master is kept alive by the pool once the caller lets it go
+  master.reset();
+  {
+    auto vw = pool.get_or_create();
+
+    std::vector<int> actions;
+    std::vector<float> ranking;
+    vw->rank(json, actions, ranking);
+    BOOST_CHECK_EQUAL_COLLECTIONS(ranking.begin(), ranking.end(), ranking_expected.begin(), ranking_expected.end());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(vw_model_update_seeds_pool_with_validated_instance)
+{
+  const auto json = R"({"a":{"0":1,"5":2},"_multi":[{"b":{"0":1}},{"b":{"0":2}},{"b":{"0":3}}]})";
+  model_management::model_data model_data;
+  get_model_data_from_raw((const char*)cb_data_5_model, cb_data_5_model_len, &model_data);
+
+  for (const auto* share_weights : {"false", "true"})
+  {
+    configuration config;
+    config.set(name::VW_POOL_SHARE_WEIGHTS, share_weights);
+    config.set(name::VW_POOL_BUILD_THREADS, "0");
+    model_management::vw_model model(nullptr, config);
+
+    bool model_ready = false;
+    BOOST_CHECK_EQUAL(model.update(model_data, model_ready), error_code::success);
+    BOOST_CHECK(model_ready);
+
+    const auto load_stats = model.last_load_stats();
+    BOOST_CHECK_GT(load_stats.deserialize_us + load_stats.pool_build_us, 0);
+    BOOST_CHECK_GE(load_stats.total_us, load_stats.pool_build_us);
+
+    std::vector<int> actions;
+    std::vector<float> ranking;
+    std::string model_version;
+    BOOST_CHECK_EQUAL(model.choose_rank("event_id", 0, json, actions, ranking, model_version), error_code::success);
+    std::vector<float> ranking_expected = {.8f, .1f, .1f};
+    BOOST_CHECK_EQUAL_COLLECTIONS(ranking.begin(), ranking.end(), ranking_expected.begin(), ranking_expected.end());
+
+    // the pre-warmed pool serves the first requests without creating objects
+    BOOST_CHECK_EQUAL(model.pool_stats().created, 0);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(pdf_model_concurrent_choose_rank)
+{
+  const auto json = R"({"Shared":{"t":"abc"}, "_multi":[{"Action":{"c":1}},{"Action":{"c":2}}],"p":[0.4, 0.6]})";
+
+  for (const auto* parser : {"json", "vw", "vw_pinned"})
+  {
+    const bool use_vw_parser = std::string(parser) != "json";
+    configuration config;
+    config.set(name::MODEL_PASSTHROUGH_PDF_VW_PARSER, use_vw_parser ? "true" : "false");
+    config.set(name::VW_POOL_PIN_PER_THREAD, std::string(parser) == "vw_pinned" ? "true" : "false");
+    model_management::pdf_model model(nullptr, config);
+
+    std::atomic<int> failures{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t)
+    {
+      threads.emplace_back([&]() {
+        std::vector<int> actions;
+        std::vector<float> pdf;
+        std::string model_version;
+        for (int i = 0; i < 200; ++i)
+        {
+          if (model.choose_rank("event_id", 0, json, actions, pdf, model_version) != error_code::success ||
+              pdf.size() != 2 || pdf[0] != 0.4f || pdf[1] != 0.6f)
+          { ++failures; }
+        }
+      });
+    }
+    for (auto& thread : threads) { thread.join(); }
+
+    BOOST_CHECK_EQUAL(failures.load(), 0);
+    // the json extractor never touches the VW pool
+    BOOST_CHECK_EQUAL(model.pool_stats().acquired > 0, use_vw_parser);
+  }
+}
@@ -40,4 +40,24 @@ BOOST_AUTO_TEST_CASE(sleeper_sleep)
     BOOST_CHECK(diff >= std::chrono::milliseconds(80));
   });
   t.join();
-}
\ No newline at end of file
+}
+
+BOOST_AUTO_TEST_CASE(sleeper_wake)
+{
+  u::interruptable_sleeper sleeper;
+  std::thread t([&]() {
+    // a woken sleep ends early but is not an interruption
+    const auto start = std::chrono::system_clock::now();
+    BOOST_CHECK(sleeper.sleep(std::chrono::milliseconds(5000)));
+    const auto stop = std::chrono::system_clock::now();
+    BOOST_CHECK(std::chrono::duration_cast<std::chrono::milliseconds>(stop - start) <= std::chrono::milliseconds(100));
+
+    // the wake is consumed, the next sleep runs to its timeout
+    BOOST_CHECK(sleeper.sleep(std::chrono::milliseconds(20)));
+  });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+  sleeper.wake();
+  t.join();
+}
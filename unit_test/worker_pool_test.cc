@@ -0,0 +1,71 @@
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#  define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include "utility/worker_pool.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace u = reinforcement_learning::utility;
+
+BOOST_AUTO_TEST_CASE(worker_pool_runs_every_chunk_once)
+{
+  for (size_t threads : {1, 2, 3, 8})
+  {
+    u::worker_pool pool(threads);
+    BOOST_CHECK_EQUAL(threads, pool.size());
+    // the same workers take every run
+    for (size_t chunks = 0; chunks < 20; ++chunks)
+    {
+      std::vector<int> runs(chunks, 0);
+      std::vector<std::thread::id> ids(chunks);
+      pool.run(chunks, [&](size_t c) {
+        ++runs[c];
+        ids[c] = std::this_thread::get_id();
+      });
+      for (size_t c = 0; c < chunks; ++c)
+      {
+        BOOST_CHECK_EQUAL(1, runs[c]);
+        // the caller takes the first chunk
+        if (c % threads == 0) { BOOST_CHECK(ids[c] == std::this_thread::get_id()); }
+        else { BOOST_CHECK(ids[c] != std::this_thread::get_id()); }
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(worker_pool_rethrows_chunk_exception)
+{
+  u::worker_pool pool(4);
+  auto fail_third = [](size_t c) {
+    if (c == 2) { throw std::runtime_error("chunk failed"); }
+  };
+  BOOST_CHECK_THROW(pool.run(4, fail_third), std::runtime_error);
+
+  // the pool is still usable after a failed run
+  std::atomic<int> runs{0};
+  pool.run(4, [&](size_t) { ++runs; });
+  BOOST_CHECK_EQUAL(4, runs.load());
+}
+
+BOOST_AUTO_TEST_CASE(worker_pool_concurrent_runs)
+{
+  u::worker_pool pool(3);
+  const int callers = 4;
+  const int runs_per_caller = 200;
+  std::atomic<int> chunks_run{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < callers; ++t)
+  {
+    threads.emplace_back([&] {
+      for (int i = 0; i < runs_per_caller; ++i) { pool.run(5, [&](size_t) { ++chunks_run; }); }
+    });
+  }
+  for (auto& t : threads) { t.join(); }
+  BOOST_CHECK_EQUAL(callers * runs_per_caller * 5, chunks_run.load());
+}